@@ -5,6 +5,26 @@
 #include "../BidirectionalMap/BidirectionalMap.h"
 #include "CompareMapBidirectionalMapAccess.h"
 #include "BidirectionalMapGeneration.h"
+#include "MeasureChangeKey.h"
+#include "MeasureCopy.h"
+#include "MeasureCuckoo.h"
+#include "MeasureEmplace.h"
+#include "MeasureEraseIf.h"
+#include "MeasureExpiry.h"
+#include "MeasureFilter.h"
+#include "MeasureHashers.h"
+#include "MeasureInsertOrAssign.h"
+#include "MeasureInsertRange.h"
+#include "MeasureJournal.h"
+#include "MeasureLazySecondIndex.h"
+#include "MeasureLoadDelimited.h"
+#include "MeasureLruCache.h"
+#include "MeasureMultiMap.h"
+#include "MeasureOrderStatistics.h"
+#include "MeasurePrehashedKey.h"
+#include "MeasureRadixTree.h"
+#include "MeasureRangeScan.h"
+#include "MeasureRemap.h"
 #include <map>
 #include <unordered_map>
 
@@ -23,6 +43,72 @@ int main()
 
 	//MeasureGeneration(strings);
 
+	//std::cout << std::endl << "BidirectionalMap copy" << std::endl;
+	//MeasureCopy<BidirectionalMap>(1000000);
+	//MeasureCopy<BidirectionalMap>(10000000);
+	//std::cout << std::endl << "BidirectionalUnorderedMap copy" << std::endl;
+	//MeasureCopy<BidirectionalUnorderedMap>(1000000);
+	//MeasureCopy<BidirectionalUnorderedMap>(10000000);
+
+	//std::cout << std::endl << "BidirectionalUnorderedMap journal" << std::endl;
+	//MeasureJournal<BidirectionalUnorderedMap>(1000000);
+
+	//std::cout << std::endl << "BidirectionalUnorderedMap load delimited file" << std::endl;
+	//MeasureLoadDelimited<BidirectionalUnorderedMap>(10000000);
+
+	//std::cout << std::endl << "BidirectionalMap range scan" << std::endl;
+	//MeasureRangeScan(1000000, 100000, 100);
+
+	//std::cout << std::endl << "BidirectionalMap order statistics" << std::endl;
+	//MeasureOrderStatistics<BidirectionalMap>(1000000, 100);
+	//std::cout << std::endl << "BidirectionalRankedMap order statistics" << std::endl;
+	//MeasureOrderStatistics<BidirectionalRankedMap>(1000000, 100);
+
+	//std::cout << std::endl << "BidirectionalUnorderedMap key change" << std::endl;
+	//MeasureChangeKey<BidirectionalUnorderedMap>(100000, 10);
+
+	//std::cout << std::endl << "BidirectionalUnorderedMap emplace" << std::endl;
+	//MeasureEmplace<BidirectionalUnorderedMap>(1000000, 1024);
+
+	//std::cout << std::endl << "BidirectionalUnorderedMap insert or assign" << std::endl;
+	//MeasureInsertOrAssign<BidirectionalUnorderedMap>(100000, 10);
+
+	//std::cout << std::endl << "BidirectionalUnorderedMap remap" << std::endl;
+	//MeasureRemap<BidirectionalUnorderedMap>(1000000);
+
+	//std::cout << std::endl << "BidirectionalMap expiry" << std::endl;
+	//MeasureEraseIf<BidirectionalMap>(1000000, 30);
+
+	//std::cout << std::endl << "BidirectionalUnorderedMap insert range" << std::endl;
+	//MeasureInsertRange<BidirectionalUnorderedMap>(100000, 1000000);
+
+	//std::cout << std::endl << "BidirectionalLruCache vs. external LRU list" << std::endl;
+	//MeasureLruCache(100000, 1000000, 2000000);
+
+	//std::cout << std::endl << "BidirectionalExpiringMap vs. periodic scan" << std::endl;
+	//MeasureExpiry(1000000, 10000);
+
+	//std::cout << std::endl << "BidirectionalMultiMap vs. two std::unordered_multimap" << std::endl;
+	//MeasureMultiMap(100000, 1000, 10);
+
+	//std::cout << std::endl << "BidirectionalUnorderedMap with and without the index of second keys" << std::endl;
+	//MeasureLazySecondIndex<BidirectionalUnorderedMap>(1000000, 10000000);
+
+	//std::cout << std::endl << "FilteredIndex vs. HashedIndex" << std::endl;
+	//MeasureFilter(5000000, 10000000, 90);
+
+	//std::cout << std::endl << "PrehashedKey vs. hashing in every map" << std::endl;
+	//MeasurePrehashedKey(100000, 4, 1000000);
+
+	//std::cout << std::endl << "Bundled hashers vs. std::hash" << std::endl;
+	//MeasureHashers(1000000);
+
+	//std::cout << std::endl << "RadixTreeIndex vs. OrderedIndex" << std::endl;
+	//MeasureRadixTree(1000000, 5000000, 100000);
+
+	//std::cout << std::endl << "CuckooIndex vs. HashedIndex" << std::endl;
+	//MeasureCuckoo(1000000, 20000);
+
 	//std::cout << std::endl << "FINISHED" << std::endl;
 	//char ch;
 	//std::cin >> ch;
@@ -0,0 +1,52 @@
+#pragma once
+#include "../BidirectionalMap/BidirectionalMap.h"
+#include "CompareMapBidirectionalMapAccess.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// compare rotation of second keys with ChangeSecond, which reuses index nodes, to removing and reinserting keypairs
+template<template<typename... Args> class TBiMap>
+void MeasureChangeKey(size_t numOfItems, size_t numOfRotations)
+{
+	std::chrono::high_resolution_clock clock;
+
+	std::cout << "*** " << numOfRotations << " rotations of " << numOfItems << " string-int pairs ***" << std::endl;
+
+	TBiMap<std::string, unsigned long long> biMap;
+	std::vector<std::string> users;
+	for (size_t i = 0; i < numOfItems; ++i)
+	{
+		users.push_back("user" + std::to_string(i * 7919));
+		biMap.Insert(users.back(), i);
+	}
+
+	unsigned long long session = numOfItems;
+	auto now1 = clock.now();
+
+	// evaluate ChangeSecond
+	for (size_t rotation = 0; rotation < numOfRotations; ++rotation)
+	{
+		for (size_t i = 0; i < numOfItems; ++i)
+			biMap.ChangeSecond(users[i], session++);
+	}
+
+	auto now2 = clock.now();
+	OutputDuration("ChangeSecond                              ", now1, now2);
+
+	now1 = clock.now();
+
+	// evaluate RemoveFirst followed by Insert
+	for (size_t rotation = 0; rotation < numOfRotations; ++rotation)
+	{
+		for (size_t i = 0; i < numOfItems; ++i)
+		{
+			biMap.RemoveFirst(users[i]);
+			biMap.Insert(users[i], session++);
+		}
+	}
+
+	now2 = clock.now();
+	OutputDuration("RemoveFirst and Insert                    ", now1, now2);
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "../BidirectionalMap/BidirectionalMap.h"
+#include "CompareMapBidirectionalMapAccess.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// compare copy construction of a bidirectional map to rebuilding it from its pairs
+template<template<typename... Args> class TBiMap>
+void MeasureCopy(size_t numOfItems)
+{
+	std::chrono::high_resolution_clock clock;
+
+	std::cout << "*** copy " << numOfItems << " int-string pairs ***" << std::endl;
+
+	TBiMap<int, std::string> biMap;
+	for (size_t i = 0; i < numOfItems; ++i)
+		biMap.Insert(int(i), "key" + std::to_string(i * 7919));
+
+	auto now1 = clock.now();
+
+	// evaluate rebuilding of bidirectional map by inserting every keypair
+	TBiMap<int, std::string> rebuiltBiMap;
+	for (size_t i = 0; i < numOfItems; ++i)
+		rebuiltBiMap.Insert(int(i), biMap.AtFirst(int(i)));
+
+	auto now2 = clock.now();
+	OutputDuration("Rebuild bidirectional map                 ", now1, now2);
+
+	now1 = clock.now();
+
+	// evaluate bidirectional map copy constructor
+	TBiMap<int, std::string> copiedBiMap(biMap);
+
+	now2 = clock.now();
+	OutputDuration("Copy bidirectional map                    ", now1, now2);
+
+	assert(copiedBiMap.Size() == rebuiltBiMap.Size());
+}
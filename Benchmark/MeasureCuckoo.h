@@ -0,0 +1,78 @@
+#pragma once
+#include "../BidirectionalMap/BidirectionalMap.h"
+#include "CompareMapBidirectionalMapAccess.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// load the keys as first keys of a map with given index of first keys, then time each lookup of the keys
+// separately and output the total time, the median, the 99.99th percentile and the longest lookup
+template<typename TIndex>
+void MeasureLookupLatency(const std::string& name, const std::vector<unsigned long long>& keys)
+{
+	std::chrono::high_resolution_clock clock;
+
+	auto now1 = clock.now();
+
+	MapSpecial::BidirectionalIndexedMap<unsigned long long, size_t, TIndex, MapSpecial::HashedIndex<size_t>> biMap;
+	for (size_t i = 0; i < keys.size(); ++i)
+		biMap.Insert(keys[i], i);
+
+	auto now2 = clock.now();
+	OutputDuration(name + " load                     ", now1, now2);
+
+	size_t found = 0;
+	std::vector<long long> latencies;
+	latencies.reserve(keys.size());
+	now1 = clock.now();
+
+	for (size_t i = 0; i < keys.size(); ++i)
+	{
+		auto start = clock.now();
+		found += biMap.AtFirst(keys[i * 7919 % keys.size()]);
+		auto end = clock.now();
+		latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+	}
+
+	now2 = clock.now();
+	OutputDuration(name + " lookups                  ", now1, now2);
+
+	std::sort(latencies.begin(), latencies.end());
+	std::cout << "  lookup latency median " << latencies[latencies.size() / 2] << " ns, 99.99th percentile "
+		<< latencies[latencies.size() * 9999 / 10000] << " ns, longest " << latencies.back() << " ns (checksum " << found << ")" << std::endl;
+}
+
+// compare HashedIndex to CuckooIndex on random keys and on keys that all fall into one bucket of the hashed
+// index, which are multiples of the number of buckets it has after loading them
+inline void MeasureCuckoo(size_t numOfItems, size_t numOfAdversarialItems)
+{
+	std::vector<unsigned long long> keys;
+	keys.reserve(numOfItems);
+	unsigned long long state = 88172645463325252ull;
+	for (size_t i = 0; i < numOfItems; ++i)
+	{
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		keys.push_back(state);
+	}
+
+	std::cout << "*** " << numOfItems << " random keys ***" << std::endl;
+	MeasureLookupLatency<MapSpecial::HashedIndex<unsigned long long>>("HashedIndex", keys);
+	MeasureLookupLatency<MapSpecial::CuckooIndex<unsigned long long>>("CuckooIndex", keys);
+
+	std::unordered_map<unsigned long long, size_t> probe;
+	for (size_t i = 0; i < numOfAdversarialItems; ++i)
+		probe.emplace(i, i);
+	std::vector<unsigned long long> adversarialKeys;
+	adversarialKeys.reserve(numOfAdversarialItems);
+	for (size_t i = 0; i < numOfAdversarialItems; ++i)
+		adversarialKeys.push_back(i * probe.bucket_count());
+
+	std::cout << "*** " << numOfAdversarialItems << " keys in one bucket of std::unordered_map ***" << std::endl;
+	MeasureLookupLatency<MapSpecial::HashedIndex<unsigned long long>>("HashedIndex", adversarialKeys);
+	MeasureLookupLatency<MapSpecial::CuckooIndex<unsigned long long>>("CuckooIndex", adversarialKeys);
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "../BidirectionalMap/BidirectionalMap.h"
+#include "CompareMapBidirectionalMapAccess.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// compare insertion of heavy string keys passed as lvalues, moved into the map, or constructed in place
+template<template<typename... Args> class TBiMap>
+void MeasureEmplace(size_t numOfItems, size_t keyLength)
+{
+	std::chrono::high_resolution_clock clock;
+
+	std::cout << "*** insert " << numOfItems << " pairs of " << keyLength << "-character strings ***" << std::endl;
+
+	auto makeKey = [keyLength](char prefix, size_t i)
+	{
+		std::string key = prefix + std::to_string(i);
+		key.resize(keyLength, '.');
+		return key;
+	};
+	std::vector<std::string> firstKeys;
+	std::vector<std::string> secondKeys;
+	for (size_t i = 0; i < numOfItems; ++i)
+	{
+		firstKeys.push_back(makeKey('a', i));
+		secondKeys.push_back(makeKey('b', i));
+	}
+
+	auto now1 = clock.now();
+
+	// evaluate insertion of lvalues, which have to be copied
+	{
+		TBiMap<std::string, std::string> biMap;
+		for (size_t i = 0; i < numOfItems; ++i)
+			biMap.Insert(firstKeys[i], secondKeys[i]);
+	}
+
+	auto now2 = clock.now();
+	OutputDuration("Insert copies                             ", now1, now2);
+
+	std::vector<std::string> movedFirstKeys(firstKeys);
+	std::vector<std::string> movedSecondKeys(secondKeys);
+	now1 = clock.now();
+
+	// evaluate insertion of keys moved into the map
+	{
+		TBiMap<std::string, std::string> biMap;
+		for (size_t i = 0; i < numOfItems; ++i)
+			biMap.Insert(std::move(movedFirstKeys[i]), std::move(movedSecondKeys[i]));
+	}
+
+	now2 = clock.now();
+	OutputDuration("Insert moved keys                         ", now1, now2);
+
+	now1 = clock.now();
+
+	// evaluate construction of keys in place
+	{
+		TBiMap<std::string, std::string> biMap;
+		for (size_t i = 0; i < numOfItems; ++i)
+			biMap.Emplace(std::piecewise_construct, std::forward_as_tuple(firstKeys[i].data(), keyLength), std::forward_as_tuple(secondKeys[i].data(), keyLength));
+	}
+
+	now2 = clock.now();
+	OutputDuration("Emplace                                   ", now1, now2);
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "../BidirectionalMap/BidirectionalMap.h"
+#include "CompareMapBidirectionalMapAccess.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// compare expiry of every n-th keypair with EraseIf, with RemoveFirstRange and with collecting the keys and
+// calling RemoveFirst for each of them
+template<template<typename... Args> class TBiMap>
+void MeasureEraseIf(size_t numOfItems, size_t percentage)
+{
+	std::chrono::high_resolution_clock clock;
+
+	std::cout << "*** expiry of " << percentage << "% of " << numOfItems << " string-int pairs ***" << std::endl;
+
+	TBiMap<std::string, unsigned long long> biMap1;
+	for (size_t i = 0; i < numOfItems; ++i)
+		biMap1.Insert("user" + std::to_string(i * 7919), i);
+	TBiMap<std::string, unsigned long long> biMap2(biMap1);
+	TBiMap<std::string, unsigned long long> biMap3(biMap1);
+	auto isStale = [percentage](const std::pair<std::string, unsigned long long>& keyPair) { return keyPair.second % 100 < percentage; };
+
+	auto now1 = clock.now();
+
+	// evaluate EraseIf
+	size_t removed = biMap1.EraseIf(isStale);
+
+	auto now2 = clock.now();
+	OutputDuration("EraseIf                                   ", now1, now2);
+
+	now1 = clock.now();
+
+	// evaluate RemoveFirstRange
+	std::vector<std::string> stale;
+	for (const auto& keyPair : biMap2)
+	{
+		if (isStale(keyPair))
+			stale.push_back(keyPair.first);
+	}
+	removed += biMap2.RemoveFirstRange(stale);
+
+	now2 = clock.now();
+	OutputDuration("RemoveFirstRange                          ", now1, now2);
+
+	now1 = clock.now();
+
+	// evaluate RemoveFirst for every collected key
+	stale.clear();
+	for (const auto& keyPair : biMap3)
+	{
+		if (isStale(keyPair))
+			stale.push_back(keyPair.first);
+	}
+	for (const auto& key : stale)
+		biMap3.RemoveFirst(key);
+
+	now2 = clock.now();
+	OutputDuration("RemoveFirst                               ", now1, now2);
+
+	std::cout << "Removed: " << removed + stale.size() << ", remaining: " << biMap1.Size() << std::endl;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "../BidirectionalMap/BidirectionalExpiringMap.h"
+#include "CompareMapBidirectionalMapAccess.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// compare expiry with BidirectionalExpiringMap::Tick called every millisecond to scanning BidirectionalUnorderedMap
+// with deadlines in a separate map every 100 milliseconds; reports total time and the longest single call
+inline void MeasureExpiry(size_t numOfItems, int simulatedMilliseconds)
+{
+	using Clock = std::chrono::steady_clock;
+	std::chrono::high_resolution_clock clock;
+
+	std::cout << "*** expiry of " << numOfItems << " string-int pairs within " << simulatedMilliseconds << " ms ***" << std::endl;
+
+	std::default_random_engine random;
+	std::uniform_int_distribution<int> distribution(1, simulatedMilliseconds);
+	std::vector<std::string> tokens;
+	std::vector<int> timesToLive;
+	for (size_t i = 0; i < numOfItems; ++i)
+	{
+		tokens.push_back("token" + std::to_string(i * 7919));
+		timesToLive.push_back(distribution(random));
+	}
+	Clock::time_point start = Clock::now();
+
+	MapSpecial::BidirectionalExpiringMap<std::string, unsigned long long> expiringMap;
+	for (size_t i = 0; i < numOfItems; ++i)
+		expiringMap.Insert(tokens[i], i, start + std::chrono::milliseconds(timesToLive[i]));
+	size_t expired = 0;
+	auto longest = std::chrono::high_resolution_clock::duration::zero();
+	auto now1 = clock.now();
+
+	// evaluate Tick every millisecond
+	for (int ms = 1; ms <= simulatedMilliseconds; ++ms)
+	{
+		auto before = clock.now();
+		expired += expiringMap.Tick(start + std::chrono::milliseconds(ms));
+		longest = (std::max)(longest, clock.now() - before);
+	}
+
+	auto now2 = clock.now();
+	OutputDuration("Tick every millisecond                    ", now1, now2);
+	std::cout << "Longest Tick: " << std::chrono::duration_cast<std::chrono::microseconds>(longest).count() << " us" << std::endl;
+
+	MapSpecial::BidirectionalUnorderedMap<std::string, unsigned long long> biMap;
+	std::unordered_map<std::string, Clock::time_point> deadlines;
+	for (size_t i = 0; i < numOfItems; ++i)
+	{
+		biMap.Insert(tokens[i], i);
+		deadlines.emplace(tokens[i], start + std::chrono::milliseconds(timesToLive[i]));
+	}
+	longest = std::chrono::high_resolution_clock::duration::zero();
+	now1 = clock.now();
+
+	// evaluate scan of all keypairs every 100 milliseconds
+	std::vector<std::string> stale;
+	for (int ms = 100; ms <= simulatedMilliseconds; ms += 100)
+	{
+		auto before = clock.now();
+		Clock::time_point now = start + std::chrono::milliseconds(ms);
+		stale.clear();
+		for (const auto& deadline : deadlines)
+		{
+			if (deadline.second <= now)
+				stale.push_back(deadline.first);
+		}
+		for (const auto& token : stale)
+		{
+			biMap.RemoveFirst(token);
+			deadlines.erase(token);
+		}
+		expired += stale.size();
+		longest = (std::max)(longest, clock.now() - before);
+	}
+
+	now2 = clock.now();
+	OutputDuration("Scan every 100 milliseconds               ", now1, now2);
+	std::cout << "Longest scan: " << std::chrono::duration_cast<std::chrono::microseconds>(longest).count() << " us" << std::endl;
+	std::cout << "Expired: " << expired << std::endl;
+}
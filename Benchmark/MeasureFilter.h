@@ -0,0 +1,54 @@
+#pragma once
+#include "../BidirectionalMap/BidirectionalMap.h"
+#include "CompareMapBidirectionalMapAccess.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// compare SecondExists on a map with a plain hashed index of second keys and on a map with a filtered index,
+// for queries of which the given percentage misses
+inline void MeasureFilter(size_t numOfItems, size_t numOfQueries, size_t missPercentage)
+{
+	std::chrono::high_resolution_clock clock;
+
+	std::cout << "*** " << numOfQueries << " queries of " << numOfItems << " int-string pairs, " << missPercentage << "% missing ***" << std::endl;
+
+	MapSpecial::BidirectionalUnorderedMap<unsigned long long, std::string> biMap1;
+	MapSpecial::BidirectionalIndexedMap<unsigned long long, std::string, MapSpecial::HashedIndex<unsigned long long>, MapSpecial::FilteredIndex<std::string>> biMap2;
+	for (size_t i = 0; i < numOfItems; ++i)
+	{
+		biMap1.Insert(i, "document" + std::to_string(i * 7919));
+		biMap2.Insert(i, "document" + std::to_string(i * 7919));
+	}
+	std::vector<std::string> queries;
+	queries.reserve(numOfQueries);
+	for (size_t i = 0; i < numOfQueries; ++i)
+	{
+		size_t key = (i * 104729) % numOfItems;
+		queries.push_back("document" + std::to_string(i % 100 < missPercentage ? key * 7919 + 1 : key * 7919));
+	}
+	biMap2.RebuildSecondFilter();
+
+	size_t found = 0;
+	auto now1 = clock.now();
+
+	// evaluate hashed index
+	for (const auto& query : queries)
+		found += biMap1.SecondExists(query);
+
+	auto now2 = clock.now();
+	OutputDuration("HashedIndex                               ", now1, now2);
+
+	now1 = clock.now();
+
+	// evaluate hashed index with filter
+	for (const auto& query : queries)
+		found += biMap2.SecondExists(query);
+
+	now2 = clock.now();
+	OutputDuration("FilteredIndex                             ", now1, now2);
+
+	auto statistics = biMap2.SecondFilterStatistics();
+	std::cout << "Found: " << found << ", skip rate: " << statistics.SkipRate() << ", false positives: " << statistics.falsePositives << ", filter bytes: " << statistics.bytes << std::endl;
+}
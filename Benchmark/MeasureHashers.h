@@ -0,0 +1,92 @@
+#pragma once
+#include "../BidirectionalMap/BidirectionalMap.h"
+#include "CompareMapBidirectionalMapAccess.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// average number of keys compared by a successful lookup and the longest bucket, for buckets of a hashed index
+// with the keys and for a table with a power of two buckets that uses the low bits of the hash
+template<typename THash, typename T>
+void OutputProbeLengths(const std::vector<T>& keys)
+{
+	std::unordered_map<T, size_t, THash> map;
+	for (size_t i = 0; i < keys.size(); ++i)
+		map.emplace(keys[i], i);
+	std::vector<size_t> sizes(map.bucket_count());
+	for (size_t bucket = 0; bucket < map.bucket_count(); ++bucket)
+		sizes[bucket] = map.bucket_size(bucket);
+	std::vector<size_t> lowBitSizes(1);
+	while (lowBitSizes.size() < keys.size())
+		lowBitSizes.resize(lowBitSizes.size() * 2);
+	for (const auto& key : keys)
+		++lowBitSizes[THash{}(key) & (lowBitSizes.size() - 1)];
+
+	for (const auto* bucketSizes : { &sizes, &lowBitSizes })
+	{
+		size_t compared = 0;
+		size_t longest = 0;
+		for (size_t size : *bucketSizes)
+		{
+			compared += size * (size + 1) / 2;
+			longest = (std::max)(longest, size);
+		}
+		std::cout << (bucketSizes == &sizes ? "  index" : "  power of two table") << " average probe length: " << double(compared) / keys.size() << ", longest bucket: " << longest << std::endl;
+	}
+}
+
+// insert the keys as first keys into a map hashed by THash and look each of them up
+template<typename THash, typename T>
+void MeasureHasher(const char* name, const std::vector<T>& keys)
+{
+	std::chrono::high_resolution_clock clock;
+
+	auto now1 = clock.now();
+
+	MapSpecial::BidirectionalUnorderedMap<T, size_t, THash> biMap;
+	for (size_t i = 0; i < keys.size(); ++i)
+		biMap.Insert(keys[i], i);
+	size_t sum = 0;
+	for (const auto& key : keys)
+		sum += biMap.AtFirst(key);
+
+	auto now2 = clock.now();
+	OutputDuration(name, now1, now2);
+	OutputProbeLengths<THash>(keys);
+	if (sum != keys.size() * (keys.size() - 1) / 2)
+		std::cout << "Wrong sum: " << sum << std::endl;
+}
+
+// compare std::hash with the bundled hashers on sequential, strided and random integers and on short strings
+inline void MeasureHashers(size_t numOfItems)
+{
+	std::cout << "*** " << numOfItems << " keys inserted and looked up ***" << std::endl;
+
+	std::default_random_engine random;
+	std::uniform_int_distribution<unsigned long long> distribution;
+	std::vector<unsigned long long> sequential(numOfItems);
+	std::vector<unsigned long long> strided(numOfItems);
+	std::vector<unsigned long long> randomKeys(numOfItems);
+	std::vector<std::string> strings(numOfItems);
+	for (size_t i = 0; i < numOfItems; ++i)
+	{
+		sequential[i] = i;
+		strided[i] = i << 20;
+		randomKeys[i] = distribution(random);
+		strings[i] = "id" + std::to_string(i * 7919);
+	}
+
+	MeasureHasher<std::hash<unsigned long long>>("sequential, std::hash                     ", sequential);
+	MeasureHasher<MapSpecial::IntegerHash>("sequential, IntegerHash                   ", sequential);
+	MeasureHasher<std::hash<unsigned long long>>("strided, std::hash                        ", strided);
+	MeasureHasher<MapSpecial::IntegerHash>("strided, IntegerHash                      ", strided);
+	MeasureHasher<std::hash<unsigned long long>>("random, std::hash                         ", randomKeys);
+	MeasureHasher<MapSpecial::IntegerHash>("random, IntegerHash                       ", randomKeys);
+	MeasureHasher<std::hash<std::string>>("short strings, std::hash                  ", strings);
+	MeasureHasher<MapSpecial::StringHash>("short strings, StringHash                 ", strings);
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "../BidirectionalMap/BidirectionalMap.h"
+#include "CompareMapBidirectionalMapAccess.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// compare InsertOrAssign, which displaces conflicting keypairs with one lookup per side, to the sequence of
+// existence checks, removals and insert that makes the same keypairs
+template<template<typename... Args> class TBiMap>
+void MeasureInsertOrAssign(size_t numOfItems, size_t numOfRounds)
+{
+	std::chrono::high_resolution_clock clock;
+
+	std::cout << "*** " << numOfRounds << " rounds of reassignments in " << numOfItems << " string-int pairs ***" << std::endl;
+
+	std::vector<std::string> users;
+	for (size_t i = 0; i < numOfItems; ++i)
+		users.push_back("user" + std::to_string(i * 7919));
+
+	// in each round every user gets the second key of its neighbour, so both keys of a pair are in conflict
+	TBiMap<std::string, unsigned long long> biMap1;
+	for (size_t i = 0; i < numOfItems; ++i)
+		biMap1.Insert(users[i], i);
+	size_t evicted = 0;
+	auto now1 = clock.now();
+
+	// evaluate InsertOrAssign
+	for (size_t round = 1; round <= numOfRounds; ++round)
+	{
+		for (size_t i = 0; i < numOfItems; ++i)
+		{
+			auto result = biMap1.InsertOrAssign(users[i], (i + round) % numOfItems);
+			evicted += result.evictedBySecond.has_value();
+		}
+	}
+
+	auto now2 = clock.now();
+	OutputDuration("InsertOrAssign                            ", now1, now2);
+
+	TBiMap<std::string, unsigned long long> biMap2;
+	for (size_t i = 0; i < numOfItems; ++i)
+		biMap2.Insert(users[i], i);
+	now1 = clock.now();
+
+	// evaluate existence checks, removals and Insert
+	for (size_t round = 1; round <= numOfRounds; ++round)
+	{
+		for (size_t i = 0; i < numOfItems; ++i)
+		{
+			unsigned long long second = (i + round) % numOfItems;
+			if (biMap2.FirstExists(users[i]) && biMap2.AtFirst(users[i]) == second)
+				continue;
+			if (biMap2.FirstExists(users[i]))
+				biMap2.RemoveFirst(users[i]);
+			if (biMap2.SecondExists(second))
+			{
+				biMap2.RemoveSecond(second);
+				++evicted;
+			}
+			biMap2.Insert(users[i], second);
+		}
+	}
+
+	now2 = clock.now();
+	OutputDuration("Exists, Remove and Insert                 ", now1, now2);
+
+	std::cout << "Maps equal: " << (biMap1.Size() == biMap2.Size()) << ", evicted: " << evicted << std::endl;
+}
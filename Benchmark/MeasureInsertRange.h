@@ -0,0 +1,44 @@
+#pragma once
+#include "../BidirectionalMap/BidirectionalMap.h"
+#include "CompareMapBidirectionalMapAccess.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// compare loading of a batch of keypairs into a non-empty map with InsertRange to a loop of Insert
+template<template<typename... Args> class TBiMap>
+void MeasureInsertRange(size_t numOfItems, size_t batchSize)
+{
+	std::chrono::high_resolution_clock clock;
+
+	std::cout << "*** batch of " << batchSize << " string-int pairs into " << numOfItems << " pairs ***" << std::endl;
+
+	TBiMap<std::string, unsigned long long> biMap1;
+	for (size_t i = 0; i < numOfItems; ++i)
+		biMap1.Insert("user" + std::to_string(i * 7919), i);
+	TBiMap<std::string, unsigned long long> biMap2(biMap1);
+	std::vector<std::pair<std::string, unsigned long long>> batch;
+	for (size_t i = numOfItems; i < numOfItems + batchSize; ++i)
+		batch.emplace_back("user" + std::to_string(i * 7919), i);
+
+	auto now1 = clock.now();
+
+	// evaluate InsertRange
+	auto result = biMap1.InsertRange(batch.cbegin(), batch.cend());
+
+	auto now2 = clock.now();
+	OutputDuration("InsertRange                               ", now1, now2);
+
+	now1 = clock.now();
+
+	// evaluate Insert for every keypair
+	for (const auto& keyPair : batch)
+		biMap2.Insert(keyPair.first, keyPair.second);
+
+	now2 = clock.now();
+	OutputDuration("Insert                                    ", now1, now2);
+
+	std::cout << "Inserted: " << result.inserted << ", sizes: " << biMap1.Size() << " " << biMap2.Size() << std::endl;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "../BidirectionalMap/BidirectionalMap.h"
+#include "../BidirectionalMap/BidirectionalMapJournal.h"
+#include "CompareMapBidirectionalMapAccess.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+// compare insertion into in-memory bidirectional map to insertion into journaled one, for each sync policy
+template<template<typename... Args> class TBiMap>
+void MeasureJournal(size_t numOfItems)
+{
+	const std::string journalPath = "MeasureJournal.journal";
+	std::chrono::high_resolution_clock clock;
+
+	std::cout << "*** insert " << numOfItems << " string-int pairs ***" << std::endl;
+
+	auto now1 = clock.now();
+
+	// evaluate insertion without journal
+	{
+		TBiMap<std::string, int> biMap;
+		for (size_t i = 0; i < numOfItems; ++i)
+			biMap.Insert("key" + std::to_string(i * 7919), int(i));
+	}
+
+	auto now2 = clock.now();
+	OutputDuration("In-memory insert                          ", now1, now2);
+
+	const std::pair<MapSpecial::JournalSync, const char*> policies[] =
+	{
+		{ MapSpecial::JournalSync::EveryRecord, "Journaled insert of 1%, each record synced " },
+		{ MapSpecial::JournalSync::Never,       "Journaled insert, never synced            " },
+		{ MapSpecial::JournalSync::OnCommit,    "Journaled insert, synced every 1000       " }
+	};
+	for (const auto& policy : policies)
+	{
+		// syncing every record is too slow to be measured on the whole set
+		size_t count = policy.first == MapSpecial::JournalSync::EveryRecord ? numOfItems / 100 : numOfItems;
+		std::remove(journalPath.c_str());
+		MapSpecial::JournalOptions options;
+		options.sync = policy.first;
+
+		now1 = clock.now();
+		{
+			TBiMap<std::string, int> biMap;
+			MapSpecial::BidirectionalMapJournal<std::string, int> journal(journalPath, options);
+			biMap.AttachJournal(&journal);
+			for (size_t i = 0; i < count; ++i)
+			{
+				biMap.Insert("key" + std::to_string(i * 7919), int(i));
+				if (i % 1000 == 999)
+					journal.Commit();
+			}
+			journal.Commit();
+			biMap.AttachJournal(nullptr);
+		}
+		now2 = clock.now();
+		OutputDuration(policy.second, now1, now2);
+	}
+
+	now1 = clock.now();
+
+	// evaluate recovery of the map from the complete journal written by the last policy
+	TBiMap<std::string, int> recovered;
+	MapSpecial::BidirectionalMapJournal<std::string, int>::Replay(journalPath, recovered);
+
+	now2 = clock.now();
+	OutputDuration("Replay journal                            ", now1, now2);
+
+	std::remove(journalPath.c_str());
+}
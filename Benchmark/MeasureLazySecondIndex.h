@@ -0,0 +1,52 @@
+#pragma once
+#include "../BidirectionalMap/BidirectionalMap.h"
+#include "CompareMapBidirectionalMapAccess.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// compare bulk loading followed by lookups of first keys with both indices maintained and with the index of
+// second keys dropped before loading; the latter also reports the cost of building the index on demand
+template<template<typename... Args> class TBiMap>
+void MeasureLazySecondIndex(size_t numOfItems, size_t numOfLookups)
+{
+	std::chrono::high_resolution_clock clock;
+
+	std::cout << "*** " << numOfItems << " int-string pairs loaded, " << numOfLookups << " lookups of first keys ***" << std::endl;
+
+	size_t found = 0;
+	auto now1 = clock.now();
+
+	// evaluate loading with both indices
+	TBiMap<unsigned long long, std::string> biMap1;
+	for (size_t i = 0; i < numOfItems; ++i)
+		biMap1.Insert(i * 7919, "user" + std::to_string(i));
+	for (size_t i = 0; i < numOfLookups; ++i)
+		found += biMap1.FirstExists((i % numOfItems) * 7919);
+
+	auto now2 = clock.now();
+	OutputDuration("both indices                              ", now1, now2);
+
+	now1 = clock.now();
+
+	// evaluate loading with the index of second keys dropped
+	TBiMap<unsigned long long, std::string> biMap2;
+	biMap2.DropSecondIndex();
+	for (size_t i = 0; i < numOfItems; ++i)
+		biMap2.Insert(i * 7919, "user" + std::to_string(i));
+	for (size_t i = 0; i < numOfLookups; ++i)
+		found += biMap2.FirstExists((i % numOfItems) * 7919);
+
+	now2 = clock.now();
+	OutputDuration("first index only                          ", now1, now2);
+
+	now1 = clock.now();
+
+	// evaluate building the index of second keys on the first lookup
+	found += biMap2.SecondExists("user0");
+
+	now2 = clock.now();
+	OutputDuration("building second index on demand           ", now1, now2);
+
+	std::cout << "Found: " << found << std::endl;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "../BidirectionalMap/BidirectionalMapDelimited.h"
+#include "CompareMapBidirectionalMapAccess.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// compare parsing a generated TSV file line by line with iostreams to parallel LoadDelimited
+template<template<typename... Args> class TBiMap>
+void MeasureLoadDelimited(size_t numOfLines)
+{
+	const std::string filePath = "MeasureLoadDelimited.tsv";
+	std::chrono::high_resolution_clock clock;
+
+	std::cout << "*** load " << numOfLines << " lines ***" << std::endl;
+
+	{
+		std::ofstream output(filePath, std::ios::binary | std::ios::trunc);
+		for (size_t i = 0; i < numOfLines; ++i)
+			output << "name" << i * 7919 << '\t' << i << '\n';
+	}
+
+	auto now1 = clock.now();
+
+	// evaluate reading with iostreams and inserting keypairs one by one
+	TBiMap<std::string, unsigned long long> streamedBiMap;
+	{
+		std::ifstream input(filePath, std::ios::binary);
+		std::string line;
+		while (std::getline(input, line))
+		{
+			auto separator = line.find('\t');
+			streamedBiMap.Insert(line.substr(0, separator), std::stoull(line.substr(separator + 1)));
+		}
+	}
+
+	auto now2 = clock.now();
+	OutputDuration("iostream and Insert                       ", now1, now2);
+
+	now1 = clock.now();
+
+	// evaluate LoadDelimited using all hardware threads
+	TBiMap<std::string, unsigned long long> loadedBiMap;
+	LoadDelimited(loadedBiMap, filePath);
+
+	now2 = clock.now();
+	OutputDuration("LoadDelimited                             ", now1, now2);
+
+	now1 = clock.now();
+
+	// evaluate LoadDelimited on a single thread
+	TBiMap<std::string, unsigned long long> singleThreadBiMap;
+	MapSpecial::DelimitedLoadOptions options;
+	options.threads = 1;
+	LoadDelimited(singleThreadBiMap, filePath, options);
+
+	now2 = clock.now();
+	OutputDuration("LoadDelimited, single thread              ", now1, now2);
+
+	assert(streamedBiMap.Size() == loadedBiMap.Size());
+	std::remove(filePath.c_str());
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "../BidirectionalMap/BidirectionalLruCache.h"
+#include "CompareMapBidirectionalMapAccess.h"
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// compare BidirectionalLruCache to BidirectionalUnorderedMap with recency kept in a separate list indexed by
+// first keys; keys are requested with skewed distribution and missing keys are inserted
+inline void MeasureLruCache(size_t capacity, size_t numOfKeys, size_t numOfRequests)
+{
+	std::chrono::high_resolution_clock clock;
+
+	std::cout << "*** " << numOfRequests << " requests of " << numOfKeys << " keys, capacity " << capacity << " ***" << std::endl;
+
+	std::vector<std::string> connections;
+	for (size_t i = 0; i < numOfKeys; ++i)
+		connections.push_back("connection" + std::to_string(i * 7919));
+	std::default_random_engine random;
+	std::geometric_distribution<size_t> distribution(10.0 / numOfKeys);
+	std::vector<size_t> requests;
+	for (size_t i = 0; i < numOfRequests; ++i)
+		requests.push_back(distribution(random) % numOfKeys);
+
+	MapSpecial::BidirectionalLruCache<std::string, unsigned long long> cache(capacity);
+	unsigned long long checksum = 0;
+	auto now1 = clock.now();
+
+	// evaluate BidirectionalLruCache
+	for (size_t request : requests)
+	{
+		const unsigned long long* peer = cache.FindFirst(connections[request]);
+		if (peer != nullptr)
+			checksum += *peer;
+		else
+			cache.Insert(connections[request], request);
+	}
+
+	auto now2 = clock.now();
+	OutputDuration("BidirectionalLruCache                     ", now1, now2);
+
+	MapSpecial::BidirectionalUnorderedMap<std::string, unsigned long long> biMap;
+	std::list<std::string> recency;
+	std::unordered_map<std::string, std::list<std::string>::iterator> positions;
+	size_t hits = 0;
+	now1 = clock.now();
+
+	// evaluate BidirectionalUnorderedMap with external recency list
+	for (size_t request : requests)
+	{
+		const std::string& connection = connections[request];
+		auto position = positions.find(connection);
+		if (position != positions.end())
+		{
+			recency.splice(recency.begin(), recency, position->second);
+			checksum += biMap.AtFirst(connection);
+			++hits;
+			continue;
+		}
+		biMap.Insert(connection, request);
+		recency.push_front(connection);
+		positions.emplace(connection, recency.begin());
+		if (recency.size() > capacity)
+		{
+			biMap.RemoveFirst(recency.back());
+			positions.erase(recency.back());
+			recency.pop_back();
+		}
+	}
+
+	now2 = clock.now();
+	OutputDuration("External LRU list                         ", now1, now2);
+
+	std::cout << "Hits: " << cache.Hits() << " " << hits << ", checksum: " << checksum << std::endl;
+}
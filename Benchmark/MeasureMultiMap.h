@@ -0,0 +1,102 @@
+#pragma once
+#include "../BidirectionalMap/BidirectionalMultiMap.h"
+#include "CompareMapBidirectionalMapAccess.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// compare BidirectionalMultiMap to a pair of std::unordered_multimap that store every user-group relation twice:
+// insertion, equal range lookups from both sides and removal of single relations
+inline void MeasureMultiMap(size_t numOfUsers, size_t numOfGroups, size_t groupsPerUser)
+{
+	std::chrono::high_resolution_clock clock;
+
+	std::cout << "*** " << numOfUsers << " users in " << groupsPerUser << " of " << numOfGroups << " groups ***" << std::endl;
+
+	std::default_random_engine random;
+	std::uniform_int_distribution<size_t> distribution(0, numOfGroups - 1);
+	std::vector<std::string> users;
+	std::vector<std::string> groups;
+	for (size_t i = 0; i < numOfUsers; ++i)
+		users.push_back("user" + std::to_string(i * 7919));
+	for (size_t i = 0; i < numOfGroups; ++i)
+		groups.push_back("group" + std::to_string(i * 7919));
+	std::vector<std::pair<size_t, size_t>> relations;
+	for (size_t user = 0; user < numOfUsers; ++user)
+	{
+		for (size_t i = 0; i < groupsPerUser; ++i)
+			relations.emplace_back(user, (user + i * 7) % numOfGroups);
+	}
+	std::vector<std::pair<size_t, size_t>> removals;
+	for (size_t i = 0; i < relations.size() / 10; ++i)
+		removals.push_back(relations[i * 10 + distribution(random) % 10]);
+
+	size_t checksum = 0;
+	auto now1 = clock.now();
+
+	// evaluate BidirectionalMultiMap
+	MapSpecial::BidirectionalMultiMap<std::string, std::string> multiMap;
+	for (const auto& relation : relations)
+		multiMap.Insert(users[relation.first], groups[relation.second]);
+	for (const auto& user : users)
+		checksum += multiMap.EqualRangeFirst(user).size();
+	for (const auto& group : groups)
+	{
+		for (const auto& keyPair : multiMap.EqualRangeSecond(group))
+			checksum += keyPair.first.size();
+	}
+	for (const auto& removal : removals)
+		multiMap.RemovePair(users[removal.first], groups[removal.second]);
+
+	auto now2 = clock.now();
+	OutputDuration("BidirectionalMultiMap                     ", now1, now2);
+
+	now1 = clock.now();
+
+	// evaluate two std::unordered_multimap
+	std::unordered_multimap<std::string, std::string> groupsOfUser;
+	std::unordered_multimap<std::string, std::string> usersOfGroup;
+	for (const auto& relation : relations)
+	{
+		groupsOfUser.emplace(users[relation.first], groups[relation.second]);
+		usersOfGroup.emplace(groups[relation.second], users[relation.first]);
+	}
+	for (const auto& user : users)
+		checksum += groupsOfUser.count(user);
+	for (const auto& group : groups)
+	{
+		auto range = usersOfGroup.equal_range(group);
+		for (auto it = range.first; it != range.second; ++it)
+			checksum += it->second.size();
+	}
+	for (const auto& removal : removals)
+	{
+		auto range1 = groupsOfUser.equal_range(users[removal.first]);
+		for (auto it = range1.first; it != range1.second; ++it)
+		{
+			if (it->second == groups[removal.second])
+			{
+				groupsOfUser.erase(it);
+				break;
+			}
+		}
+		auto range2 = usersOfGroup.equal_range(groups[removal.second]);
+		for (auto it = range2.first; it != range2.second; ++it)
+		{
+			if (it->second == users[removal.first])
+			{
+				usersOfGroup.erase(it);
+				break;
+			}
+		}
+	}
+
+	now2 = clock.now();
+	OutputDuration("Two std::unordered_multimap               ", now1, now2);
+
+	std::cout << "Checksum: " << checksum << ", sizes: " << multiMap.Size() << " " << groupsOfUser.size() << std::endl;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "../BidirectionalMap/BidirectionalMap.h"
+#include "CompareMapBidirectionalMapAccess.h"
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+// std::map index has to walk all preceding keys to find the rank
+inline size_t RankOfFirstKey(const MapSpecial::BidirectionalMap<int, std::string>& biMap, int key)
+{
+	return size_t(std::distance(biMap.ByFirst().begin(), biMap.LowerBoundFirst(key).begin()));
+}
+
+inline size_t RankOfFirstKey(const MapSpecial::BidirectionalRankedMap<int, std::string>& biMap, int key)
+{
+	return biMap.RankOfFirst(key);
+}
+
+// measure insertion and removal of keypairs and rank queries; the heap left by a previous measurement
+// affects the results, so map types should be compared in separate runs
+template<template<typename... Args> class TBiMap>
+void MeasureOrderStatistics(size_t numOfItems, size_t numOfRankQueries)
+{
+	std::chrono::high_resolution_clock clock;
+
+	std::cout << "*** " << numOfItems << " int-string pairs, " << numOfRankQueries << " rank queries ***" << std::endl;
+
+	auto now1 = clock.now();
+
+	// evaluate insertion
+	TBiMap<int, std::string> biMap;
+	for (size_t i = 0; i < numOfItems; ++i)
+		biMap.Insert(int(i * 7919 % numOfItems), "value" + std::to_string(i));
+
+	auto now2 = clock.now();
+	OutputDuration("Insert                                    ", now1, now2);
+
+	now1 = clock.now();
+
+	// evaluate removal of every other keypair
+	for (size_t i = 0; i < numOfItems; i += 2)
+		biMap.RemoveFirst(int(i));
+
+	now2 = clock.now();
+	OutputDuration("Remove                                    ", now1, now2);
+
+	size_t rankSum = 0;
+	now1 = clock.now();
+
+	// evaluate rank queries
+	for (size_t i = 0; i < numOfRankQueries; ++i)
+		rankSum += RankOfFirstKey(biMap, int(i * 104729 % numOfItems));
+
+	now2 = clock.now();
+	OutputDuration("Rank of first key                         ", now1, now2);
+	std::cout << "(checksum " << rankSum << ")" << std::endl;
+}
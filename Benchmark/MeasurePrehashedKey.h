@@ -0,0 +1,66 @@
+#pragma once
+#include "../BidirectionalMap/BidirectionalMap.h"
+#include "CompareMapBidirectionalMapAccess.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// compare lookups of the same long string keys in several maps, hashing each key for every map and hashing
+// it once into a PrehashedKey that is used for all maps
+inline void MeasurePrehashedKey(size_t numOfItems, size_t numOfMaps, size_t numOfLookups)
+{
+	std::chrono::high_resolution_clock clock;
+
+	std::cout << "*** " << numOfLookups << " lookups of 64-256 byte keys in " << numOfMaps << " maps with " << numOfItems << " keys ***" << std::endl;
+
+	std::default_random_engine random;
+	std::uniform_int_distribution<size_t> length(64, 256);
+	std::uniform_int_distribution<int> letter('a', 'z');
+	std::vector<std::string> keys(numOfItems);
+	for (auto& key : keys)
+	{
+		key.resize(length(random));
+		for (auto& c : key)
+			c = static_cast<char>(letter(random));
+	}
+	std::vector<MapSpecial::BidirectionalUnorderedMap<std::string, int>> biMaps(numOfMaps);
+	for (size_t m = 0; m < numOfMaps; ++m)
+	{
+		for (size_t i = 0; i < numOfItems; ++i)
+			biMaps[m].Insert(keys[i], static_cast<int>(i + m));
+	}
+	std::uniform_int_distribution<size_t> index(0, numOfItems - 1);
+	std::vector<size_t> lookups(numOfLookups);
+	for (auto& lookup : lookups)
+		lookup = index(random);
+
+	long long sum = 0;
+	auto now1 = clock.now();
+
+	// evaluate lookups that hash the key in every map
+	for (size_t lookup : lookups)
+	{
+		for (const auto& biMap : biMaps)
+			sum += biMap.AtFirst(keys[lookup]);
+	}
+
+	auto now2 = clock.now();
+	OutputDuration("key hashed by every map                   ", now1, now2);
+
+	now1 = clock.now();
+
+	// evaluate lookups with the key hashed once
+	for (size_t lookup : lookups)
+	{
+		MapSpecial::PrehashedKey<std::string> key(keys[lookup]);
+		for (const auto& biMap : biMaps)
+			sum += biMap.AtFirst(key);
+	}
+
+	now2 = clock.now();
+	OutputDuration("PrehashedKey                              ", now1, now2);
+
+	std::cout << "Sum: " << sum << std::endl;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "../BidirectionalMap/BidirectionalMap.h"
+#include "CompareMapBidirectionalMapAccess.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// load, look up and scan by prefix URL-like first keys of a bidirectional map with the given index of first keys
+template<typename TIndex>
+void MeasureUrlIndex(const std::string& name, const std::vector<std::string>& urls, const std::vector<std::string>& prefixes, size_t numOfLookups)
+{
+	std::chrono::high_resolution_clock clock;
+
+	auto now1 = clock.now();
+
+	MapSpecial::BidirectionalIndexedMap<std::string, size_t, TIndex, MapSpecial::HashedIndex<size_t>> biMap;
+	for (size_t i = 0; i < urls.size(); ++i)
+		biMap.Insert(urls[i], i);
+
+	auto now2 = clock.now();
+	OutputDuration(name + " load                     ", now1, now2);
+
+	size_t found = 0;
+	now1 = clock.now();
+
+	for (size_t i = 0; i < numOfLookups; ++i)
+		found += biMap.AtFirst(urls[i * 7919 % urls.size()]);
+
+	now2 = clock.now();
+	OutputDuration(name + " lookups                  ", now1, now2);
+
+	size_t visited = 0;
+	now1 = clock.now();
+
+	// keys with a prefix are the keys from the lower bound of the prefix on, up to the first one without it
+	for (const auto& prefix : prefixes)
+	{
+		if constexpr (std::is_same<TIndex, MapSpecial::RadixTreeIndex<std::string>>::value)
+		{
+			for (const auto& pair : biMap.PrefixFirst(prefix))
+				visited += pair.second;
+		}
+		else
+		{
+			for (const auto& pair : biMap.LowerBoundFirst(prefix))
+			{
+				if (pair.first.compare(0, prefix.size(), prefix) != 0)
+					break;
+				visited += pair.second;
+			}
+		}
+	}
+
+	now2 = clock.now();
+	OutputDuration(name + " prefix scans             ", now1, now2);
+
+	// output checksums so that the loops are not optimized away
+	std::cout << "(checksums " << found << " " << visited << ")" << std::endl;
+}
+
+// compare the radix tree index of string keys to the ordered index on keys that share long prefixes
+inline void MeasureRadixTree(size_t numOfItems, size_t numOfLookups, size_t numOfScans)
+{
+	const char* resources[] = { "users", "orders", "products", "invoices", "sessions", "reports", "accounts", "payments" };
+
+	std::vector<std::string> urls;
+	urls.reserve(numOfItems);
+	for (size_t i = 0; i < numOfItems; ++i)
+		urls.push_back("/api/v" + std::to_string(i % 3 + 1) + "/" + resources[i / 3 % 8] + "/" + std::to_string(i * 104729 % 1000003));
+	std::vector<std::string> prefixes;
+	for (size_t i = 0; i < numOfScans; ++i)
+		prefixes.push_back("/api/v" + std::to_string(i % 3 + 1) + "/" + resources[i % 8] + "/" + std::to_string(i % 1000));
+
+	std::cout << "*** " << numOfItems << " URL-like keys, " << numOfLookups << " lookups, " << numOfScans << " prefix scans ***" << std::endl;
+
+	MeasureUrlIndex<MapSpecial::OrderedIndex<std::string>>("OrderedIndex  ", urls, prefixes, numOfLookups);
+	MeasureUrlIndex<MapSpecial::RadixTreeIndex<std::string>>("RadixTreeIndex", urls, prefixes, numOfLookups);
+}
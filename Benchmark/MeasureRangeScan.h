@@ -0,0 +1,65 @@
+#pragma once
+#include "../BidirectionalMap/BidirectionalMap.h"
+#include "CompareMapBidirectionalMapAccess.h"
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+
+// compare scanning ranges of keys in bidirectional map to scanning a separate std::map holding the same pairs
+inline void MeasureRangeScan(size_t numOfItems, size_t numOfScans, int rangeLength)
+{
+	std::chrono::high_resolution_clock clock;
+
+	std::cout << "*** " << numOfScans << " scans of " << rangeLength << " keys in " << numOfItems << " int-string pairs ***" << std::endl;
+
+	MapSpecial::BidirectionalMap<int, std::string> biMap;
+	std::map<int, std::string> map;
+	for (size_t i = 0; i < numOfItems; ++i)
+	{
+		biMap.Insert(int(i * 7919 % numOfItems), "value" + std::to_string(i));
+		map.emplace(int(i * 7919 % numOfItems), "value" + std::to_string(i));
+	}
+
+	size_t visited1 = 0;
+	auto now1 = clock.now();
+
+	// evaluate range scan in std::map
+	for (size_t i = 0; i < numOfScans; ++i)
+	{
+		int low = int(i * 104729 % numOfItems);
+		auto end = map.lower_bound(low + rangeLength);
+		for (auto it = map.lower_bound(low); it != end; ++it)
+			visited1 += it->second.size();
+	}
+
+	auto now2 = clock.now();
+	OutputDuration("Scan std::map                             ", now1, now2);
+
+	size_t visited2 = 0;
+	now1 = clock.now();
+
+	// evaluate range scan of first keys in bidirectional map
+	for (size_t i = 0; i < numOfScans; ++i)
+	{
+		int low = int(i * 104729 % numOfItems);
+		for (const auto& pair : biMap.RangeFirst(low, low + rangeLength))
+			visited2 += pair.second.size();
+	}
+
+	now2 = clock.now();
+	OutputDuration("Scan bidirectional map by first key       ", now1, now2);
+
+	size_t visited3 = 0;
+	now1 = clock.now();
+
+	// evaluate full iteration over keypairs
+	for (const auto& pair : biMap)
+		visited3 += pair.second.size();
+
+	now2 = clock.now();
+	OutputDuration("Iterate over all keypairs                 ", now1, now2);
+
+	// output checksums so that the loops are not optimized away
+	std::cout << "(checksums " << visited1 << " " << visited2 << " " << visited3 << ")" << std::endl;
+}
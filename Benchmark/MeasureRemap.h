@@ -0,0 +1,45 @@
+#pragma once
+#include "../BidirectionalMap/BidirectionalMap.h"
+#include "CompareMapBidirectionalMapAccess.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// compare renumbering of all second keys with RemapSecond to calling ChangeSecond for every keypair
+template<template<typename... Args> class TBiMap>
+void MeasureRemap(size_t numOfItems)
+{
+	std::chrono::high_resolution_clock clock;
+
+	std::cout << "*** renumbering of " << numOfItems << " string-int pairs ***" << std::endl;
+
+	// ids are shifted beyond the current range so that ChangeSecond never meets an existing key
+	TBiMap<std::string, unsigned long long> biMap1;
+	std::vector<std::string> users;
+	for (size_t i = 0; i < numOfItems; ++i)
+	{
+		users.push_back("user" + std::to_string(i * 7919));
+		biMap1.Insert(users.back(), i);
+	}
+	TBiMap<std::string, unsigned long long> biMap2(biMap1);
+
+	auto now1 = clock.now();
+
+	// evaluate RemapSecond
+	biMap1.RemapSecond([numOfItems](unsigned long long id) { return id + numOfItems; });
+
+	auto now2 = clock.now();
+	OutputDuration("RemapSecond                               ", now1, now2);
+
+	now1 = clock.now();
+
+	// evaluate ChangeSecond for every keypair
+	for (size_t i = 0; i < numOfItems; ++i)
+		biMap2.ChangeSecond(users[i], biMap2.AtFirst(users[i]) + numOfItems);
+
+	now2 = clock.now();
+	OutputDuration("ChangeSecond                              ", now1, now2);
+
+	std::cout << "Checksum: " << biMap1.AtFirst(users[numOfItems / 2]) + biMap2.AtFirst(users[numOfItems / 2]) << std::endl;
+}
@@ -0,0 +1,434 @@
+#pragma once
+
+/*
+Copyright(c) 2017 Julijan Šribar
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software.If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include "BidirectionalMap.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <list>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <cassert>
+
+namespace MapSpecial
+{
+
+	// bidirectional map in which every keypair has a deadline. Keypairs whose deadline has passed are treated as
+	// absent by lookups and are removed from the map by Tick. Deadlines are kept in a hierarchical timing wheel:
+	// keypairs themselves are stored in the lists of wheel slots and are moved between slots by splicing, so
+	// iterators in both indices stay valid and expiry needs neither searching nor allocation. Slots of the first
+	// level cover one tick of given resolution each; slots of every further level cover 64 slots of the
+	// previous one and are distributed to the lower level when the wheel reaches them. Every level keeps a bitmap
+	// of its occupied slots, so Tick jumps over ticks at which no slot is due instead of visiting them one by one.
+	template <typename T1, typename T2, typename TClock = std::chrono::steady_clock>
+	class BidirectionalExpiringMap
+	{
+	public:
+		using value_type = std::pair<T1, T2>;
+		using time_point = typename TClock::time_point;
+		using duration = typename TClock::duration;
+
+		// create an empty map; deadlines are rounded up to multiples of resolution
+		explicit BidirectionalExpiringMap(duration resolution = std::chrono::milliseconds(1))
+			: resolution(resolution)
+			, origin(TClock::now())
+		{
+			if (resolution <= duration::zero())
+				throw std::invalid_argument("Resolution must be positive.");
+		}
+
+		// the map refers to its own slot lists, so it is not copied or moved
+		BidirectionalExpiringMap(const BidirectionalExpiringMap&) = delete;
+		BidirectionalExpiringMap& operator=(const BidirectionalExpiringMap&) = delete;
+
+		// insert a new keypair that expires at given deadline; expired keypairs with the same keys are replaced
+		bool Insert(const T1& first, const T2& second, time_point deadline)
+		{
+			time_point now = TClock::now();
+			auto itKey1 = map1.find(&first);
+			if (itKey1 != map1.end() && IsExpired(itKey1->second, now))
+			{
+				Erase(itKey1->second);
+				itKey1 = map1.end();
+			}
+			auto itKey2 = map2.find(&second);
+			if (itKey2 != map2.end() && IsExpired(itKey2->second, now))
+			{
+				Erase(itKey2->second);
+				itKey2 = map2.end();
+			}
+			if (itKey1 != map1.end())
+			{
+				// do not perform insertion if provided keypair already exists
+				if (itKey2 != map2.end() && &*itKey1->second == &*itKey2->second)
+					return false;
+				throw std::invalid_argument("First key already exists in the map.");
+			}
+			if (itKey2 != map2.end())
+				throw std::invalid_argument("Second key already exists in the map.");
+
+			Slot& slot = SlotFor((std::max)(TickOf(deadline), currentTick + 1));
+			slot.push_back(Entry{ value_type(first, second), deadline, &slot });
+			UpdateOccupancy(slot);
+			auto it = std::prev(slot.end());
+			try
+			{
+				map1.emplace(&(it->keyPair.first), it);
+				map2.emplace(&(it->keyPair.second), it);
+			}
+			catch (...)
+			{
+				map1.erase(&(it->keyPair.first));
+				slot.pop_back();
+				UpdateOccupancy(slot);
+				throw;
+			}
+			return true;
+		}
+
+		// insert a new keypair that expires after given time to live
+		bool InsertFor(const T1& first, const T2& second, duration timeToLive)
+		{
+			return Insert(first, second, TClock::now() + timeToLive);
+		}
+
+		// change the deadline of a keypair which has given first key
+		void RescheduleFirst(const T1& first, time_point deadline)
+		{
+			auto itKey1 = map1.find(&first);
+			if (itKey1 == map1.end() || IsExpired(itKey1->second, TClock::now()))
+				throw std::out_of_range("The first key must exist in the map.");
+			Reschedule(itKey1->second, deadline);
+		}
+
+		// change the deadline of a keypair which has given second key
+		void RescheduleSecond(const T2& second, time_point deadline)
+		{
+			auto itKey2 = map2.find(&second);
+			if (itKey2 == map2.end() || IsExpired(itKey2->second, TClock::now()))
+				throw std::out_of_range("The second key must exist in the map.");
+			Reschedule(itKey2->second, deadline);
+		}
+
+		// remove a keypair which has given first key
+		void RemoveFirst(const T1& first)
+		{
+			auto itKey1 = map1.find(&first);
+			if (itKey1 == map1.end() || IsExpired(itKey1->second, TClock::now()))
+				throw std::out_of_range("The first key must exist in the map.");
+			Erase(itKey1->second);
+		}
+
+		// remove a keypair which has given second key
+		void RemoveSecond(const T2& second)
+		{
+			auto itKey2 = map2.find(&second);
+			if (itKey2 == map2.end() || IsExpired(itKey2->second, TClock::now()))
+				throw std::out_of_range("The second key must exist in the map.");
+			Erase(itKey2->second);
+		}
+
+		// remove keypairs whose deadline is not later than now; returns the number of removed keypairs.
+		// Only ticks between the previous call and now at which some slot is due are visited.
+		size_t Tick(time_point now)
+		{
+			std::int64_t targetTick = now > origin ? (std::min)(std::int64_t((now - origin) / resolution), lastTick) : 0;
+			size_t count = 0;
+			while (currentTick < targetTick)
+			{
+				std::int64_t nextTick = NextBusyTick();
+				if (nextTick > targetTick)
+				{
+					currentTick = targetTick;
+					break;
+				}
+				currentTick = nextTick;
+				// higher levels are distributed first, since their keypairs may fall into lower slots reached now
+				if ((currentTick & ((std::int64_t(1) << (slotBits * levels)) - 1)) == 0)
+					Cascade(overflow);
+				for (std::size_t level = levels - 1; level > 0; --level)
+				{
+					if ((currentTick & ((std::int64_t(1) << (slotBits * level)) - 1)) == 0)
+						Cascade(wheel[level][SlotIndex(currentTick, level)]);
+				}
+				Slot& slot = wheel[0][SlotIndex(currentTick, 0)];
+				while (!slot.empty())
+				{
+					Erase(slot.begin());
+					++count;
+				}
+			}
+			return count;
+		}
+
+		// remove all keypairs
+		void Clear() noexcept
+		{
+			map1.clear();
+			map2.clear();
+			for (auto& level : wheel)
+			{
+				for (auto& slot : level)
+					slot.clear();
+			}
+			occupied.fill(0);
+			overflow.clear();
+			overflowTick = neverTick;
+		}
+
+		// get number of keypairs in the map, including expired ones that have not been removed by Tick yet
+		size_t Size() const noexcept
+		{
+			assert(map1.size() == map2.size());
+			return map1.size();
+		}
+
+		// check if first key exists in the map and has not expired
+		bool FirstExists(const T1& first) const
+		{
+			auto itKey1 = map1.find(&first);
+			return itKey1 != map1.end() && !IsExpired(itKey1->second, TClock::now());
+		}
+
+		// check if second key exists in the map and has not expired
+		bool SecondExists(const T2& second) const
+		{
+			auto itKey2 = map2.find(&second);
+			return itKey2 != map2.end() && !IsExpired(itKey2->second, TClock::now());
+		}
+
+		// get the value assigned to given first key; expired keypairs are treated as absent
+		const T2& AtFirst(const T1& first) const
+		{
+			auto itKey1 = map1.find(&first);
+			if (itKey1 == map1.end() || IsExpired(itKey1->second, TClock::now()))
+				throw std::out_of_range("The first key must exist in the map.");
+			return itKey1->second->keyPair.second;
+		}
+
+		// get the value assigned to given second key; expired keypairs are treated as absent
+		const T1& AtSecond(const T2& second) const
+		{
+			auto itKey2 = map2.find(&second);
+			if (itKey2 == map2.end() || IsExpired(itKey2->second, TClock::now()))
+				throw std::out_of_range("The second key must exist in the map.");
+			return itKey2->second->keyPair.first;
+		}
+
+		// get the deadline of a keypair which has given first key
+		time_point DeadlineOfFirst(const T1& first) const
+		{
+			auto itKey1 = map1.find(&first);
+			if (itKey1 == map1.end())
+				throw std::out_of_range("The first key must exist in the map.");
+			return itKey1->second->deadline;
+		}
+
+		// get the deadline of a keypair which has given second key
+		time_point DeadlineOfSecond(const T2& second) const
+		{
+			auto itKey2 = map2.find(&second);
+			if (itKey2 == map2.end())
+				throw std::out_of_range("The second key must exist in the map.");
+			return itKey2->second->deadline;
+		}
+
+	private:
+		struct Entry;
+		using Slot = std::list<Entry>;
+
+		struct Entry
+		{
+			value_type keyPair;
+			time_point deadline;
+			// list that currently holds the entry
+			Slot* slot;
+		};
+
+		static constexpr std::size_t slotBits = 6;
+		static constexpr std::size_t slotsPerLevel = std::size_t(1) << slotBits;
+		static constexpr std::size_t levels = 4;
+		// last tick that Tick reaches; deadlines beyond it never leave the overflow list
+		static constexpr std::int64_t lastTick = (std::numeric_limits<std::int64_t>::max)() >> 1;
+		static constexpr std::int64_t neverTick = (std::numeric_limits<std::int64_t>::max)();
+
+		duration resolution;
+		time_point origin;
+		// last tick processed by Tick
+		std::int64_t currentTick = 0;
+		std::array<std::array<Slot, slotsPerLevel>, levels> wheel;
+		// bit i of a level is set when its slot i is not empty
+		std::array<std::uint64_t, levels> occupied = {};
+		// keypairs with deadlines beyond the range of the last level
+		Slot overflow;
+		// no keypair in the overflow list expires before this tick
+		std::int64_t overflowTick = neverTick;
+		std::unordered_map<KeyPointer<T1>, typename Slot::iterator, DereferencedPointerHash<T1>, DereferencedPointerEquality<T1>> map1;
+		std::unordered_map<KeyPointer<T2>, typename Slot::iterator, DereferencedPointerHash<T2>, DereferencedPointerEquality<T2>> map2;
+
+		static bool IsExpired(typename Slot::iterator it, time_point now) noexcept
+		{
+			return it->deadline <= now;
+		}
+
+		static std::size_t SlotIndex(std::int64_t tick, std::size_t level) noexcept
+		{
+			return static_cast<std::size_t>(tick >> (slotBits * level)) & (slotsPerLevel - 1);
+		}
+
+		// first tick at which the deadline has passed; ticks are counted by division only, so that deadlines close to
+		// the end of the clock range do not overflow
+		std::int64_t TickOf(time_point deadline) const
+		{
+			if (deadline <= origin)
+				return 0;
+			duration elapsed = deadline - origin;
+			std::int64_t tick = elapsed / resolution;
+			if (elapsed % resolution != duration::zero())
+				++tick;
+			return tick > lastTick ? neverTick : tick;
+		}
+
+		// first tick after the current one at which a slot of some level is cascaded or expired
+		std::int64_t NextBusyTick() const noexcept
+		{
+			std::int64_t next = neverTick;
+			for (std::size_t level = 0; level < levels; ++level)
+			{
+				if (occupied[level] == 0)
+					continue;
+				std::size_t shift = slotBits * level;
+				std::int64_t block = currentTick >> shift;
+				// slots are searched starting with the one that the wheel reaches next
+				std::size_t start = static_cast<std::size_t>(block + 1) & (slotsPerLevel - 1);
+				std::uint64_t bits = occupied[level];
+				if (start != 0)
+					bits = (bits >> start) | (bits << (slotsPerLevel - start));
+				next = (std::min)(next, (block + 1 + LowestBit(bits)) << shift);
+			}
+			if (overflowTick != neverTick)
+			{
+				// the overflow list is distributed only once its earliest keypair fits into the last level
+				std::size_t shift = slotBits * levels;
+				std::int64_t boundary = (std::max)((currentTick >> shift) + 1, overflowTick >> shift) << shift;
+				next = (std::min)(next, boundary);
+			}
+			return next;
+		}
+
+		// index of the lowest set bit of a non-zero value
+		static std::int64_t LowestBit(std::uint64_t bits) noexcept
+		{
+			static constexpr unsigned char positions[64] =
+			{
+				0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+				62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+				63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+				46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+			};
+			assert(bits != 0);
+			return positions[((bits & (~bits + 1)) * 0x03F79D71B4CB0A89ull) >> 58];
+		}
+
+		// set or clear the occupancy bit of a wheel slot; the overflow list has none
+		void UpdateOccupancy(const Slot& slot) noexcept
+		{
+			std::less<const Slot*> before;
+			for (std::size_t level = 0; level < levels; ++level)
+			{
+				const Slot* first = wheel[level].data();
+				if (!before(&slot, first) && before(&slot, first + slotsPerLevel))
+				{
+					std::uint64_t bit = std::uint64_t(1) << (&slot - first);
+					if (slot.empty())
+						occupied[level] &= ~bit;
+					else
+						occupied[level] |= bit;
+					return;
+				}
+			}
+		}
+
+		// slot of the lowest level whose range contains the tick; tick must not precede the current one
+		Slot& SlotFor(std::int64_t tick)
+		{
+			assert(tick >= currentTick);
+			for (std::size_t level = 0; level < levels; ++level)
+			{
+				if ((tick >> (slotBits * level)) - (currentTick >> (slotBits * level)) < std::int64_t(slotsPerLevel))
+					return wheel[level][SlotIndex(tick, level)];
+			}
+			overflowTick = (std::min)(overflowTick, tick);
+			return overflow;
+		}
+
+		// move the entries of a higher level slot to the slots for their deadlines; entries are detached first,
+		// because those from the overflow list may return to it
+		void Cascade(Slot& slot)
+		{
+			Slot pending;
+			pending.splice(pending.end(), slot);
+			UpdateOccupancy(slot);
+			if (&slot == &overflow)
+				overflowTick = neverTick;
+			while (!pending.empty())
+			{
+				auto it = pending.begin();
+				Slot& target = SlotFor((std::max)(TickOf(it->deadline), currentTick));
+				target.splice(target.end(), pending, it);
+				it->slot = &target;
+				UpdateOccupancy(target);
+			}
+		}
+
+		void Reschedule(typename Slot::iterator it, time_point deadline)
+		{
+			it->deadline = deadline;
+			MoveTo(it, SlotFor((std::max)(TickOf(deadline), currentTick + 1)));
+		}
+
+		void MoveTo(typename Slot::iterator it, Slot& slot) noexcept
+		{
+			Slot& source = *it->slot;
+			slot.splice(slot.end(), source, it);
+			it->slot = &slot;
+			UpdateOccupancy(source);
+			UpdateOccupancy(slot);
+		}
+
+		void Erase(typename Slot::iterator it)
+		{
+			map1.erase(&(it->keyPair.first));
+			map2.erase(&(it->keyPair.second));
+			Slot& slot = *it->slot;
+			slot.erase(it);
+			UpdateOccupancy(slot);
+		}
+	};
+
+} // namespace MapSpecial
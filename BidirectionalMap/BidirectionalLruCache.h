@@ -0,0 +1,224 @@
+#pragma once
+
+/*
+Copyright(c) 2017 Julijan Šribar
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software.If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include "BidirectionalMap.h"
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <cassert>
+
+namespace MapSpecial
+{
+
+	// bidirectional map with limited number of keypairs, used as a cache. Keypairs are kept in the item list
+	// ordered from the most to the least recently used one: insertion puts a keypair to the front and
+	// successful lookups move it there in O(1) by splicing the list node. When the capacity is exceeded, keypairs
+	// are evicted from the back of the list.
+	template <typename T1, typename T2>
+	class BidirectionalLruCache : protected BidirectionalMapBase<T1, T2, HashedIndex<T1>, HashedIndex<T2>>
+	{
+		using Base = BidirectionalMapBase<T1, T2, HashedIndex<T1>, HashedIndex<T2>>;
+
+	public:
+		using typename Base::value_type;
+		using typename Base::const_iterator;
+		using typename Base::iterator;
+		// called with the keypair that is about to be evicted because the capacity has been exceeded
+		using EvictionCallback = std::function<void(const T1&, const T2&)>;
+
+		// create an empty cache; if refreshOnAccess is false, lookups do not change the order of keypairs
+		explicit BidirectionalLruCache(size_t capacity, bool refreshOnAccess = true)
+			: capacity(capacity)
+			, refreshOnAccess(refreshOnAccess)
+		{
+			if (capacity == 0)
+				throw std::invalid_argument("Capacity must be greater than zero.");
+			Detail::Reserve(this->map1, capacity + 1, 0);
+			Detail::Reserve(this->map2, capacity + 1, 0);
+		}
+
+		// keypairs are visited from the most to the least recently used one
+		using Base::begin;
+		using Base::end;
+		using Base::cbegin;
+		using Base::cend;
+		using Base::Size;
+		using Base::FirstExists;
+		using Base::SecondExists;
+		using Base::ChangeFirst;
+		using Base::ChangeSecond;
+		using Base::RemoveFirst;
+		using Base::RemoveSecond;
+		using Base::Clear;
+
+		// insert a new keypair as the most recently used one, evicting the least recently used keypair if the
+		// capacity is exceeded. Returns false if the keypair already exists; it becomes the most recently used.
+		template <typename Q, typename R>
+		bool Insert(Q&& first, R&& second)
+		{
+			return InsertKeys(Detail::AsKey<T1>(std::forward<Q>(first)), Detail::AsKey<T2>(std::forward<R>(second)));
+		}
+
+		// get the value assigned to given first key; throws std::out_of_range if the key does not exist
+		const T2& AtFirst(const T1& first)
+		{
+			const T2* second = FindFirst(first);
+			if (second == nullptr)
+				throw std::out_of_range("The first key must exist in the cache.");
+			return *second;
+		}
+
+		// get the value assigned to given second key; throws std::out_of_range if the key does not exist
+		const T1& AtSecond(const T2& second)
+		{
+			const T1* first = FindSecond(second);
+			if (first == nullptr)
+				throw std::out_of_range("The second key must exist in the cache.");
+			return *first;
+		}
+
+		// get pointer to the value assigned to given first key, or nullptr if the key does not exist
+		const T2* FindFirst(const T1& first)
+		{
+			auto itKey1 = this->map1.find(&first);
+			if (itKey1 == this->map1.end())
+			{
+				++misses;
+				return nullptr;
+			}
+			++hits;
+			Refresh(itKey1->second);
+			return &itKey1->second->second;
+		}
+
+		// get pointer to the value assigned to given second key, or nullptr if the key does not exist
+		const T1* FindSecond(const T2& second)
+		{
+			auto itKey2 = this->map2.find(&second);
+			if (itKey2 == this->map2.end())
+			{
+				++misses;
+				return nullptr;
+			}
+			++hits;
+			Refresh(itKey2->second);
+			return &itKey2->second->first;
+		}
+
+		// get maximal number of keypairs in the cache
+		size_t Capacity() const noexcept
+		{
+			return capacity;
+		}
+
+		// change the capacity, evicting least recently used keypairs that do not fit
+		void SetCapacity(size_t newCapacity)
+		{
+			if (newCapacity == 0)
+				throw std::invalid_argument("Capacity must be greater than zero.");
+			capacity = newCapacity;
+			EvictExcess();
+		}
+
+		// set the function called for each evicted keypair; empty function removes the callback
+		void SetEvictionCallback(EvictionCallback callback)
+		{
+			onEviction = std::move(callback);
+		}
+
+		// number of lookups that found the key
+		size_t Hits() const noexcept
+		{
+			return hits;
+		}
+
+		// number of lookups that did not find the key
+		size_t Misses() const noexcept
+		{
+			return misses;
+		}
+
+		// number of keypairs evicted because the capacity has been exceeded
+		size_t Evictions() const noexcept
+		{
+			return evictions;
+		}
+
+		// set hit, miss and eviction counters to zero
+		void ResetCounters() noexcept
+		{
+			hits = 0;
+			misses = 0;
+			evictions = 0;
+		}
+
+	private:
+		size_t capacity;
+		bool refreshOnAccess;
+		EvictionCallback onEviction;
+		size_t hits = 0;
+		size_t misses = 0;
+		size_t evictions = 0;
+
+		// keys are not moved from if the keypair already exists, so the first key can be looked up afterwards
+		template <typename K1, typename K2>
+		bool InsertKeys(K1&& first, K2&& second)
+		{
+			if (!Base::Insert(std::forward<K1>(first), std::forward<K2>(second)))
+			{
+				Refresh(this->map1.find(&first)->second);
+				return false;
+			}
+			EvictExcess();
+			return true;
+		}
+
+		// make the keypair the most recently used one; list iterators stored in the indices remain valid
+		void Refresh(typename Base::Container::iterator itItem) noexcept
+		{
+			if (refreshOnAccess)
+				this->items.splice(this->items.begin(), this->items, itItem);
+		}
+
+		// remove least recently used keypairs until the size does not exceed the capacity
+		void EvictExcess()
+		{
+			while (this->items.size() > capacity)
+			{
+				auto& keyPair = this->items.back();
+				if (onEviction)
+					onEviction(keyPair.first, keyPair.second);
+				this->map1.erase(&keyPair.first);
+				this->map2.erase(&keyPair.second);
+				this->items.pop_back();
+				++evictions;
+			}
+			assert(this->items.size() == this->map1.size());
+			assert(this->items.size() == this->map2.size());
+		}
+	};
+
+} // namespace MapSpecial
@@ -20,15 +20,75 @@ freely, subject to the following restrictions :
 3. This notice may not be removed or altered from any source distribution.
 */
 
+#include "BidirectionalMapFilter.h"
+#include "BidirectionalMapHash.h"
+#include "BidirectionalMapSnapshot.h"
+#include "CuckooHashMap.h"
+#include "OrderStatisticMap.h"
+#include "RadixTreeMap.h"
+
 #include <list>
 #include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <vector>
+#include <stdexcept>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
 
 namespace MapSpecial
 {
 
+	// key of an index, pointing to the key stored in the items list; pointer is mutable so that
+	// the key of a cloned index can be redirected to the cloned item without changing the index structure
+	template<typename T> struct KeyPointer
+	{
+		KeyPointer(const T* pointer) noexcept : pointer(pointer) {}
+		operator const T*() const noexcept { return pointer; }
+
+		mutable const T* pointer;
+	};
+
+	// key together with its hash, computed once and reused by lookups in hashed indices of any number of maps.
+	// THash must be the hash function of those indices; ordered indices use only the key.
+	template<typename T, typename THash = std::hash<T>>
+	class PrehashedKey
+	{
+	public:
+		explicit PrehashedKey(T key) : key(std::move(key)), hash(THash{}(this->key)) {}
+
+		const T& Key() const noexcept { return key; }
+		std::size_t Hash() const noexcept { return hash; }
+
+	private:
+		T key;
+		std::size_t hash;
+	};
+
+	// key of a hashed index that also stores the hash of the key it points to. The hash is computed once when
+	// the key is inserted or looked up, or taken from a PrehashedKey; walking a bucket and rehashing the index
+	// use the stored hashes instead of hashing the keys again, and keys with different hashes are not compared.
+	template<typename T, typename THash> struct HashedKeyPointer
+	{
+		HashedKeyPointer(const T* pointer) noexcept(noexcept(THash{}(*pointer))) : pointer(pointer), hash(THash{}(*pointer)) {}
+		HashedKeyPointer(const PrehashedKey<T, THash>& key) noexcept : pointer(&key.Key()), hash(key.Hash()) {}
+		operator const T*() const noexcept { return pointer; }
+
+		// compute the hash again after the key it points to has changed
+		void Refresh() const noexcept(noexcept(THash{}(*pointer))) { hash = THash{}(*pointer); }
+
+		mutable const T* pointer;
+		mutable std::size_t hash;
+	};
+
 	template<typename T> struct DereferencedPointerComparator
 	{
 		bool operator()(const T* t1, const T* t2) const noexcept { return *t1 < *t2; }
@@ -44,30 +104,421 @@ namespace MapSpecial
 		bool operator()(const T* t1, const T* t2) const noexcept { return *t1 == *t2; }
 	};
 
+	// hashed index of keys of type T, used for a side of a bidirectional map or a column of a container with
+	// several indices. Hashes of keys other than numbers, enumerations and pointers are stored in the index.
+	// Functors are noexcept if the ones they call are, so std::unordered_map does not store hash codes for
+	// cheap hashes once more.
+	template<typename T, typename THash = std::hash<T>, typename TEqual = std::equal_to<T>>
+	struct HashedIndex
+	{
+		using key_type = T;
+		using Key = typename std::conditional<std::is_arithmetic<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value,
+			KeyPointer<T>, HashedKeyPointer<T, THash>>::type;
 
-	template<typename T1, typename T2, template<typename TKey, typename TValue, typename ...Args> class TMap, template<typename T> class ...TMapArgs>
+		struct Hash
+		{
+			std::size_t operator()(const T* t) const noexcept(noexcept(THash{}(*t))) { return THash{}(*t); }
+			std::size_t operator()(const HashedKeyPointer<T, THash>& key) const noexcept { return key.hash; }
+		};
+
+		struct Equality
+		{
+			bool operator()(const T* t1, const T* t2) const noexcept(noexcept(TEqual{}(*t1, *t2))) { return TEqual{}(*t1, *t2); }
+			bool operator()(const HashedKeyPointer<T, THash>& key1, const HashedKeyPointer<T, THash>& key2) const noexcept(noexcept(TEqual{}(*key1.pointer, *key2.pointer)))
+			{
+				return key1.hash == key2.hash && TEqual{}(*key1.pointer, *key2.pointer);
+			}
+		};
+
+		template<typename TValue> using Map = std::unordered_map<Key, TValue, Hash, Equality>;
+	};
+
+	// hashed index with a blocked Bloom filter of its keys in front of it, for sides that are mostly queried for
+	// keys that do not exist. Removed keys stay in the filter until it is rebuilt; the map provides statistics
+	// of the filter and methods to rebuild it.
+	template<typename T, typename THash = std::hash<T>, typename TEqual = std::equal_to<T>>
+	struct FilteredIndex
+	{
+		using key_type = T;
+
+		template<typename TValue> using Map = Detail::FilteredMap<typename HashedIndex<T, THash, TEqual>::template Map<TValue>>;
+	};
+
+	// hashed index in a cuckoo hash table, for sides that need bounded lookup time also for skewed or adversarial
+	// keys: a lookup inspects two buckets of four slots and the stash, which holds only keys that could not be
+	// placed. Keys and hashes are stored as in HashedIndex; inserts are slower than in HashedIndex.
+	template<typename T, typename THash = std::hash<T>, typename TEqual = std::equal_to<T>>
+	struct CuckooIndex
+	{
+		using key_type = T;
+
+		template<typename TValue> using Map = CuckooHashMap<typename HashedIndex<T, THash, TEqual>::Key, TValue,
+			typename HashedIndex<T, THash, TEqual>::Hash, typename HashedIndex<T, THash, TEqual>::Equality>;
+	};
+
+	// ordered index of keys of type T
+	template<typename T, typename TLess = std::less<T>>
+	struct OrderedIndex
+	{
+		using key_type = T;
+
+		struct Comparator
+		{
+			bool operator()(const T* t1, const T* t2) const noexcept(noexcept(TLess{}(*t1, *t2))) { return TLess{}(*t1, *t2); }
+		};
+
+		template<typename TValue> using Map = std::map<KeyPointer<T>, TValue, Comparator>;
+	};
+
+	// ordered index of keys of type T which also finds the position of keys in sorted order
+	template<typename T, typename TLess = std::less<T>>
+	struct RankedIndex
+	{
+		using key_type = T;
+		using Comparator = typename OrderedIndex<T, TLess>::Comparator;
+
+		template<typename TValue> using Map = OrderStatisticMap<KeyPointer<T>, TValue, Comparator>;
+	};
+
+	// ordered index of string keys in an adaptive radix tree; lookups take time proportional to the length of the
+	// key instead of comparing it with a logarithmic number of other keys, and keys that start with a prefix are
+	// found by PrefixFirst and PrefixSecond. Keys are ordered as by std::less; T must convert to std::string_view.
+	template<typename T = std::string>
+	struct RadixTreeIndex
+	{
+		using key_type = T;
+
+		struct Bytes
+		{
+			std::string_view operator()(const T* key) const noexcept { return std::string_view(*key); }
+		};
+
+		template<typename TValue> using Map = RadixTreeMap<KeyPointer<T>, TValue, Bytes>;
+	};
+
+	namespace Detail
+	{
+		// index of a column; plain key types are hashed
+		template<typename T> struct ColumnIndex
+		{
+			using type = HashedIndex<T>;
+		};
+
+		template<typename T, typename THash, typename TEqual> struct ColumnIndex<HashedIndex<T, THash, TEqual>>
+		{
+			using type = HashedIndex<T, THash, TEqual>;
+		};
+
+		template<typename T, typename TLess> struct ColumnIndex<OrderedIndex<T, TLess>>
+		{
+			using type = OrderedIndex<T, TLess>;
+		};
+
+		template<typename T, typename THash, typename TEqual> struct ColumnIndex<FilteredIndex<T, THash, TEqual>>
+		{
+			using type = FilteredIndex<T, THash, TEqual>;
+		};
+
+		template<typename T, typename TLess> struct ColumnIndex<RankedIndex<T, TLess>>
+		{
+			using type = RankedIndex<T, TLess>;
+		};
+
+		template<typename T, typename THash, typename TEqual> struct ColumnIndex<CuckooIndex<T, THash, TEqual>>
+		{
+			using type = CuckooIndex<T, THash, TEqual>;
+		};
+
+		template<typename T> struct ColumnIndex<RadixTreeIndex<T>>
+		{
+			using type = RadixTreeIndex<T>;
+		};
+
+	} // namespace Detail
+
+
+	namespace Detail
+	{
+		// open addressing table that translates addresses of items in one container into iterators of another container
+		template<typename TIterator> class AddressTranslation
+		{
+		public:
+			explicit AddressTranslation(std::size_t count)
+			{
+				while ((std::size_t(1) << bits) < 2 * count)
+					++bits;
+				slots.resize(std::size_t(1) << bits);
+			}
+
+			void Add(const void* from, TIterator to)
+			{
+				std::size_t i = SlotIndex(from);
+				while (slots[i].first != nullptr)
+					i = (i + 1) & (slots.size() - 1);
+				slots[i] = { from, to };
+			}
+
+			TIterator Find(const void* from) const
+			{
+				std::size_t i = SlotIndex(from);
+				while (slots[i].first != from)
+				{
+					assert(slots[i].first != nullptr);
+					i = (i + 1) & (slots.size() - 1);
+				}
+				return slots[i].second;
+			}
+
+		private:
+			unsigned bits = 4;
+			std::vector<std::pair<const void*, TIterator>> slots;
+
+			// Fibonacci hashing of the address
+			std::size_t SlotIndex(const void* address) const noexcept
+			{
+				return static_cast<std::size_t>((static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(address)) * 0x9E3779B97F4A7C15ull) >> (64 - bits));
+			}
+		};
+
+		// reserve space in maps that support it
+		template<typename TMap>
+		auto Reserve(TMap& map, std::size_t count, int) -> decltype(map.reserve(count), void())
+		{
+			map.reserve(count);
+		}
+
+		template<typename TMap>
+		void Reserve(TMap&, std::size_t, long)
+		{
+		}
+
+		// hashed maps keep their elements in buckets, so walking them visits memory in random order
+		template<typename TMap, typename = void>
+		struct IsHashed : std::false_type
+		{
+		};
+
+		template<typename TMap>
+		struct IsHashed<TMap, decltype(std::declval<TMap&>().bucket_count(), void())> : std::true_type
+		{
+		};
+
+		// key for looking up a prehashed key in the index; indices that do not store hashes use only the key
+		template<typename TMap, typename T, typename THash>
+		typename TMap::key_type LookupKey(const PrehashedKey<T, THash>& key)
+		{
+			if constexpr (std::is_constructible<typename TMap::key_type, const PrehashedKey<T, THash>&>::value)
+				return typename TMap::key_type(key);
+			else
+				return typename TMap::key_type(&key.Key());
+		}
+
+		// update the hash stored in an index key after the key it points to has changed
+		template<typename T>
+		void RefreshKey(const KeyPointer<T>&) noexcept
+		{
+		}
+
+		template<typename T, typename THash>
+		void RefreshKey(const HashedKeyPointer<T, THash>& key) noexcept(noexcept(key.Refresh()))
+		{
+			key.Refresh();
+		}
+
+		// check if two keys are equivalent according to the index, without looking them up
+		template<typename TMap, typename T>
+		bool EquivalentKeys(const TMap& map, const T& key1, const T& key2)
+		{
+			if constexpr (IsHashed<TMap>::value)
+				return map.key_eq()(&key1, &key2);
+			else
+				return !map.key_comp()(&key1, &key2) && !map.key_comp()(&key2, &key1);
+		}
+
+		// iterator over keypairs in the order of an index; index entries refer to items through list iterators
+		template<typename TIndexIterator, typename TValue>
+		class IndexOrderIterator
+		{
+		public:
+			using iterator_category = typename std::iterator_traits<TIndexIterator>::iterator_category;
+			using value_type = TValue;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const TValue*;
+			using reference = const TValue&;
+
+			IndexOrderIterator() = default;
+			explicit IndexOrderIterator(TIndexIterator it) : it(it) {}
+
+			reference operator*() const { return *it->second; }
+			pointer operator->() const { return &*it->second; }
+
+			IndexOrderIterator& operator++() { ++it; return *this; }
+			IndexOrderIterator operator++(int) { IndexOrderIterator old(*this); ++it; return old; }
+			IndexOrderIterator& operator--() { --it; return *this; }
+			IndexOrderIterator operator--(int) { IndexOrderIterator old(*this); --it; return old; }
+
+			bool operator==(const IndexOrderIterator& other) const { return it == other.it; }
+			bool operator!=(const IndexOrderIterator& other) const { return it != other.it; }
+
+		private:
+			TIndexIterator it;
+		};
+
+		// pair of iterators usable in range-based for loop
+		template<typename TIterator>
+		class IteratorRange
+		{
+		public:
+			IteratorRange(TIterator first, TIterator last) : first(first), last(last) {}
+
+			TIterator begin() const { return first; }
+			TIterator end() const { return last; }
+			bool empty() const { return first == last; }
+
+		private:
+			TIterator first;
+			TIterator last;
+		};
+
+		// key of the exact key type is passed through as reference, so it can be moved or copied into the map
+		template<typename T, typename U>
+		typename std::enable_if<std::is_same<typename std::decay<U>::type, T>::value, U&&>::type AsKey(U&& key) noexcept
+		{
+			return std::forward<U>(key);
+		}
+
+		// other arguments are converted to the key type once
+		template<typename T, typename U>
+		typename std::enable_if<!std::is_same<typename std::decay<U>::type, T>::value, T>::type AsKey(U&& key)
+		{
+			return T(std::forward<U>(key));
+		}
+
+	} // namespace Detail
+
+
+	// receives all modifications of the bidirectional map it is attached to
+	template<typename T1, typename T2> class BidirectionalMapJournalBase
+	{
+	public:
+		virtual ~BidirectionalMapJournalBase() = default;
+
+		virtual void RecordInsert(const T1& first, const T2& second) = 0;
+		virtual void RecordChangeFirst(const T1& newFirst, const T2& second) = 0;
+		virtual void RecordChangeSecond(const T1& first, const T2& newSecond) = 0;
+		virtual void RecordRemoveFirst(const T1& first) = 0;
+		virtual void RecordRemoveSecond(const T2& second) = 0;
+		virtual void RecordClear() = 0;
+	};
+
+	template<typename T1, typename T2> class BidirectionalMapJournal;
+
+	namespace Detail
+	{
+		template<typename TMap> struct DelimitedLoader;
+	}
+
+
+	// how InsertOrAssign resolves keys that are already paired with other keys
+	enum class ConflictPolicy
+	{
+		// remove existing keypairs that contain one of the keys
+		Overwrite,
+		// leave the map unchanged
+		KeepExisting,
+		// throw std::invalid_argument
+		Fail
+	};
+
+	template<typename T1, typename T2> struct InsertOrAssignResult
+	{
+		// true if the keypair has been inserted or assigned, false if the map has not changed
+		bool changed = false;
+		// keypair that contained the first key and has been removed
+		std::optional<std::pair<T1, T2>> evictedByFirst;
+		// keypair that contained the second key and has been removed
+		std::optional<std::pair<T1, T2>> evictedBySecond;
+	};
+
+	// outcome of inserting a range of keypairs
+	struct InsertRangeResult
+	{
+		// number of keypairs added to the map or, with ConflictPolicy::Overwrite, assigned in the map
+		size_t inserted = 0;
+		// number of keypairs that already existed in the map or appeared earlier in the range
+		size_t duplicates = 0;
+		// zero-based positions of range elements with keys paired differently in the map or earlier in the range
+		std::vector<size_t> conflicts;
+	};
+
+
+	// bidirectional map with keypairs stored in a list and one index per side; each index is given as
+	// HashedIndex, OrderedIndex or RankedIndex of the key type, so the kinds of both sides are independent.
+	// The index of second keys can be dropped by DropSecondIndex; the first method that needs it builds it again,
+	// including const methods, which are then not safe to call concurrently. Second keys inserted while it is
+	// dropped are not checked, so if they turn out not to be unique, every method that needs the index throws
+	// std::invalid_argument and HasSecondIndex() stays false until the duplicate keypairs are removed.
+	template<typename T1, typename T2, typename TIndex1, typename TIndex2>
 	class BidirectionalMapBase
 	{
+		// journal replays its records using unchecked operations
+		friend class BidirectionalMapJournal<T1, T2>;
+		// LoadDelimited in BidirectionalMapDelimited.h adds parsed keypairs directly to items and indices
+		template<typename TMap> friend struct Detail::DelimitedLoader;
+
 	protected:
-		using value_type = std::pair<T1, T2>;
-		using Container = std::list<value_type>;
+		using Container = std::list<std::pair<T1, T2>>;
+		using Map1 = typename TIndex1::template Map<typename Container::iterator>;
+		using Map2 = typename TIndex2::template Map<typename Container::iterator>;
 
 	public:
+		using value_type = std::pair<T1, T2>;
+		// keypairs are visited in unspecified order and cannot be modified through iterators
+		using const_iterator = typename Container::const_iterator;
+		using iterator = const_iterator;
+
+		// keypair detached from the map together with its index nodes; it can be inserted into another
+		// map of the same type without allocating or copying keys
+		class NodeHandle
+		{
+		public:
+			NodeHandle() = default;
+			NodeHandle(NodeHandle&&) = default;
+			NodeHandle& operator=(NodeHandle&&) = default;
+
+			bool Empty() const noexcept { return item.empty(); }
+			const T1& First() const { return item.front().first; }
+			const T2& Second() const { return item.front().second; }
+
+		private:
+			friend class BidirectionalMapBase;
+
+			Container item;
+			typename Map1::node_type node1;
+			typename Map2::node_type node2;
+		};
+
 		BidirectionalMapBase() = default;
 
-		// copy constructor
+		// copy constructor clones both maps without comparing or reinserting keys
 		BidirectionalMapBase(const BidirectionalMapBase& other)
 			: items(other.items)
+			, map1(other.map1)
+			, map2(other.map2)
+			, secondIndexed(other.secondIndexed)
 		{
-			BuildMaps();
+			RedirectMaps(other);
 		}
 
-		// move constructor
+		// move constructor takes over the journal attached to the other map
 		BidirectionalMapBase(BidirectionalMapBase&& other)
 			: items(std::move(other.items))
 			, map1(std::move(other.map1))
 			, map2(std::move(other.map2))
+			, secondIndexed(other.secondIndexed)
+			, journal(other.journal)
 		{
+			other.journal = nullptr;
 		}
 
 		// initializer list constructor
@@ -82,62 +533,277 @@ namespace MapSpecial
 		// copy assignment
 		BidirectionalMapBase& operator=(const BidirectionalMapBase& other)
 		{
-			items = items.other;
-			BuildMaps();
+			if (this != &other)
+				*this = BidirectionalMapBase(other);
 			return *this;
 		}
 
-		// move assignment
+		// move assignment; attached journal records the new content
 		BidirectionalMapBase& operator=(BidirectionalMapBase&& other)
 		{
+			if (journal != nullptr)
+				RecordContent(other.items);
 			items = std::move(other.items);
 			map1 = std::move(other.map1);
 			map2 = std::move(other.map2);
+			secondIndexed = other.secondIndexed;
 			return *this;
 		}
 
-		// insert a new keypair
+		// attach the journal that records all subsequent modifications; nullptr detaches current journal
+		void AttachJournal(BidirectionalMapJournalBase<T1, T2>* newJournal) noexcept
+		{
+			journal = newJournal;
+		}
+
+		// insert a new keypair; arguments of key types are forwarded into the map, other arguments are
+		// converted to key types only once
 		template <typename Q, typename R>
-		bool Insert(Q first, R second)
+		bool Insert(Q&& first, R&& second)
 		{
-			assert(items.size() == map1.size());
-			assert(items.size() == map2.size());
-			if (FirstExists(first))
-			{
-				// do not perform insertion if provided keypair already exists
-				if (PairExists(first, second))
-					return false;
-				throw std::invalid_argument("First key already exists in the map.");
-			}
-			if (SecondExists(second))
-				throw std::invalid_argument("Second key already exists in the map.");
+			return InsertKeys(Detail::AsKey<T1>(std::forward<Q>(first)), Detail::AsKey<T2>(std::forward<R>(second)));
+		}
 
-			items.emplace_front(std::forward<Q>(first), std::forward<R>(second));
+		// insert a new keypair constructed in place from the tuples of constructor arguments
+		template <typename ...Args1, typename ...Args2>
+		bool Emplace(std::piecewise_construct_t, std::tuple<Args1...> args1, std::tuple<Args2...> args2)
+		{
+			items.emplace_front(std::piecewise_construct, std::move(args1), std::move(args2));
 			auto it = items.begin();
-			map1.emplace(&(it->first), it);
-			map2.emplace(&(it->second), it);
+			try
+			{
+				if (FirstExists(it->first))
+				{
+					// do not perform insertion if provided keypair already exists
+					if (PairExists(it->first, it->second))
+					{
+						items.pop_front();
+						return false;
+					}
+					throw std::invalid_argument("First key already exists in the map.");
+				}
+				if (secondIndexed && SecondExists(it->second))
+					throw std::invalid_argument("Second key already exists in the map.");
+				if (journal != nullptr)
+					journal->RecordInsert(it->first, it->second);
+				map1.emplace(&(it->first), it);
+				try
+				{
+					if (secondIndexed)
+						map2.emplace(&(it->second), it);
+				}
+				catch (...)
+				{
+					map1.erase(&(it->first));
+					throw;
+				}
+			}
+			catch (...)
+			{
+				items.pop_front();
+				throw;
+			}
 
 			assert(items.size() == map1.size());
-			assert(items.size() == map2.size());
+			assert(!secondIndexed || items.size() == map2.size());
 			return true;
 		}
 
 		// change the first key paired to existing second key
 		template <typename Q, typename R>
-		bool ChangeFirst(Q first, R second)
+		bool ChangeFirst(Q&& first, R&& second)
 		{
-			if (!SecondExists(second))
-				throw std::out_of_range("The second key must exist in the map.");
-			return ChangeFirstKey(std::forward<Q>(first), std::forward<R>(second));
+			return ChangeFirstKey(Detail::AsKey<T1>(std::forward<Q>(first)), Detail::AsKey<T2>(std::forward<R>(second)));
 		}
 
 		// change the second key paired to existing first key
 		template <typename Q, typename R>
-		bool ChangeSecond(Q first, R second)
+		bool ChangeSecond(Q&& first, R&& second)
 		{
-			if (!FirstExists(first))
-				throw std::out_of_range("The first key must exist in the map.");
-			return ChangeSecondKey(std::forward<Q>(first), std::forward<R>(second));
+			return ChangeSecondKey(Detail::AsKey<T1>(std::forward<Q>(first)), Detail::AsKey<T2>(std::forward<R>(second)));
+		}
+
+		// make the keys paired, resolving conflicts with existing keypairs according to the policy; each key is
+		// looked up once and storage of a displaced keypair is reused for the new one
+		template <typename Q, typename R>
+		InsertOrAssignResult<T1, T2> InsertOrAssign(Q&& first, R&& second, ConflictPolicy policy = ConflictPolicy::Overwrite)
+		{
+			return AssignKeys(Detail::AsKey<T1>(std::forward<Q>(first)), Detail::AsKey<T2>(std::forward<R>(second)), policy);
+		}
+
+		// insert keypairs from the range after a single reservation of both indices. With ConflictPolicy::Fail
+		// nothing is inserted if any element conflicts, with ConflictPolicy::KeepExisting conflicting elements are
+		// skipped; in both cases an exception leaves the map unchanged, except that keypairs recorded in the attached
+		// journal before a failed record remain inserted. ConflictPolicy::Overwrite assigns the elements one by one
+		// as InsertOrAssign does. Without the index of second keys, only first keys are checked.
+		template <typename TIterator>
+		InsertRangeResult InsertRange(TIterator first, TIterator last, ConflictPolicy policy = ConflictPolicy::Fail)
+		{
+			InsertRangeResult result;
+			// keypairs are converted before any change, so an exception leaves the map intact
+			Container batch;
+			for (; first != last; ++first)
+			{
+				const auto& keyPair = *first;
+				batch.emplace_back(keyPair.first, keyPair.second);
+			}
+			if (policy == ConflictPolicy::Overwrite)
+			{
+				BuildSecondIndex();
+				Detail::Reserve(map1, items.size() + batch.size(), 0);
+				Detail::Reserve(map2, items.size() + batch.size(), 0);
+				size_t position = 0;
+				for (auto& keyPair : batch)
+				{
+					auto assigned = AssignKeys(std::move(keyPair.first), std::move(keyPair.second), policy);
+					if (assigned.evictedByFirst || assigned.evictedBySecond)
+						result.conflicts.push_back(position);
+					if (assigned.changed)
+						++result.inserted;
+					else
+						++result.duplicates;
+					++position;
+				}
+				return result;
+			}
+
+			// keypairs are added to the indices without lookups and the same emplacements detect conflicts with the map
+			// and within the range; if the batch is rejected or an exception is thrown, the entries are removed again
+			Detail::Reserve(map1, items.size() + batch.size(), 0);
+			if (secondIndexed)
+				Detail::Reserve(map2, items.size() + batch.size(), 0);
+			auto it = batch.begin();
+			try
+			{
+				for (size_t position = 0; it != batch.end(); ++position)
+				{
+					bool duplicate = false;
+					bool conflict = false;
+					auto inserted1 = map1.emplace(&(it->first), it);
+					if (!inserted1.second)
+					{
+						duplicate = Detail::EquivalentKeys(map2, inserted1.first->second->second, it->second);
+						conflict = !duplicate;
+					}
+					else if (secondIndexed && !map2.emplace(&(it->second), it).second)
+					{
+						map1.erase(inserted1.first);
+						conflict = true;
+					}
+					if (duplicate)
+						++result.duplicates;
+					if (conflict)
+						result.conflicts.push_back(position);
+					it = duplicate || conflict ? batch.erase(it) : std::next(it);
+				}
+			}
+			catch (...)
+			{
+				RemoveBatchEntries(batch.begin(), it == batch.end() ? it : std::next(it));
+				throw;
+			}
+			if (policy == ConflictPolicy::Fail && !result.conflicts.empty())
+			{
+				RemoveBatchEntries(batch.begin(), batch.end());
+				return result;
+			}
+
+			if (journal != nullptr)
+			{
+				auto itRecorded = batch.begin();
+				try
+				{
+					for (; itRecorded != batch.end(); ++itRecorded)
+						journal->RecordInsert(itRecorded->first, itRecorded->second);
+				}
+				catch (...)
+				{
+					// keypairs that have been recorded are inserted, so that the map matches the journal
+					RemoveBatchEntries(itRecorded, batch.end());
+					items.splice(items.begin(), batch, batch.begin(), itRecorded);
+					throw;
+				}
+			}
+			result.inserted = batch.size();
+			// iterators stored in the indices remain valid after splicing
+			items.splice(items.begin(), batch);
+
+			assert(items.size() == map1.size());
+			assert(!secondIndexed || items.size() == map2.size());
+			return result;
+		}
+
+		// replace every first key with the result of fn(first). The index of first keys is built anew in one pass
+		// and swapped in only if all new keys are unique; otherwise std::invalid_argument is thrown and the map
+		// remains unchanged. The index of second keys is not touched.
+		template <typename F>
+		void RemapFirst(F fn)
+		{
+			std::vector<T1> newKeys;
+			newKeys.reserve(items.size());
+			for (const auto& item : items)
+				newKeys.emplace_back(fn(item.first));
+			Map1 newMap1;
+			Detail::Reserve(newMap1, items.size(), 0);
+			auto itKey = newKeys.begin();
+			for (auto itItem = items.begin(); itItem != items.end(); ++itItem, ++itKey)
+			{
+				if (!newMap1.emplace(&*itKey, itItem).second)
+					throw std::invalid_argument("Remapped first keys must be unique.");
+			}
+			if (journal != nullptr)
+			{
+				journal->RecordClear();
+				auto itNewKey = newKeys.crbegin();
+				for (auto it = items.crbegin(); it != items.crend(); ++it, ++itNewKey)
+					journal->RecordInsert(*itNewKey, it->second);
+			}
+			// keys are valid, so they are exchanged with the keys in items and index is redirected to items
+			itKey = newKeys.begin();
+			for (auto& item : items)
+			{
+				using std::swap;
+				swap(item.first, *itKey++);
+			}
+			for (auto& entry : newMap1)
+				entry.first.pointer = &entry.second->first;
+			map1.swap(newMap1);
+		}
+
+		// replace every second key with the result of fn(second) in the same way as in RemapFirst; a dropped index
+		// of second keys is built in the process
+		template <typename F>
+		void RemapSecond(F fn)
+		{
+			std::vector<T2> newKeys;
+			newKeys.reserve(items.size());
+			for (const auto& item : items)
+				newKeys.emplace_back(fn(item.second));
+			Map2 newMap2;
+			Detail::Reserve(newMap2, items.size(), 0);
+			auto itKey = newKeys.begin();
+			for (auto itItem = items.begin(); itItem != items.end(); ++itItem, ++itKey)
+			{
+				if (!newMap2.emplace(&*itKey, itItem).second)
+					throw std::invalid_argument("Remapped second keys must be unique.");
+			}
+			if (journal != nullptr)
+			{
+				journal->RecordClear();
+				auto itNewKey = newKeys.crbegin();
+				for (auto it = items.crbegin(); it != items.crend(); ++it, ++itNewKey)
+					journal->RecordInsert(it->first, *itNewKey);
+			}
+			itKey = newKeys.begin();
+			for (auto& item : items)
+			{
+				using std::swap;
+				swap(item.second, *itKey++);
+			}
+			for (auto& entry : newMap2)
+				entry.first.pointer = &entry.second->second;
+			map2.swap(newMap2);
+			secondIndexed = true;
 		}
 
 		// remove a keypair which has given first key 
@@ -146,27 +812,169 @@ namespace MapSpecial
 			auto itKey1 = map1.find(&first);
 			if (itKey1 == map1.end())
 				throw std::out_of_range("The first key must exist in the map.");
-			auto itItem = itKey1->second;
-			map2.erase(&(itItem->second));
-			map1.erase(itKey1);
-			items.erase(itItem);
+			EraseByFirst(itKey1);
+		}
+
+		// remove a keypair which has given prehashed first key
+		template<typename THash>
+		void RemoveFirst(const PrehashedKey<T1, THash>& first)
+		{
+			auto itKey1 = map1.find(Detail::LookupKey<Map1>(first));
+			if (itKey1 == map1.end())
+				throw std::out_of_range("The first key must exist in the map.");
+			EraseByFirst(itKey1);
+		}
+
+		// remove a keypair which has given second key 
+		void RemoveSecond(const T2& second)
+		{
+			BuildSecondIndex();
+			auto itKey2 = map2.find(&second);
+			if (itKey2 == map2.end())
+				throw std::out_of_range("The first key must exist in the map.");
+			EraseBySecond(itKey2);
+		}
+
+		// remove a keypair which has given prehashed second key
+		template<typename THash>
+		void RemoveSecond(const PrehashedKey<T2, THash>& second)
+		{
+			BuildSecondIndex();
+			auto itKey2 = map2.find(Detail::LookupKey<Map2>(second));
+			if (itKey2 == map2.end())
+				throw std::out_of_range("The second key must exist in the map.");
+			EraseBySecond(itKey2);
+		}
+
+		// remove all keypairs for which predicate(keypair) returns true; returns the number of removed keypairs.
+		// Index of first keys is walked once and its nodes are erased by position, so first keys are never hashed
+		// or compared again. Second keys are not linked to their index nodes, so each removed second key is still
+		// looked up once.
+		template <typename F>
+		size_t EraseIf(F predicate)
+		{
+			size_t count = 0;
+			for (auto itKey1 = map1.begin(); itKey1 != map1.end(); )
+			{
+				if (predicate(static_cast<const value_type&>(*itKey1->second)))
+				{
+					itKey1 = EraseByFirst(itKey1);
+					++count;
+				}
+				else
+					++itKey1;
+			}
+			return count;
+		}
+
+		// remove keypairs with first keys from the range; keys that do not exist are skipped. Returns the number
+		// of removed keypairs.
+		template <typename TRange>
+		size_t RemoveFirstRange(const TRange& keys)
+		{
+			size_t count = 0;
+			for (const auto& key : keys)
+			{
+				const T1& first = key;
+				auto itKey1 = map1.find(&first);
+				if (itKey1 != map1.end())
+				{
+					EraseByFirst(itKey1);
+					++count;
+				}
+			}
+			return count;
+		}
+
+		// remove keypairs with second keys from the range; keys that do not exist are skipped. Returns the number
+		// of removed keypairs.
+		template <typename TRange>
+		size_t RemoveSecondRange(const TRange& keys)
+		{
+			BuildSecondIndex();
+			size_t count = 0;
+			for (const auto& key : keys)
+			{
+				const T2& second = key;
+				auto itKey2 = map2.find(&second);
+				if (itKey2 != map2.end())
+				{
+					EraseBySecond(itKey2);
+					++count;
+				}
+			}
+			return count;
+		}
+
+		// detach a keypair which has given first key
+		NodeHandle ExtractFirst(const T1& first)
+		{
+			auto itKey1 = map1.find(&first);
+			if (itKey1 == map1.end())
+				throw std::out_of_range("The first key must exist in the map.");
+			return Extract(itKey1->second);
 		}
 
-		// remove a keypair which has given second key 
-		void RemoveSecond(const T2& second)
-		{
-			auto itKey2 = map2.find(&second);
-			if (itKey2 == map2.end())
-				throw std::out_of_range("The first key must exist in the map.");
-			auto itItem = itKey2->second;
-			map1.erase(&(itItem->first));
-			map2.erase(itKey2);
-			items.erase(itItem);
+		// detach a keypair which has given second key
+		NodeHandle ExtractSecond(const T2& second)
+		{
+			BuildSecondIndex();
+			auto itKey2 = map2.find(&second);
+			if (itKey2 == map2.end())
+				throw std::out_of_range("The second key must exist in the map.");
+			return Extract(itKey2->second);
+		}
+
+		// insert a detached keypair; returns false if it already exists or node is empty. If insertion fails,
+		// the keypair remains in the node.
+		bool Insert(NodeHandle&& node)
+		{
+			if (node.Empty())
+				return false;
+			const T1& first = node.First();
+			const T2& second = node.Second();
+			if (FirstExists(first))
+			{
+				if (PairExists(first, second))
+					return false;
+				throw std::invalid_argument("First key already exists in the map.");
+			}
+			if (secondIndexed && SecondExists(second))
+				throw std::invalid_argument("Second key already exists in the map.");
+			if (journal != nullptr)
+				journal->RecordInsert(first, second);
+
+			// iterators to the spliced list node, stored in index nodes, remain valid
+			items.splice(items.begin(), node.item);
+			bool inserted1 = false;
+			try
+			{
+				map1.insert(std::move(node.node1));
+				inserted1 = true;
+				if (secondIndexed && node.node2.empty())
+					map2.emplace(&(items.front().second), items.begin());
+				else if (secondIndexed)
+					map2.insert(std::move(node.node2));
+			}
+			catch (...)
+			{
+				// move index node and keypair back into the node
+				if (inserted1)
+					node.node1 = map1.extract(&(items.front().first));
+				node.item.splice(node.item.begin(), items, items.begin());
+				throw;
+			}
+			// node extracted from a map without the index of second keys has no second index node
+			if (!secondIndexed)
+				node.node2 = typename Map2::node_type();
+			return true;
 		}
 
-		// clear the map
-		void Clear() noexcept
+		// clear the map; throws only if the attached journal cannot record it
+		void Clear()
 		{
+			if (journal != nullptr)
+				journal->RecordClear();
 			items.clear();
 			map1.clear();
 			map2.clear();
@@ -180,39 +988,158 @@ namespace MapSpecial
 		size_t Size() const noexcept
 		{
 			assert(items.size() == map1.size());
-			assert(items.size() == map2.size());
+			assert(!secondIndexed || items.size() == map2.size());
 
 			return items.size();
 		}
 
+		const_iterator begin() const noexcept { return items.cbegin(); }
+		const_iterator end() const noexcept { return items.cend(); }
+		const_iterator cbegin() const noexcept { return items.cbegin(); }
+		const_iterator cend() const noexcept { return items.cend(); }
+
 		// check if first key exists in the map
 		bool FirstExists(const T1& first) const noexcept
 		{
 			return map1.find(&first) != map1.cend();
 		}
 
-		// check if second key exists in the map
-		bool SecondExists(const T2& second) const noexcept
+		// check if second key exists in the map; throws only if the dropped index of second keys cannot be built
+		bool SecondExists(const T2& second) const
 		{
-			return map2.find(&second) != map2.cend();
+			BuildSecondIndex();
+			return map2.find(&second) != map2.end();
 		}
 
 		// get the value assigned to given first key
 		const T2& AtFirst(const T1& first) const
 		{
 			assert(items.size() == map1.size());
-			assert(items.size() == map2.size());
+			assert(!secondIndexed || items.size() == map2.size());
 			return map1.at(&first)->second;
 		}
 
 		// get the value assigned to given second key
 		const T1& AtSecond(const T2& second) const
 		{
+			BuildSecondIndex();
 			assert(items.size() == map1.size());
 			assert(items.size() == map2.size());
 			return map2.at(&second)->first;
 		}
 
+		// check if first key exists in the map; hashed index uses the hash carried by the key
+		template<typename THash>
+		bool FirstExists(const PrehashedKey<T1, THash>& first) const
+		{
+			return map1.find(Detail::LookupKey<Map1>(first)) != map1.cend();
+		}
+
+		// check if second key exists in the map; hashed index uses the hash carried by the key
+		template<typename THash>
+		bool SecondExists(const PrehashedKey<T2, THash>& second) const
+		{
+			BuildSecondIndex();
+			return map2.find(Detail::LookupKey<Map2>(second)) != map2.cend();
+		}
+
+		// get the value assigned to given prehashed first key
+		template<typename THash>
+		const T2& AtFirst(const PrehashedKey<T1, THash>& first) const
+		{
+			return map1.at(Detail::LookupKey<Map1>(first))->second;
+		}
+
+		// get the value assigned to given prehashed second key
+		template<typename THash>
+		const T1& AtSecond(const PrehashedKey<T2, THash>& second) const
+		{
+			BuildSecondIndex();
+			return map2.at(Detail::LookupKey<Map2>(second))->first;
+		}
+
+		// write all keypairs into a snapshot file that can be memory-mapped by BidirectionalMapView
+		void SaveSnapshot(const std::string& path) const
+		{
+			Snapshot::Write(path, items.cbegin(), items.cend(), items.size());
+		}
+
+		// replace content of the map with keypairs from a snapshot file; keys in the snapshot are known
+		// to be unique so they are inserted without checks. Loading is not recorded in the attached journal.
+		void LoadSnapshot(const std::string& path)
+		{
+			Container loaded;
+			Snapshot::Read<T1, T2>(path, [&loaded](T1&& first, T2&& second) { loaded.emplace_back(std::move(first), std::move(second)); });
+			items.clear();
+			map1.clear();
+			map2.clear();
+			Detail::Reserve(map1, loaded.size(), 0);
+			if (secondIndexed)
+				Detail::Reserve(map2, loaded.size(), 0);
+			items = std::move(loaded);
+			BuildMaps();
+		}
+
+		// release the index of second keys; until it is needed again, insertions maintain only the index of first
+		// keys and do not check if second keys are unique. Calling it on an empty map before bulk loading halves
+		// the cost of the loading when the map is then used mostly for lookups of first keys.
+		void DropSecondIndex()
+		{
+			Map2().swap(map2);
+			secondIndexed = false;
+		}
+
+		// check if the index of second keys is maintained
+		bool HasSecondIndex() const noexcept
+		{
+			return secondIndexed;
+		}
+
+		// build the index of second keys if it has been dropped; all operations that look up or check second keys
+		// call it, after which the index is maintained again. Throws std::invalid_argument and leaves the index
+		// dropped if second keys are not unique. Building it modifies the map, so const methods on the second
+		// side must not be called concurrently while the index is dropped.
+		void BuildSecondIndex() const
+		{
+			if (secondIndexed)
+				return;
+			// entries of the first key index hold the mutable item iterators that the new entries refer to
+			Map2 newMap2;
+			Detail::Reserve(newMap2, items.size(), 0);
+			for (const auto& entry : map1)
+			{
+				if (!newMap2.emplace(&(entry.second->second), entry.second).second)
+					throw std::invalid_argument("Second keys must be unique to build the index.");
+			}
+			map2.swap(newMap2);
+			secondIndexed = true;
+		}
+
+		// statistics of the filter in front of the index of first keys; available if it is a FilteredIndex
+		FilterStatistics FirstFilterStatistics() const noexcept
+		{
+			return map1.Statistics();
+		}
+
+		// statistics of the filter in front of the index of second keys; available if it is a FilteredIndex
+		FilterStatistics SecondFilterStatistics() const noexcept
+		{
+			return map2.Statistics();
+		}
+
+		// build the filter of first keys anew, e.g. after many keypairs have been removed and their keys still
+		// pass the filter; lookup counters start from zero. Available if the index of first keys is a FilteredIndex
+		void RebuildFirstFilter()
+		{
+			map1.RebuildFilter();
+		}
+
+		// build the filter of second keys anew; available if the index of second keys is a FilteredIndex
+		void RebuildSecondFilter()
+		{
+			map2.RebuildFilter();
+		}
+
 		// overloaded methods and operators available only when T1 and T2 are different types
 
 		// get the value assigned to given first key using index operator
@@ -252,30 +1179,255 @@ namespace MapSpecial
 		// check if keypair with given second key exists
 		template <typename Q = T1, typename R = T2>
 		typename std::enable_if<!std::is_same<Q, R>::value, bool>::type
-		Exists(const T2& second) const noexcept
+		Exists(const T2& second) const
 		{
 			return SecondExists(second);
 		}
 
-	private:
+	protected:
 		Container items;
-		TMap<const T1*, typename Container::iterator, TMapArgs<T1>...> map1;
-		TMap<const T2*, typename Container::iterator, TMapArgs<T2>...> map2;
+		Map1 map1;
+		// empty while the index of second keys is dropped
+		mutable Map2 map2;
+		// index of second keys is built on demand by const methods, which also set this flag
+		mutable bool secondIndexed = true;
+
+	private:
+		BidirectionalMapJournalBase<T1, T2>* journal = nullptr;
+
+		// remove the keypair of the first key index entry; returns the following entry
+		typename Map1::iterator EraseByFirst(typename Map1::iterator itKey1)
+		{
+			auto itItem = itKey1->second;
+			if (journal != nullptr)
+				journal->RecordRemoveFirst(itItem->first);
+			if (secondIndexed)
+				map2.erase(&(itItem->second));
+			auto next = map1.erase(itKey1);
+			items.erase(itItem);
+			return next;
+		}
+
+		// remove the keypair of the second key index entry; returns the following entry
+		typename Map2::iterator EraseBySecond(typename Map2::iterator itKey2)
+		{
+			auto itItem = itKey2->second;
+			if (journal != nullptr)
+				journal->RecordRemoveSecond(itItem->second);
+			map1.erase(&(itItem->first));
+			auto next = map2.erase(itKey2);
+			items.erase(itItem);
+			return next;
+		}
+
+		// remove index entries that refer to the batch items in the range [begin, end)
+		void RemoveBatchEntries(typename Container::iterator begin, typename Container::iterator end)
+		{
+			for (auto it = begin; it != end; ++it)
+			{
+				auto itKey1 = map1.find(&(it->first));
+				if (itKey1 != map1.end() && itKey1->second == it)
+					map1.erase(itKey1);
+				if (!secondIndexed)
+					continue;
+				auto itKey2 = map2.find(&(it->second));
+				if (itKey2 != map2.end() && itKey2->second == it)
+					map2.erase(itKey2);
+			}
+		}
+
+		// record the given content as a clear followed by insertion of all keypairs
+		void RecordContent(const Container& content)
+		{
+			journal->RecordClear();
+			for (auto it = content.crbegin(); it != content.crend(); ++it)
+				journal->RecordInsert(it->first, it->second);
+		}
+
+		NodeHandle Extract(typename Container::iterator itItem)
+		{
+			if (journal != nullptr)
+				journal->RecordRemoveFirst(itItem->first);
+			NodeHandle node;
+			node.node1 = map1.extract(&itItem->first);
+			if (secondIndexed)
+				node.node2 = map2.extract(&itItem->second);
+			node.item.splice(node.item.begin(), items, itItem);
+			return node;
+		}
 
 		void BuildMaps()
 		{
 			for (auto it = items.begin(); it != items.end(); ++it)
 			{
+				map1.emplace(&(it->first), it);
+				if (secondIndexed)
+					map2.emplace(&(it->second), it);
+			}
+		}
+
+
+		// maps copied from other map point to its items; redirect them to corresponding items in this map
+		void RedirectMaps(const BidirectionalMapBase& other)
+		{
+			assert(items.size() == other.items.size());
+			Detail::AddressTranslation<typename Container::iterator> translation(items.size());
+			auto itOther = other.items.cbegin();
+			for (auto it = items.begin(); it != items.end(); ++it, ++itOther)
+				translation.Add(&*itOther, it);
+			for (auto& key1 : map1)
+			{
+				key1.second = translation.Find(&*key1.second);
+				key1.first.pointer = &(key1.second->first);
+			}
+			for (auto& key2 : map2)
+			{
+				key2.second = translation.Find(&*key2.second);
+				key2.first.pointer = &(key2.second->second);
+			}
+		}
+
+		template <typename K1, typename K2>
+		bool InsertKeys(K1&& first, K2&& second)
+		{
+			assert(items.size() == map1.size());
+			assert(!secondIndexed || items.size() == map2.size());
+			if (FirstExists(first))
+			{
+				// do not perform insertion if provided keypair already exists
+				if (PairExists(first, second))
+					return false;
+				throw std::invalid_argument("First key already exists in the map.");
+			}
+			if (secondIndexed && SecondExists(second))
+				throw std::invalid_argument("Second key already exists in the map.");
+			if (journal != nullptr)
+				journal->RecordInsert(first, second);
+
+			items.emplace_front(std::forward<K1>(first), std::forward<K2>(second));
+			auto it = items.begin();
+			map1.emplace(&(it->first), it);
+			if (secondIndexed)
+				map2.emplace(&(it->second), it);
+
+			assert(items.size() == map1.size());
+			assert(!secondIndexed || items.size() == map2.size());
+			return true;
+		}
+
+		template <typename K1, typename K2>
+		InsertOrAssignResult<T1, T2> AssignKeys(K1&& first, K2&& second, ConflictPolicy policy)
+		{
+			BuildSecondIndex();
+			InsertOrAssignResult<T1, T2> result;
+			auto it1 = map1.find(&first);
+			auto it2 = map2.find(&second);
+			bool firstExists = it1 != map1.end();
+			bool secondExists = it2 != map2.end();
+			if (!firstExists && !secondExists)
+			{
+				if (journal != nullptr)
+					journal->RecordInsert(first, second);
+				items.emplace_front(std::forward<K1>(first), std::forward<K2>(second));
+				auto it = items.begin();
 				map1.emplace(&(it->first), it);
 				map2.emplace(&(it->second), it);
+				result.changed = true;
+				return result;
+			}
+			// keypair already exists
+			if (firstExists && secondExists && it1->second == it2->second)
+				return result;
+			if (policy == ConflictPolicy::KeepExisting)
+				return result;
+			if (policy == ConflictPolicy::Fail)
+				throw std::invalid_argument(firstExists ? "First key already exists in the map." : "Second key already exists in the map.");
+
+			result.changed = true;
+			if (!secondExists)
+			{
+				// keypair of the first key gets the new second key
+				auto itItem = it1->second;
+				result.evictedByFirst.emplace(*itItem);
+				ReplaceSecondKey(itItem, std::forward<K2>(second));
+				return result;
+			}
+			if (!firstExists)
+			{
+				// keypair of the second key gets the new first key
+				auto itItem = it2->second;
+				result.evictedBySecond.emplace(*itItem);
+				ReplaceFirstKey(itItem, std::forward<K1>(first));
+				return result;
+			}
+			// keypair of the second key is removed and keypair of the first key gets the second key. The key is
+			// copied first, as it may refer to the removed keypair.
+			T2 newSecond(std::forward<K2>(second));
+			auto itItem1 = it1->second;
+			auto itItem2 = it2->second;
+			if (journal != nullptr)
+				journal->RecordRemoveSecond(itItem2->second);
+			map1.erase(&(itItem2->first));
+			map2.erase(it2);
+			result.evictedBySecond.emplace(std::move(*itItem2));
+			items.erase(itItem2);
+			result.evictedByFirst.emplace(*itItem1);
+			ReplaceSecondKey(itItem1, std::move(newSecond));
+			return result;
+		}
+
+		// assign new first key to the item; its index node is detached and reinserted after the key has changed.
+		// The node keeps pointing to the same pair, so no allocation is needed. The new key must not exist in the map.
+		template <typename K1>
+		void ReplaceFirstKey(typename Container::iterator itItem, K1&& first)
+		{
+			if (journal != nullptr)
+				journal->RecordChangeFirst(first, itItem->second);
+			auto node = map1.extract(&itItem->first);
+			try
+			{
+				itItem->first = std::forward<K1>(first);
+			}
+			catch (...)
+			{
+				Detail::RefreshKey(node.key());
+				map1.insert(std::move(node));
+				throw;
+			}
+			Detail::RefreshKey(node.key());
+			map1.insert(std::move(node));
+		}
+
+		// assign new second key to the item in the same way as in ReplaceFirstKey
+		template <typename K2>
+		void ReplaceSecondKey(typename Container::iterator itItem, K2&& second)
+		{
+			if (journal != nullptr)
+				journal->RecordChangeSecond(itItem->first, second);
+			auto node = map2.extract(&itItem->second);
+			try
+			{
+				itItem->second = std::forward<K2>(second);
 			}
+			catch (...)
+			{
+				Detail::RefreshKey(node.key());
+				map2.insert(std::move(node));
+				throw;
+			}
+			Detail::RefreshKey(node.key());
+			map2.insert(std::move(node));
 		}
 
-		bool ChangeFirstKey(T1&& first, T2&& second)
+		template <typename K1>
+		bool ChangeFirstKey(K1&& first, const T2& second)
 		{
-			assert(SecondExists(second));
+			BuildSecondIndex();
+			auto it2 = map2.find(&second);
+			if (it2 == map2.end())
+				throw std::out_of_range("The second key must exist in the map.");
 			auto it1 = map1.find(&first);
-			auto itItem = map2.find(&second)->second;
+			auto itItem = it2->second;
 			// if first key already exists
 			if (it1 != map1.end())
 			{
@@ -284,20 +1436,19 @@ namespace MapSpecial
 					return false;
 				throw std::invalid_argument("First key is already assigned to another second key.");
 			}
-			// current first key must be removed from map1
-			map1.erase(&itItem->first);
-			// change first key in the pair
-			itItem->first = std::forward<T1>(first);
-			// new first key must be created
-			map1.emplace(&(itItem->first), itItem);
+			ReplaceFirstKey(itItem, std::forward<K1>(first));
 			return true;
 		}
 
-		bool ChangeSecondKey(T1&& first, T2&& second)
+		template <typename K2>
+		bool ChangeSecondKey(const T1& first, K2&& second)
 		{
-			assert(FirstExists(first));
+			BuildSecondIndex();
+			auto it1 = map1.find(&first);
+			if (it1 == map1.end())
+				throw std::out_of_range("The first key must exist in the map.");
 			auto it2 = map2.find(&second);
-			auto itItem = map1.find(&first)->second;
+			auto itItem = it1->second;
 			// if second key already exists
 			if (it2 != map2.end())
 			{
@@ -306,40 +1457,268 @@ namespace MapSpecial
 					return false;
 				throw std::invalid_argument("Second key is already assigned to another first key.");
 			}
-			// current second key must be removed from map2
-			map2.erase(&itItem->second);
-			// change second key in the pair
-			itItem->second = std::forward<T2>(second);
-			// new second key must be created
-			map2.emplace(&(itItem->second), itItem);
+			ReplaceSecondKey(itItem, std::forward<K2>(second));
 			return true;
 		}
 
+		// second key of the keypair is compared directly, so the index of second keys is not needed
 		bool PairExists(const T1& first, const T2& second) const noexcept
 		{
 			auto it1 = map1.find(&first);
+			return it1 != map1.end() && Detail::EquivalentKeys(map2, it1->second->second, second);
+		}
+
+		// unchecked operations for replaying modifications that are known to be valid; no uniqueness
+		// checks are made and keys that do not exist are ignored
+
+		template <typename Q, typename R>
+		void InsertUnchecked(Q&& first, R&& second)
+		{
+			items.emplace_front(std::forward<Q>(first), std::forward<R>(second));
+			auto it = items.begin();
+			map1.emplace(&(it->first), it);
+			if (secondIndexed)
+				map2.emplace(&(it->second), it);
+		}
+
+		void ChangeFirstUnchecked(T1&& first, const T2& second)
+		{
+			BuildSecondIndex();
 			auto it2 = map2.find(&second);
-			return it1 != map1.end() && it2 != map2.end() && it1->second == it2->second;
+			if (it2 == map2.end())
+				return;
+			auto itItem = it2->second;
+			auto node = map1.extract(&itItem->first);
+			itItem->first = std::move(first);
+			Detail::RefreshKey(node.key());
+			map1.insert(std::move(node));
+		}
+
+		void ChangeSecondUnchecked(const T1& first, T2&& second)
+		{
+			auto it1 = map1.find(&first);
+			if (it1 == map1.end())
+				return;
+			auto itItem = it1->second;
+			if (!secondIndexed)
+			{
+				itItem->second = std::move(second);
+				return;
+			}
+			auto node = map2.extract(&itItem->second);
+			itItem->second = std::move(second);
+			Detail::RefreshKey(node.key());
+			map2.insert(std::move(node));
+		}
+
+		void RemoveFirstUnchecked(const T1& first)
+		{
+			auto itKey1 = map1.find(&first);
+			if (itKey1 == map1.end())
+				return;
+			auto itItem = itKey1->second;
+			if (secondIndexed)
+				map2.erase(&(itItem->second));
+			map1.erase(itKey1);
+			items.erase(itItem);
+		}
+
+		void RemoveSecondUnchecked(const T2& second)
+		{
+			BuildSecondIndex();
+			auto itKey2 = map2.find(&second);
+			if (itKey2 == map2.end())
+				return;
+			auto itItem = itKey2->second;
+			map1.erase(&(itItem->first));
+			map2.erase(itKey2);
+			items.erase(itItem);
+		}
+
+		void ClearUnchecked() noexcept
+		{
+			items.clear();
+			map1.clear();
+			map2.clear();
 		}
 
 	}; // class BidirectionalMapBase
 
-	// specialization for std::map
-	template <typename T1, typename T2>
-	class BidirectionalMap : public BidirectionalMapBase<T1, T2, std::map, DereferencedPointerComparator>
+	// bidirectional map with ordered indexes, which provides iteration in key order and range queries; with an
+	// index that is hashed, the methods for its side are not available
+	template <typename T1, typename T2, typename TIndex1, typename TIndex2>
+	class BidirectionalOrderedMapBase : public BidirectionalMapBase<T1, T2, TIndex1, TIndex2>
+	{
+		using Base = BidirectionalMapBase<T1, T2, TIndex1, TIndex2>;
+
+	public:
+		// Inherit all constructors from base class
+		using BidirectionalMapBase<T1, T2, TIndex1, TIndex2>::BidirectionalMapBase;
+
+		// iterators and ranges that visit keypairs ordered by first or second key
+		using FirstOrderIterator = Detail::IndexOrderIterator<typename Base::Map1::const_iterator, typename Base::value_type>;
+		using SecondOrderIterator = Detail::IndexOrderIterator<typename Base::Map2::const_iterator, typename Base::value_type>;
+		using FirstRange = Detail::IteratorRange<FirstOrderIterator>;
+		using SecondRange = Detail::IteratorRange<SecondOrderIterator>;
+
+		// all keypairs ordered by first key
+		FirstRange ByFirst() const
+		{
+			return FirstRange(FirstOrderIterator(this->map1.cbegin()), FirstOrderIterator(this->map1.cend()));
+		}
+
+		// all keypairs ordered by second key
+		SecondRange BySecond() const
+		{
+			this->BuildSecondIndex();
+			return SecondRange(SecondOrderIterator(this->map2.cbegin()), SecondOrderIterator(this->map2.cend()));
+		}
+
+		// keypairs with first key not less than given key
+		FirstRange LowerBoundFirst(const T1& first) const
+		{
+			return FirstRange(FirstOrderIterator(this->map1.lower_bound(&first)), FirstOrderIterator(this->map1.cend()));
+		}
+
+		// keypairs with first key greater than given key
+		FirstRange UpperBoundFirst(const T1& first) const
+		{
+			return FirstRange(FirstOrderIterator(this->map1.upper_bound(&first)), FirstOrderIterator(this->map1.cend()));
+		}
+
+		// keypairs with second key not less than given key
+		SecondRange LowerBoundSecond(const T2& second) const
+		{
+			this->BuildSecondIndex();
+			return SecondRange(SecondOrderIterator(this->map2.lower_bound(&second)), SecondOrderIterator(this->map2.cend()));
+		}
+
+		// keypairs with second key greater than given key
+		SecondRange UpperBoundSecond(const T2& second) const
+		{
+			this->BuildSecondIndex();
+			return SecondRange(SecondOrderIterator(this->map2.upper_bound(&second)), SecondOrderIterator(this->map2.cend()));
+		}
+
+		// keypairs with first key in the range [low, high) of the index order
+		FirstRange RangeFirst(const T1& low, const T1& high) const
+		{
+			if (!this->map1.key_comp()(&low, &high))
+				return FirstRange(FirstOrderIterator(this->map1.cend()), FirstOrderIterator(this->map1.cend()));
+			return FirstRange(FirstOrderIterator(this->map1.lower_bound(&low)), FirstOrderIterator(this->map1.lower_bound(&high)));
+		}
+
+		// keypairs with second key in the range [low, high) of the index order
+		SecondRange RangeSecond(const T2& low, const T2& high) const
+		{
+			this->BuildSecondIndex();
+			if (!this->map2.key_comp()(&low, &high))
+				return SecondRange(SecondOrderIterator(this->map2.cend()), SecondOrderIterator(this->map2.cend()));
+			return SecondRange(SecondOrderIterator(this->map2.lower_bound(&low)), SecondOrderIterator(this->map2.lower_bound(&high)));
+		}
+
+		// keypairs with first key that starts with given prefix, ordered by first key; requires RadixTreeIndex
+		FirstRange PrefixFirst(std::string_view prefix) const
+		{
+			auto range = this->map1.prefix_range(prefix);
+			return FirstRange(FirstOrderIterator(range.first), FirstOrderIterator(range.second));
+		}
+
+		// keypairs with second key that starts with given prefix, ordered by second key; requires RadixTreeIndex
+		SecondRange PrefixSecond(std::string_view prefix) const
+		{
+			this->BuildSecondIndex();
+			auto range = this->map2.prefix_range(prefix);
+			return SecondRange(SecondOrderIterator(range.first), SecondOrderIterator(range.second));
+		}
+	};
+
+	// specialization for std::map; keys of each side are ordered by the given comparison
+	template <typename T1, typename T2, typename TLess1 = std::less<T1>, typename TLess2 = std::less<T2>>
+	class BidirectionalMap : public BidirectionalOrderedMapBase<T1, T2, OrderedIndex<T1, TLess1>, OrderedIndex<T2, TLess2>>
+	{
+	public:
+		// Inherit all constructors from base class
+		using BidirectionalOrderedMapBase<T1, T2, OrderedIndex<T1, TLess1>, OrderedIndex<T2, TLess2>>::BidirectionalOrderedMapBase;
+	};
+
+	// specialization for OrderStatisticMap, which additionally finds position of keys in sorted order and keys at given position
+	template <typename T1, typename T2, typename TLess1 = std::less<T1>, typename TLess2 = std::less<T2>>
+	class BidirectionalRankedMap : public BidirectionalOrderedMapBase<T1, T2, RankedIndex<T1, TLess1>, RankedIndex<T2, TLess2>>
+	{
+	public:
+		// Inherit all constructors from base class
+		using BidirectionalOrderedMapBase<T1, T2, RankedIndex<T1, TLess1>, RankedIndex<T2, TLess2>>::BidirectionalOrderedMapBase;
+
+		// number of first keys less than given key
+		size_t RankOfFirst(const T1& first) const
+		{
+			return this->map1.rank(this->map1.lower_bound(&first));
+		}
+
+		// number of second keys less than given key
+		size_t RankOfSecond(const T2& second) const
+		{
+			this->BuildSecondIndex();
+			return this->map2.rank(this->map2.lower_bound(&second));
+		}
+
+		// keypair with the first key at given position in sorted order
+		const std::pair<T1, T2>& SelectFirst(size_t position) const
+		{
+			auto it = this->map1.select(position);
+			if (it == this->map1.cend())
+				throw std::out_of_range("Position must be less than the size of the map.");
+			return *it->second;
+		}
+
+		// keypair with the second key at given position in sorted order
+		const std::pair<T1, T2>& SelectSecond(size_t position) const
+		{
+			this->BuildSecondIndex();
+			auto it = this->map2.select(position);
+			if (it == this->map2.cend())
+				throw std::out_of_range("Position must be less than the size of the map.");
+			return *it->second;
+		}
+
+		// number of first keys in the range [low, high)
+		size_t CountFirst(const T1& low, const T1& high) const
+		{
+			if (!this->map1.key_comp()(&low, &high))
+				return 0;
+			return RankOfFirst(high) - RankOfFirst(low);
+		}
+
+		// number of second keys in the range [low, high)
+		size_t CountSecond(const T2& low, const T2& high) const
+		{
+			this->BuildSecondIndex();
+			if (!this->map2.key_comp()(&low, &high))
+				return 0;
+			return RankOfSecond(high) - RankOfSecond(low);
+		}
+	};
+
+	// specialization for std::unordered_map; keys of each side are hashed and compared by the given functions,
+	// e.g. StringHash or IntegerHash instead of std::hash
+	template <typename T1, typename T2, typename THash1 = std::hash<T1>, typename THash2 = std::hash<T2>,
+		typename TEqual1 = std::equal_to<T1>, typename TEqual2 = std::equal_to<T2>>
+	class BidirectionalUnorderedMap : public BidirectionalMapBase<T1, T2, HashedIndex<T1, THash1, TEqual1>, HashedIndex<T2, THash2, TEqual2>>
 	{
 	public:
 		// Inherit all constructors from base class
-		using BidirectionalMapBase<T1, T2, std::map, DereferencedPointerComparator>::BidirectionalMapBase;
+		using BidirectionalMapBase<T1, T2, HashedIndex<T1, THash1, TEqual1>, HashedIndex<T2, THash2, TEqual2>>::BidirectionalMapBase;
 	};
 
-	// specialization for std::unordered_map
-	template <typename T1, typename T2>
-	class BidirectionalUnorderedMap : public BidirectionalMapBase<T1, T2, std::unordered_map, DereferencedPointerHash, DereferencedPointerEquality>
+	// bidirectional map with index kinds chosen for each side, e.g. HashedIndex for fast lookups of identifiers
+	// and OrderedIndex for range queries on names
+	template <typename T1, typename T2, typename TIndex1, typename TIndex2>
+	class BidirectionalIndexedMap : public BidirectionalOrderedMapBase<T1, T2, TIndex1, TIndex2>
 	{
 	public:
 		// Inherit all constructors from base class
-		using BidirectionalMapBase<T1, T2, std::unordered_map, DereferencedPointerHash, DereferencedPointerEquality>::BidirectionalMapBase;
+		using BidirectionalOrderedMapBase<T1, T2, TIndex1, TIndex2>::BidirectionalOrderedMapBase;
 	};
 
 } // namespace MapSpecial
@@ -0,0 +1,372 @@
+#pragma once
+
+/*
+Copyright(c) 2017 Julijan Šribar
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software.If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "BidirectionalMap.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Parsing of delimited text files with one keypair per line, e.g. "name<TAB>id". The file is memory-mapped
+// and split at line boundaries into chunks that are parsed on separate threads. Each thread collects its
+// keypairs in its own list, so that the lists can be spliced into the bidirectional map without copying.
+
+namespace MapSpecial
+{
+
+	struct DelimitedLoadOptions
+	{
+		// character that separates the first and the second key
+		char delimiter = '\t';
+		// number of parsing threads; 0 uses one thread per hardware thread
+		unsigned threads = 0;
+		// smallest part of the file worth parsing on a separate thread
+		std::size_t minChunkSize = 1024 * 1024;
+		// first line contains column names
+		bool skipHeader = false;
+		// problems beyond this number are counted but not listed in the report
+		std::size_t maxReportedIssues = 1000;
+	};
+
+	enum class DelimitedIssueKind
+	{
+		// line does not consist of exactly two fields or a field cannot be converted to the key type
+		MalformedLine,
+		// first key already exists, paired with a different second key
+		FirstKeyConflict,
+		// second key already exists, paired with a different first key
+		SecondKeyConflict
+	};
+
+	struct DelimitedIssue
+	{
+		// 1-based line number in the file
+		std::size_t line;
+		DelimitedIssueKind kind;
+	};
+
+	// outcome of loading a delimited file; lines with problems are skipped and earlier keypairs take precedence
+	struct DelimitedLoadReport
+	{
+		// number of lines in the file, including empty ones and the header
+		std::size_t lines = 0;
+		// number of keypairs added to the map
+		std::size_t loaded = 0;
+		// number of keypairs that already existed in the map or appeared earlier in the file
+		std::size_t duplicates = 0;
+		std::size_t malformed = 0;
+		std::size_t conflicts = 0;
+		// problems sorted by line number, at most DelimitedLoadOptions::maxReportedIssues of them
+		std::vector<DelimitedIssue> issues;
+	};
+
+	namespace Detail
+	{
+		// convert text of a field to the key type; arithmetic values are parsed without allocation
+		template<typename T>
+		bool ParseField(std::string_view text, T& value)
+		{
+			if constexpr (std::is_same<T, std::string>::value)
+			{
+				value.assign(text.data(), text.size());
+				return true;
+			}
+			else
+			{
+				static_assert(std::is_arithmetic<T>::value, "Only arithmetic types and std::string can be parsed.");
+				const char* end = text.data() + text.size();
+				auto result = std::from_chars(text.data(), end, value);
+				return result.ec == std::errc() && result.ptr == end;
+			}
+		}
+
+		// keypairs parsed from one part of the file
+		template<typename TContainer>
+		struct DelimitedChunk
+		{
+			const char* begin;
+			const char* end;
+			TContainer pairs;
+			// number of lines in the chunk
+			std::size_t lines = 0;
+			// chunk-relative indices of empty and malformed lines, in ascending order
+			std::vector<std::size_t> skipped;
+			std::vector<std::size_t> malformed;
+		};
+
+		template<typename TContainer>
+		void ParseDelimitedChunk(DelimitedChunk<TContainer>& chunk, char delimiter)
+		{
+			using T1 = typename TContainer::value_type::first_type;
+			using T2 = typename TContainer::value_type::second_type;
+
+			const char* position = chunk.begin;
+			while (position < chunk.end)
+			{
+				const char* lineEnd = static_cast<const char*>(std::memchr(position, '\n', chunk.end - position));
+				if (lineEnd == nullptr)
+					lineEnd = chunk.end;
+				std::string_view line(position, lineEnd - position);
+				position = lineEnd + 1;
+				std::size_t lineIndex = chunk.lines++;
+
+				if (!line.empty() && line.back() == '\r')
+					line.remove_suffix(1);
+				if (line.empty())
+				{
+					chunk.skipped.push_back(lineIndex);
+					continue;
+				}
+				std::size_t separator = line.find(delimiter);
+				T1 first{};
+				T2 second{};
+				if (separator == std::string_view::npos
+					|| line.find(delimiter, separator + 1) != std::string_view::npos
+					|| !ParseField(line.substr(0, separator), first)
+					|| !ParseField(line.substr(separator + 1), second))
+				{
+					chunk.skipped.push_back(lineIndex);
+					chunk.malformed.push_back(lineIndex);
+					continue;
+				}
+				chunk.pairs.emplace_back(std::move(first), std::move(second));
+			}
+		}
+
+		// split the text at line boundaries and parse the chunks in parallel
+		template<typename TContainer>
+		std::vector<DelimitedChunk<TContainer>> ParseDelimited(const char* data, std::size_t size, const DelimitedLoadOptions& options)
+		{
+			const char* end = data + size;
+			unsigned threads = options.threads != 0 ? options.threads : (std::max)(1u, std::thread::hardware_concurrency());
+			std::size_t chunkSize = (std::max)(options.minChunkSize, size / threads + 1);
+
+			std::vector<DelimitedChunk<TContainer>> chunks;
+			for (const char* begin = data; begin < end; )
+			{
+				const char* chunkEnd = begin + (std::min)(chunkSize, std::size_t(end - begin));
+				if (chunkEnd < end)
+				{
+					const char* newLine = static_cast<const char*>(std::memchr(chunkEnd, '\n', end - chunkEnd));
+					chunkEnd = newLine != nullptr ? newLine + 1 : end;
+				}
+				chunks.emplace_back();
+				chunks.back().begin = begin;
+				chunks.back().end = chunkEnd;
+				begin = chunkEnd;
+			}
+
+			std::vector<std::thread> workers;
+			std::vector<std::exception_ptr> errors(chunks.size());
+			auto parse = [&chunks, &errors, &options](std::size_t i)
+			{
+				try
+				{
+					ParseDelimitedChunk(chunks[i], options.delimiter);
+				}
+				catch (...)
+				{
+					errors[i] = std::current_exception();
+				}
+			};
+			for (std::size_t i = 1; i < chunks.size(); ++i)
+				workers.emplace_back(parse, i);
+			if (!chunks.empty())
+				parse(0);
+			for (auto& worker : workers)
+				worker.join();
+			for (const auto& error : errors)
+			{
+				if (error)
+					std::rethrow_exception(error);
+			}
+			return chunks;
+		}
+
+		// records a problem in the report
+		inline void ReportIssue(DelimitedLoadReport& report, const DelimitedLoadOptions& options, std::size_t line, DelimitedIssueKind kind)
+		{
+			if (kind == DelimitedIssueKind::MalformedLine)
+				++report.malformed;
+			else
+				++report.conflicts;
+			if (report.issues.size() < options.maxReportedIssues)
+				report.issues.push_back(DelimitedIssue{ line, kind });
+		}
+
+		// loads delimited files into a bidirectional map, of which it is a friend
+		template<typename TMap>
+		struct DelimitedLoader
+		{
+			using Container = typename TMap::Container;
+
+			static DelimitedLoadReport Load(TMap& map, const std::string& path, const DelimitedLoadOptions& options = DelimitedLoadOptions())
+			{
+				DelimitedLoadReport report;
+				MappedFile file(path);
+				const char* data = file.Data();
+				const char* end = data + file.Size();
+				std::size_t line = 1;
+				if (options.skipHeader && data != end)
+				{
+					const char* newLine = static_cast<const char*>(std::memchr(data, '\n', end - data));
+					data = newLine != nullptr ? newLine + 1 : end;
+					++line;
+				}
+				auto chunks = ParseDelimited<Container>(data, end - data, options);
+
+				std::size_t count = map.items.size();
+				for (const auto& chunk : chunks)
+					count += chunk.pairs.size();
+				Reserve(map.map1, count, 0);
+				if (map.secondIndexed)
+					Reserve(map.map2, count, 0);
+				for (auto& chunk : chunks)
+				{
+					MergeChunk(map, chunk, line, options, report);
+					line += chunk.lines;
+				}
+				report.lines = line - 1;
+				return report;
+			}
+
+			// add keypairs of a parsed chunk to maps and splice them into items; firstLine is the line number
+			// of the first line in the chunk
+			static void MergeChunk(TMap& map, DelimitedChunk<Container>& chunk, std::size_t firstLine, const DelimitedLoadOptions& options, DelimitedLoadReport& report)
+			{
+				std::size_t skipped = 0;
+				std::size_t malformed = 0;
+				// advance over skipped lines preceding the keypair with given index, reporting malformed ones
+				auto lineOf = [&](std::size_t pairIndex)
+				{
+					while (skipped < chunk.skipped.size() && chunk.skipped[skipped] <= pairIndex + skipped)
+					{
+						if (malformed < chunk.malformed.size() && chunk.malformed[malformed] == chunk.skipped[skipped])
+							ReportIssue(report, options, firstLine + chunk.malformed[malformed++], DelimitedIssueKind::MalformedLine);
+						++skipped;
+					}
+					return firstLine + pairIndex + skipped;
+				};
+
+				auto it = chunk.pairs.begin();
+				std::size_t pairIndex = 0;
+				try
+				{
+					for (; it != chunk.pairs.end(); ++pairIndex)
+					{
+						std::size_t line = lineOf(pairIndex);
+						auto itNext = std::next(it);
+						auto result1 = map.map1.emplace(&(it->first), it);
+						if (!result1.second)
+						{
+							if (EquivalentKeys(map.map2, result1.first->second->second, it->second))
+								++report.duplicates;
+							else
+								ReportIssue(report, options, line, DelimitedIssueKind::FirstKeyConflict);
+							chunk.pairs.erase(it);
+							it = itNext;
+							continue;
+						}
+						if (map.secondIndexed && !map.map2.emplace(&(it->second), it).second)
+						{
+							map.map1.erase(result1.first);
+							ReportIssue(report, options, line, DelimitedIssueKind::SecondKeyConflict);
+							chunk.pairs.erase(it);
+							it = itNext;
+							continue;
+						}
+						it = itNext;
+					}
+				}
+				catch (...)
+				{
+					// keypairs of this chunk that were added to maps would be left dangling
+					for (auto itAdded = chunk.pairs.begin(); itAdded != it; ++itAdded)
+					{
+						map.map1.erase(&(itAdded->first));
+						if (map.secondIndexed)
+							map.map2.erase(&(itAdded->second));
+					}
+					if (it != chunk.pairs.end())
+					{
+						auto itKey1 = map.map1.find(&(it->first));
+						if (itKey1 != map.map1.end() && itKey1->second == it)
+							map.map1.erase(itKey1);
+					}
+					throw;
+				}
+				// report malformed lines following the last keypair
+				lineOf(pairIndex + chunk.skipped.size());
+				if (map.journal != nullptr)
+					RecordChunk(map, chunk);
+				report.loaded += chunk.pairs.size();
+				map.items.splice(map.items.begin(), chunk.pairs);
+			}
+
+			// record the keypairs of a chunk that have been added to the indices. If recording fails, keypairs recorded
+			// so far are spliced into items and the others are removed from the indices, so that the map matches the journal.
+			static void RecordChunk(TMap& map, DelimitedChunk<Container>& chunk)
+			{
+				auto itRecorded = chunk.pairs.begin();
+				try
+				{
+					for (; itRecorded != chunk.pairs.end(); ++itRecorded)
+						map.journal->RecordInsert(itRecorded->first, itRecorded->second);
+				}
+				catch (...)
+				{
+					for (auto it = itRecorded; it != chunk.pairs.end(); ++it)
+					{
+						map.map1.erase(&(it->first));
+						if (map.secondIndexed)
+							map.map2.erase(&(it->second));
+					}
+					map.items.splice(map.items.begin(), chunk.pairs, chunk.pairs.begin(), itRecorded);
+					chunk.pairs.erase(itRecorded, chunk.pairs.end());
+					throw;
+				}
+			}
+		};
+
+	} // namespace Detail
+
+
+	// add keypairs from a delimited text file to the map, parsed on multiple threads. Lines with problems do not
+	// stop loading; they are skipped and listed in the returned report.
+	template<typename T1, typename T2, typename TIndex1, typename TIndex2>
+	DelimitedLoadReport LoadDelimited(BidirectionalMapBase<T1, T2, TIndex1, TIndex2>& map, const std::string& path,
+		const DelimitedLoadOptions& options = DelimitedLoadOptions())
+	{
+		return Detail::DelimitedLoader<BidirectionalMapBase<T1, T2, TIndex1, TIndex2>>::Load(map, path, options);
+	}
+
+} // namespace MapSpecial
@@ -0,0 +1,347 @@
+#pragma once
+
+/*
+Copyright(c) 2017 Julijan Šribar
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software.If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Blocked Bloom filter placed in front of a hashed index, so that lookups of keys that do not exist usually
+// return without walking a bucket chain and dereferencing the keys in it. All bits of a key are set in one
+// block of 64 bytes, so adding and checking a key touches a single cache line. Lookups of existing keys pay
+// for that cache line and a second hash of the key, so the filter pays off only when most lookups miss.
+
+namespace MapSpecial
+{
+
+	// statistics of a filter in front of an index
+	struct FilterStatistics
+	{
+		// lookups checked against the filter
+		std::size_t lookups = 0;
+		// lookups of missing keys answered by the filter without probing the index
+		std::size_t skipped = 0;
+		// lookups that passed the filter but did not find the key
+		std::size_t falsePositives = 0;
+		// keys removed since the filter was built; their bits remain set until it is rebuilt
+		std::size_t removed = 0;
+		// memory used by the filter
+		std::size_t bytes = 0;
+
+		// share of lookups that did not probe the index
+		double SkipRate() const noexcept { return lookups == 0 ? 0.0 : double(skipped) / double(lookups); }
+	};
+
+	namespace Detail
+	{
+		// counter incremented by lookups, which may run concurrently on a const map; increments are not atomic
+		// read-modify-write operations, so concurrent lookups may lose some of them but do not race
+		class RelaxedCounter
+		{
+		public:
+			RelaxedCounter() = default;
+			RelaxedCounter(const RelaxedCounter& other) noexcept : value(other.Get()) {}
+			RelaxedCounter& operator=(const RelaxedCounter& other) noexcept { value.store(other.Get(), std::memory_order_relaxed); return *this; }
+
+			void Increment() const noexcept { value.store(value.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+			std::size_t Get() const noexcept { return value.load(std::memory_order_relaxed); }
+			void Reset() noexcept { value.store(0, std::memory_order_relaxed); }
+
+		private:
+			mutable std::atomic<std::size_t> value{ 0 };
+		};
+
+		// Bloom filter with 10 bits per key and 6 bits set per key, which lets about 1% of missing keys pass
+		class BlockedBloomFilter
+		{
+		public:
+			// size the filter for the number of keys and clear it
+			void Reset(std::size_t keys)
+			{
+				std::size_t count = 1;
+				while (count * BlockBits < keys * BitsPerKey)
+					count *= 2;
+				blocks.assign(count, Block{});
+				capacity = count * BlockBits / BitsPerKey;
+			}
+
+			// release the memory; an empty filter lets all keys pass
+			void Release() noexcept
+			{
+				std::vector<Block>().swap(blocks);
+				capacity = 0;
+			}
+
+			void Add(std::size_t hash) noexcept
+			{
+				std::uint64_t mixed = Mix(hash);
+				Block& block = blocks[BlockIndex(mixed)];
+				std::uint64_t bits = Mix(mixed);
+				for (unsigned i = 0; i < BitsPerKeyAdded; ++i, bits >>= 9)
+					block.words[(bits >> 6) & 7] |= std::uint64_t(1) << (bits & 63);
+			}
+
+			bool MayContain(std::size_t hash) const noexcept
+			{
+				if (blocks.empty())
+					return true;
+				std::uint64_t mixed = Mix(hash);
+				const Block& block = blocks[BlockIndex(mixed)];
+				std::uint64_t bits = Mix(mixed);
+				for (unsigned i = 0; i < BitsPerKeyAdded; ++i, bits >>= 9)
+				{
+					if ((block.words[(bits >> 6) & 7] & (std::uint64_t(1) << (bits & 63))) == 0)
+						return false;
+				}
+				return true;
+			}
+
+			// number of keys the filter is sized for
+			std::size_t Capacity() const noexcept { return capacity; }
+			std::size_t Bytes() const noexcept { return blocks.size() * sizeof(Block); }
+
+		private:
+			static constexpr std::size_t BlockBits = 512;
+			static constexpr std::size_t BitsPerKey = 10;
+			static constexpr unsigned BitsPerKeyAdded = 6;
+
+			struct alignas(64) Block
+			{
+				std::uint64_t words[8] = {};
+			};
+
+			std::vector<Block> blocks;
+			std::size_t capacity = 0;
+
+			// final mix of MurmurHash3, so that identity hashes of integers spread over blocks and bits
+			static std::uint64_t Mix(std::uint64_t hash) noexcept
+			{
+				hash ^= hash >> 33;
+				hash *= 0xff51afd7ed558ccdull;
+				hash ^= hash >> 33;
+				hash *= 0xc4ceb9fe1a85ec53ull;
+				hash ^= hash >> 33;
+				return hash;
+			}
+
+			// number of blocks is a power of two
+			std::size_t BlockIndex(std::uint64_t mixed) const noexcept
+			{
+				return static_cast<std::size_t>(mixed >> 32) & (blocks.size() - 1);
+			}
+		};
+
+		// hashed map with a Bloom filter of its keys that is checked before each lookup. Keys are added to the
+		// filter when they are inserted; the filter is rebuilt from the keys in the map when it fills up, and
+		// on request to discard the bits of removed keys.
+		template<typename TMap>
+		class FilteredMap : public TMap
+		{
+		public:
+			using typename TMap::key_type;
+			using typename TMap::mapped_type;
+			using typename TMap::size_type;
+			using typename TMap::iterator;
+			using typename TMap::const_iterator;
+			using typename TMap::node_type;
+			using typename TMap::insert_return_type;
+
+			template<typename ...Args>
+			std::pair<iterator, bool> emplace(Args&&... args)
+			{
+				auto result = TMap::emplace(std::forward<Args>(args)...);
+				if (result.second)
+					Added(result.first->first);
+				return result;
+			}
+
+			insert_return_type insert(node_type&& node)
+			{
+				auto result = TMap::insert(std::move(node));
+				if (result.inserted)
+					Added(result.position->first);
+				return result;
+			}
+
+			iterator find(const key_type& key)
+			{
+				if (!Passes(key))
+					return this->end();
+				auto it = TMap::find(key);
+				if (it == this->end())
+					falsePositives.Increment();
+				return it;
+			}
+
+			const_iterator find(const key_type& key) const
+			{
+				if (!Passes(key))
+					return this->cend();
+				auto it = TMap::find(key);
+				if (it == this->cend())
+					falsePositives.Increment();
+				return it;
+			}
+
+			size_type count(const key_type& key) const
+			{
+				return find(key) != this->cend() ? 1 : 0;
+			}
+
+			mapped_type& at(const key_type& key)
+			{
+				auto it = find(key);
+				if (it == this->end())
+					throw std::out_of_range("Key does not exist in the map.");
+				return it->second;
+			}
+
+			const mapped_type& at(const key_type& key) const
+			{
+				auto it = find(key);
+				if (it == this->cend())
+					throw std::out_of_range("Key does not exist in the map.");
+				return it->second;
+			}
+
+			size_type erase(const key_type& key)
+			{
+				size_type erased = TMap::erase(key);
+				removed += erased;
+				return erased;
+			}
+
+			iterator erase(const_iterator position)
+			{
+				++removed;
+				return TMap::erase(position);
+			}
+
+			iterator erase(iterator position)
+			{
+				++removed;
+				return TMap::erase(position);
+			}
+
+			node_type extract(const key_type& key)
+			{
+				auto node = TMap::extract(key);
+				if (!node.empty())
+					++removed;
+				return node;
+			}
+
+			node_type extract(const_iterator position)
+			{
+				++removed;
+				return TMap::extract(position);
+			}
+
+			void clear() noexcept
+			{
+				TMap::clear();
+				filter.Release();
+				added = 0;
+				removed = 0;
+			}
+
+			void swap(FilteredMap& other)
+			{
+				TMap::swap(other);
+				std::swap(filter, other.filter);
+				std::swap(added, other.added);
+				std::swap(removed, other.removed);
+				std::swap(lookups, other.lookups);
+				std::swap(skipped, other.skipped);
+				std::swap(falsePositives, other.falsePositives);
+			}
+
+			// size the filter for the expected number of keys, so that it is not rebuilt while they are inserted
+			void reserve(size_type count)
+			{
+				TMap::reserve(count);
+				if (count > filter.Capacity())
+					RebuildFilter(count);
+			}
+
+			// build the filter anew from the keys in the map and start counting lookups from zero
+			void RebuildFilter()
+			{
+				RebuildFilter(this->size());
+				lookups.Reset();
+				skipped.Reset();
+				falsePositives.Reset();
+			}
+
+			FilterStatistics Statistics() const noexcept
+			{
+				FilterStatistics statistics;
+				statistics.lookups = lookups.Get();
+				statistics.skipped = skipped.Get();
+				statistics.falsePositives = falsePositives.Get();
+				statistics.removed = removed;
+				statistics.bytes = filter.Bytes();
+				return statistics;
+			}
+
+		private:
+			BlockedBloomFilter filter;
+			// keys added to the filter since it was built, including removed ones
+			std::size_t added = 0;
+			std::size_t removed = 0;
+			RelaxedCounter lookups;
+			RelaxedCounter skipped;
+			RelaxedCounter falsePositives;
+
+			bool Passes(const key_type& key) const
+			{
+				lookups.Increment();
+				if (filter.MayContain(this->hash_function()(key)))
+					return true;
+				skipped.Increment();
+				return false;
+			}
+
+			void Added(const key_type& key)
+			{
+				if (++added > filter.Capacity())
+					RebuildFilter(2 * this->size());
+				else
+					filter.Add(this->hash_function()(key));
+			}
+
+			void RebuildFilter(std::size_t capacity)
+			{
+				filter.Reset(capacity);
+				for (const auto& entry : *this)
+					filter.Add(this->hash_function()(entry.first));
+				added = this->size();
+				removed = 0;
+			}
+		};
+
+	} // namespace Detail
+
+} // namespace MapSpecial
@@ -0,0 +1,168 @@
+#pragma once
+
+/*
+Copyright(c) 2017 Julijan Šribar
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software.If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+// Hash functions that can be given to HashedIndex in place of std::hash. Standard library implementations
+// often hash integers to themselves, which makes keys with a common stride fall into few buckets, and hash
+// strings with functions tuned for long inputs. StringHash follows wyhash by Wang Yi, which reads 8 or 16
+// bytes per step and finishes with 64x64->128 bit multiplications; IntegerHash mixes all bits of the value
+// with two such multiplications, as wyhash does for 64-bit values.
+
+namespace MapSpecial
+{
+
+	namespace Detail
+	{
+		constexpr std::uint64_t HashSecret0 = 0xa0761d6478bd642full;
+		constexpr std::uint64_t HashSecret1 = 0xe7037ed1a0b428dbull;
+		constexpr std::uint64_t HashSecret2 = 0x8ebc6af09c88c6e3ull;
+		constexpr std::uint64_t HashSecret3 = 0x589965cc75374cc3ull;
+
+		// 128-bit product of the values; low half is stored in a and high half in b
+		inline void Multiply128(std::uint64_t& a, std::uint64_t& b) noexcept
+		{
+#if defined(__SIZEOF_INT128__)
+			unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+			a = static_cast<std::uint64_t>(product);
+			b = static_cast<std::uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+			a = _umul128(a, b, &b);
+#else
+			std::uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<std::uint32_t>(a), lb = static_cast<std::uint32_t>(b);
+			std::uint64_t hh = ha * hb, hl = ha * lb, lh = la * hb, ll = la * lb;
+			std::uint64_t middle = (ll >> 32) + static_cast<std::uint32_t>(hl) + static_cast<std::uint32_t>(lh);
+			a = (middle << 32) | static_cast<std::uint32_t>(ll);
+			b = hh + (hl >> 32) + (lh >> 32) + (middle >> 32);
+#endif
+		}
+
+		// fold the 128-bit product of the values into 64 bits
+		inline std::uint64_t MultiplyMix(std::uint64_t a, std::uint64_t b) noexcept
+		{
+			Multiply128(a, b);
+			return a ^ b;
+		}
+
+		inline std::uint64_t Read64(const unsigned char* p) noexcept
+		{
+			std::uint64_t value;
+			std::memcpy(&value, p, sizeof(value));
+			return value;
+		}
+
+		inline std::uint64_t Read32(const unsigned char* p) noexcept
+		{
+			std::uint32_t value;
+			std::memcpy(&value, p, sizeof(value));
+			return value;
+		}
+
+		// hash of a byte sequence, following the final version of wyhash
+		inline std::uint64_t HashBytes(const void* data, std::size_t length, std::uint64_t seed = 0) noexcept
+		{
+			const unsigned char* p = static_cast<const unsigned char*>(data);
+			seed ^= MultiplyMix(seed ^ HashSecret0, HashSecret1);
+			std::uint64_t a;
+			std::uint64_t b;
+			if (length <= 16)
+			{
+				if (length >= 4)
+				{
+					std::size_t shift = (length >> 3) << 2;
+					a = (Read32(p) << 32) | Read32(p + shift);
+					b = (Read32(p + length - 4) << 32) | Read32(p + length - 4 - shift);
+				}
+				else if (length > 0)
+				{
+					a = (std::uint64_t(p[0]) << 16) | (std::uint64_t(p[length >> 1]) << 8) | p[length - 1];
+					b = 0;
+				}
+				else
+					a = b = 0;
+			}
+			else
+			{
+				std::size_t i = length;
+				if (i > 48)
+				{
+					std::uint64_t seed1 = seed;
+					std::uint64_t seed2 = seed;
+					do
+					{
+						seed = MultiplyMix(Read64(p) ^ HashSecret1, Read64(p + 8) ^ seed);
+						seed1 = MultiplyMix(Read64(p + 16) ^ HashSecret2, Read64(p + 24) ^ seed1);
+						seed2 = MultiplyMix(Read64(p + 32) ^ HashSecret3, Read64(p + 40) ^ seed2);
+						p += 48;
+						i -= 48;
+					} while (i > 48);
+					seed ^= seed1 ^ seed2;
+				}
+				while (i > 16)
+				{
+					seed = MultiplyMix(Read64(p) ^ HashSecret1, Read64(p + 8) ^ seed);
+					p += 16;
+					i -= 16;
+				}
+				a = Read64(p + i - 16);
+				b = Read64(p + i - 8);
+			}
+			a ^= HashSecret1;
+			b ^= seed;
+			Multiply128(a, b);
+			return MultiplyMix(a ^ HashSecret0 ^ length, b ^ HashSecret1);
+		}
+
+	} // namespace Detail
+
+	// hash of strings and other contiguous character sequences
+	struct StringHash
+	{
+		std::size_t operator()(std::string_view text) const noexcept
+		{
+			return static_cast<std::size_t>(Detail::HashBytes(text.data(), text.size()));
+		}
+	};
+
+	// hash of integers and enumerations that spreads consecutive and strided values over all bits
+	struct IntegerHash
+	{
+		template<typename T, typename = typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type>
+		std::size_t operator()(T value) const noexcept
+		{
+			std::uint64_t a = static_cast<std::uint64_t>(value) ^ Detail::HashSecret0;
+			std::uint64_t b = Detail::HashSecret1;
+			Detail::Multiply128(a, b);
+			return static_cast<std::size_t>(Detail::MultiplyMix(a ^ Detail::HashSecret0, b ^ Detail::HashSecret1));
+		}
+	};
+
+} // namespace MapSpecial
@@ -0,0 +1,543 @@
+#pragma once
+
+/*
+Copyright(c) 2017 Julijan Šribar
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software.If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "BidirectionalMap.h"
+#include "BidirectionalMapSnapshot.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Journal of modifications of a bidirectional map.
+// File layout (values in native byte order):
+//   JournalHeader
+//   records, each consisting of:
+//     uint32_t size      - number of bytes in operation and arguments
+//     uint8_t operation  - JournalOperation
+//     arguments          - arithmetic values as raw bytes, strings as uint32_t length followed by characters
+//     uint32_t checksum  - lower 32 bits of the hash of operation and arguments
+// Replay stops at the first incomplete or damaged record, which is the remainder of an interrupted write.
+
+namespace MapSpecial
+{
+
+	// when the journal forces written records to the storage device
+	enum class JournalSync
+	{
+		// records are passed to the operating system when buffer fills up or on Commit, never synced explicitly
+		Never,
+		// Commit passes records to the operating system and syncs the file
+		OnCommit,
+		// every record is written and synced immediately
+		EveryRecord
+	};
+
+	struct JournalOptions
+	{
+		size_t bufferSize = 64 * 1024;
+		JournalSync sync = JournalSync::OnCommit;
+	};
+
+	namespace Detail
+	{
+		enum class JournalOperation : std::uint8_t
+		{
+			Insert = 1,
+			ChangeFirst,
+			ChangeSecond,
+			RemoveFirst,
+			RemoveSecond,
+			Clear
+		};
+
+		struct JournalHeader
+		{
+			char magic[8];
+			std::uint32_t formatVersion;
+			std::uint32_t byteOrderMark;
+			std::uint32_t firstType;
+			std::uint32_t secondType;
+		};
+
+		constexpr char JournalMagic[8] = { 'B', 'I', 'M', 'A', 'P', 'J', 'N', 'L' };
+		constexpr std::uint32_t JournalFormatVersion = 1;
+
+		// encoding of journal record arguments
+		template<typename T>
+		struct JournalCodec
+		{
+			static void Write(std::vector<char>& buffer, const T& value)
+			{
+				if constexpr (std::is_same<T, std::string>::value)
+				{
+					std::uint32_t length = static_cast<std::uint32_t>(value.size());
+					JournalCodec<std::uint32_t>::Write(buffer, length);
+					buffer.insert(buffer.end(), value.begin(), value.end());
+				}
+				else
+				{
+					static_assert(std::is_arithmetic<T>::value, "Only arithmetic types and std::string can be journaled.");
+					const char* bytes = reinterpret_cast<const char*>(&value);
+					buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+				}
+			}
+
+			// read the value and advance position; returns false if there are not enough data
+			static bool Read(const char*& position, const char* end, T& value)
+			{
+				if constexpr (std::is_same<T, std::string>::value)
+				{
+					std::uint32_t length;
+					if (!JournalCodec<std::uint32_t>::Read(position, end, length) || std::size_t(end - position) < length)
+						return false;
+					value.assign(position, length);
+					position += length;
+					return true;
+				}
+				else
+				{
+					if (std::size_t(end - position) < sizeof(T))
+						return false;
+					std::memcpy(&value, position, sizeof(T));
+					position += sizeof(T);
+					return true;
+				}
+			}
+		};
+
+		// file opened for appending, truncated to the given length
+		class AppendFile
+		{
+		public:
+			AppendFile(const std::string& path, std::uint64_t length)
+			{
+#ifdef _WIN32
+				file = ::CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+				if (file == INVALID_HANDLE_VALUE)
+					throw std::runtime_error("Cannot open journal file.");
+#else
+				file = ::open(path.c_str(), O_WRONLY | O_CREAT, 0644);
+				if (file == -1)
+					throw std::runtime_error("Cannot open journal file.");
+#endif
+				try
+				{
+					Resize(length);
+				}
+				catch (...)
+				{
+#ifdef _WIN32
+					::CloseHandle(file);
+#else
+					::close(file);
+#endif
+					throw;
+				}
+			}
+
+			AppendFile(const AppendFile&) = delete;
+			AppendFile& operator=(const AppendFile&) = delete;
+
+			~AppendFile()
+			{
+#ifdef _WIN32
+				::CloseHandle(file);
+#else
+				::close(file);
+#endif
+			}
+
+			// append the data; if writing fails, Length tells how much of it has been written
+			void Write(const char* data, std::size_t size)
+			{
+				while (size > 0)
+				{
+#ifdef _WIN32
+					DWORD written = 0;
+					DWORD chunk = size > 0x40000000 ? 0x40000000 : static_cast<DWORD>(size);
+					if (!::WriteFile(file, data, chunk, &written, nullptr))
+						throw std::runtime_error("Cannot write journal file.");
+#else
+					auto written = ::write(file, data, size);
+					if (written == -1)
+					{
+						if (errno == EINTR)
+							continue;
+						throw std::runtime_error("Cannot write journal file.");
+					}
+#endif
+					data += written;
+					size -= static_cast<std::size_t>(written);
+					length += static_cast<std::uint64_t>(written);
+				}
+			}
+
+			// truncate the file to the given length and continue appending at its end
+			void Resize(std::uint64_t newLength)
+			{
+#ifdef _WIN32
+				LARGE_INTEGER position;
+				position.QuadPart = static_cast<LONGLONG>(newLength);
+				if (!::SetFilePointerEx(file, position, nullptr, FILE_BEGIN) || !::SetEndOfFile(file))
+					throw std::runtime_error("Cannot truncate journal file.");
+#else
+				if (::ftruncate(file, static_cast<off_t>(newLength)) != 0 || ::lseek(file, 0, SEEK_END) == -1)
+					throw std::runtime_error("Cannot truncate journal file.");
+#endif
+				length = newLength;
+			}
+
+			std::uint64_t Length() const noexcept { return length; }
+
+			void Sync()
+			{
+#ifdef _WIN32
+				if (!::FlushFileBuffers(file))
+					throw std::runtime_error("Cannot sync journal file.");
+#else
+				if (::fsync(file) != 0)
+					throw std::runtime_error("Cannot sync journal file.");
+#endif
+			}
+
+		private:
+#ifdef _WIN32
+			HANDLE file;
+#else
+			int file;
+#endif
+			std::uint64_t length = 0;
+		};
+
+	} // namespace Detail
+
+
+	// journal that appends modifications of a bidirectional map to a file. Records are collected in a buffer
+	// and written in groups, either when the buffer fills up or on Commit. Journal is attached to the map with
+	// AttachJournal; after a crash, the map is recovered by loading the last snapshot and calling Replay.
+	// The map records each modification before performing it. If a record cannot be written or synced, it is
+	// discarded and the exception leaves the map unmodified. An operation that produces several records, such
+	// as a remap, can leave the records written before the failure.
+	template<typename T1, typename T2>
+	class BidirectionalMapJournal : public BidirectionalMapJournalBase<T1, T2>
+	{
+	public:
+		// open existing journal or create a new one; damaged records at the end of existing journal are discarded
+		explicit BidirectionalMapJournal(const std::string& path, JournalOptions options = JournalOptions())
+			: path(path)
+			, options(options)
+		{
+			std::uint64_t validLength = 0;
+			std::vector<char> content = ReadFile(path);
+			if (!content.empty())
+				validLength = Parse(content, [](Detail::JournalOperation, T1&&, T2&&) {});
+			file.reset(new Detail::AppendFile(path, validLength));
+			if (validLength == 0)
+				WriteHeader();
+			buffer.reserve(options.bufferSize);
+		}
+
+		BidirectionalMapJournal(const BidirectionalMapJournal&) = delete;
+		BidirectionalMapJournal& operator=(const BidirectionalMapJournal&) = delete;
+
+		~BidirectionalMapJournal() override
+		{
+			try
+			{
+				Flush();
+			}
+			catch (...)
+			{
+			}
+		}
+
+		// pass buffered records to the operating system; if writing fails, the part that has been written is removed
+		// from the buffer, so that the next attempt continues after it
+		void Flush()
+		{
+			if (buffer.empty())
+				return;
+			std::uint64_t lengthBefore = file->Length();
+			try
+			{
+				file->Write(buffer.data(), buffer.size());
+			}
+			catch (...)
+			{
+				buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(file->Length() - lengthBefore));
+				throw;
+			}
+			buffer.clear();
+		}
+
+		// make all records written so far durable according to the sync policy
+		void Commit()
+		{
+			Flush();
+			if (options.sync != JournalSync::Never)
+				file->Sync();
+		}
+
+		// discard all records, e.g. after a new snapshot of the map has been saved
+		void Truncate()
+		{
+			file->Resize(0);
+			buffer.clear();
+			WriteHeader();
+		}
+
+		// apply records from the journal file to the map, without uniqueness checks; returns number of records applied
+		template<typename TBiMap>
+		static size_t Replay(const std::string& path, TBiMap& map)
+		{
+			std::vector<char> content = ReadFile(path);
+			if (content.empty())
+				return 0;
+			size_t count = 0;
+			Parse(content, [&map, &count](Detail::JournalOperation operation, T1&& first, T2&& second)
+			{
+				switch (operation)
+				{
+				case Detail::JournalOperation::Insert:
+					map.InsertUnchecked(std::move(first), std::move(second));
+					break;
+				case Detail::JournalOperation::ChangeFirst:
+					map.ChangeFirstUnchecked(std::move(first), second);
+					break;
+				case Detail::JournalOperation::ChangeSecond:
+					map.ChangeSecondUnchecked(first, std::move(second));
+					break;
+				case Detail::JournalOperation::RemoveFirst:
+					map.RemoveFirstUnchecked(first);
+					break;
+				case Detail::JournalOperation::RemoveSecond:
+					map.RemoveSecondUnchecked(second);
+					break;
+				case Detail::JournalOperation::Clear:
+					map.ClearUnchecked();
+					break;
+				}
+				++count;
+			});
+			return count;
+		}
+
+		void RecordInsert(const T1& first, const T2& second) override
+		{
+			AppendRecord(Detail::JournalOperation::Insert, [&]()
+			{
+				Detail::JournalCodec<T1>::Write(buffer, first);
+				Detail::JournalCodec<T2>::Write(buffer, second);
+			});
+		}
+
+		void RecordChangeFirst(const T1& newFirst, const T2& second) override
+		{
+			AppendRecord(Detail::JournalOperation::ChangeFirst, [&]()
+			{
+				Detail::JournalCodec<T1>::Write(buffer, newFirst);
+				Detail::JournalCodec<T2>::Write(buffer, second);
+			});
+		}
+
+		void RecordChangeSecond(const T1& first, const T2& newSecond) override
+		{
+			AppendRecord(Detail::JournalOperation::ChangeSecond, [&]()
+			{
+				Detail::JournalCodec<T1>::Write(buffer, first);
+				Detail::JournalCodec<T2>::Write(buffer, newSecond);
+			});
+		}
+
+		void RecordRemoveFirst(const T1& first) override
+		{
+			AppendRecord(Detail::JournalOperation::RemoveFirst, [&]() { Detail::JournalCodec<T1>::Write(buffer, first); });
+		}
+
+		void RecordRemoveSecond(const T2& second) override
+		{
+			AppendRecord(Detail::JournalOperation::RemoveSecond, [&]() { Detail::JournalCodec<T2>::Write(buffer, second); });
+		}
+
+		void RecordClear() override
+		{
+			AppendRecord(Detail::JournalOperation::Clear, []() {});
+		}
+
+	private:
+		std::string path;
+		JournalOptions options;
+		std::unique_ptr<Detail::AppendFile> file;
+		std::vector<char> buffer;
+
+		static std::vector<char> ReadFile(const std::string& path)
+		{
+			std::ifstream stream(path, std::ios::binary);
+			if (!stream)
+				return std::vector<char>();
+			return std::vector<char>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+		}
+
+		static Detail::JournalHeader Header() noexcept
+		{
+			Detail::JournalHeader header{};
+			std::memcpy(header.magic, Detail::JournalMagic, sizeof(Detail::JournalMagic));
+			header.formatVersion = Detail::JournalFormatVersion;
+			header.byteOrderMark = Snapshot::ByteOrderMark;
+			header.firstType = Snapshot::SnapshotTraits<T1>::TypeCode;
+			header.secondType = Snapshot::SnapshotTraits<T2>::TypeCode;
+			return header;
+		}
+
+		void WriteHeader()
+		{
+			Detail::JournalHeader header = Header();
+			file->Write(reinterpret_cast<const char*>(&header), sizeof(header));
+		}
+
+		// parse all valid records, passing them to the callback; returns the length of the valid part of the journal
+		template<typename TCallback>
+		static std::uint64_t Parse(const std::vector<char>& content, TCallback callback)
+		{
+			Detail::JournalHeader expected = Header();
+			if (content.size() < sizeof(expected) || std::memcmp(content.data(), &expected, sizeof(expected)) != 0)
+				throw std::runtime_error("Invalid journal file or key types do not match.");
+
+			const char* position = content.data() + sizeof(expected);
+			const char* end = content.data() + content.size();
+			for (;;)
+			{
+				const char* recordStart = position;
+				std::uint32_t size;
+				std::uint32_t checksum;
+				if (!Detail::JournalCodec<std::uint32_t>::Read(position, end, size) || size == 0 || std::size_t(end - position) < std::size_t(size) + sizeof(checksum))
+					return recordStart - content.data();
+				const char* argumentsEnd = position + size;
+				std::memcpy(&checksum, argumentsEnd, sizeof(checksum));
+				if (checksum != static_cast<std::uint32_t>(Snapshot::Hash(position, size)))
+					return recordStart - content.data();
+
+				auto operation = static_cast<Detail::JournalOperation>(*position++);
+				T1 first{};
+				T2 second{};
+				bool valid = true;
+				switch (operation)
+				{
+				case Detail::JournalOperation::Insert:
+				case Detail::JournalOperation::ChangeFirst:
+				case Detail::JournalOperation::ChangeSecond:
+					valid = Detail::JournalCodec<T1>::Read(position, argumentsEnd, first) && Detail::JournalCodec<T2>::Read(position, argumentsEnd, second);
+					break;
+				case Detail::JournalOperation::RemoveFirst:
+					valid = Detail::JournalCodec<T1>::Read(position, argumentsEnd, first);
+					break;
+				case Detail::JournalOperation::RemoveSecond:
+					valid = Detail::JournalCodec<T2>::Read(position, argumentsEnd, second);
+					break;
+				case Detail::JournalOperation::Clear:
+					break;
+				default:
+					valid = false;
+				}
+				if (!valid || position != argumentsEnd)
+					return recordStart - content.data();
+				callback(operation, std::move(first), std::move(second));
+				position = argumentsEnd + sizeof(checksum);
+			}
+		}
+
+		// append a record with arguments written by writeArguments and write it out according to the sync policy.
+		// If any step fails, the record is discarded, since the map does not perform the operation.
+		template<typename TWriteArguments>
+		void AppendRecord(Detail::JournalOperation operation, TWriteArguments writeArguments)
+		{
+			size_t start = buffer.size();
+			try
+			{
+				buffer.resize(start + sizeof(std::uint32_t));
+				buffer.push_back(static_cast<char>(operation));
+				writeArguments();
+				const char* arguments = buffer.data() + start + sizeof(std::uint32_t);
+				std::uint32_t size = static_cast<std::uint32_t>(buffer.size() - start - sizeof(std::uint32_t));
+				std::uint32_t checksum = static_cast<std::uint32_t>(Snapshot::Hash(arguments, size));
+				std::memcpy(buffer.data() + start, &size, sizeof(size));
+				Detail::JournalCodec<std::uint32_t>::Write(buffer, checksum);
+			}
+			catch (...)
+			{
+				buffer.resize(start);
+				throw;
+			}
+			size_t recordSize = buffer.size() - start;
+			try
+			{
+				if (options.sync == JournalSync::EveryRecord)
+					Commit();
+				else if (buffer.size() >= options.bufferSize)
+					Flush();
+			}
+			catch (...)
+			{
+				DiscardLastRecord(recordSize);
+				throw;
+			}
+		}
+
+		// remove the last record after a failed flush, which leaves the unwritten part of the buffer in place;
+		// the part of the record that has already been written is cut off the file
+		void DiscardLastRecord(size_t recordSize)
+		{
+			if (buffer.size() >= recordSize)
+			{
+				buffer.resize(buffer.size() - recordSize);
+				return;
+			}
+			std::uint64_t writtenPart = recordSize - buffer.size();
+			buffer.clear();
+			file->Resize(file->Length() - writtenPart);
+		}
+
+	}; // class BidirectionalMapJournal
+
+} // namespace MapSpecial
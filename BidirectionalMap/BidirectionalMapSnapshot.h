@@ -0,0 +1,330 @@
+#pragma once
+
+/*
+Copyright(c) 2017 Julijan Šribar
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software.If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Binary snapshot of a bidirectional map that can be memory-mapped and queried without deserialization.
+// File layout (all offsets are relative to the beginning of the file, values in native byte order):
+//   SnapshotHeader
+//   PairRecord[count]           - fixed-size records, strings refer into the blob
+//   char[blobSize]              - string blob, padded to 8 bytes
+//   uint64_t[indexCapacity]     - hash index of first keys
+//   uint64_t[indexCapacity]     - hash index of second keys
+// Each index slot is zero when empty; otherwise it contains the low 32 bits of key hash in its upper half
+// and (pair index + 1) in its lower half. Slots are probed linearly.
+
+namespace MapSpecial
+{
+	namespace Snapshot
+	{
+		constexpr char Magic[8] = { 'B', 'I', 'M', 'A', 'P', 'S', 'N', 'P' };
+		constexpr std::uint32_t FormatVersion = 1;
+		constexpr std::uint32_t ByteOrderMark = 0x01020304;
+
+		struct SnapshotHeader
+		{
+			char magic[8];
+			std::uint32_t formatVersion;
+			std::uint32_t byteOrderMark;
+			std::uint32_t firstType;
+			std::uint32_t secondType;
+			std::uint64_t count;
+			std::uint64_t pairsOffset;
+			std::uint64_t blobOffset;
+			std::uint64_t blobSize;
+			std::uint64_t indexCapacity;
+			std::uint64_t index1Offset;
+			std::uint64_t index2Offset;
+		};
+
+		// arithmetic values are stored in place, strings as offset and length in the blob
+		struct Field
+		{
+			std::uint64_t value;
+			std::uint64_t length;
+		};
+
+		struct PairRecord
+		{
+			Field first;
+			Field second;
+		};
+
+		// hash that is stable between processes and builds
+		inline std::uint64_t Hash(const char* data, std::size_t length) noexcept
+		{
+			std::uint64_t hash = 0xCBF29CE484222325ull;
+			for (std::size_t i = 0; i < length; ++i)
+			{
+				hash ^= static_cast<unsigned char>(data[i]);
+				hash *= 0x100000001B3ull;
+			}
+			return hash;
+		}
+
+		inline std::uint64_t Hash(std::uint64_t value) noexcept
+		{
+			value ^= value >> 30;
+			value *= 0xBF58476D1CE4E5B9ull;
+			value ^= value >> 27;
+			value *= 0x94D049BB133111EBull;
+			value ^= value >> 31;
+			return value;
+		}
+
+		// describes how values of a type are stored in the snapshot; defined for arithmetic types and std::string
+		template<typename T, typename Enable = void> struct SnapshotTraits;
+
+		template<typename T> struct SnapshotTraits<T, typename std::enable_if<std::is_arithmetic<T>::value>::type>
+		{
+			static_assert(sizeof(T) <= sizeof(std::uint64_t), "Type is too large for snapshot.");
+
+			using ViewType = T;
+			using LookupType = T;
+
+			static constexpr std::uint32_t TypeCode = (std::is_floating_point<T>::value ? 0x300 : std::is_signed<T>::value ? 0x200 : 0x100) + sizeof(T);
+
+			static std::size_t BlobSize(const T&) noexcept { return 0; }
+
+			static bool IsValid(const Field&, std::uint64_t) noexcept { return true; }
+
+			static Field Encode(const T& value, std::uint64_t) noexcept
+			{
+				Field field{ 0, 0 };
+				std::memcpy(&field.value, &value, sizeof(T));
+				return field;
+			}
+
+			static T Decode(const Field& field, const char*) noexcept
+			{
+				T value;
+				std::memcpy(&value, &field.value, sizeof(T));
+				return value;
+			}
+
+			static std::uint64_t HashOf(const T& value) noexcept
+			{
+				return Hash(Encode(value, 0).value);
+			}
+
+			static void WriteBlob(std::ostream&, const T&) {}
+		};
+
+		template<> struct SnapshotTraits<std::string>
+		{
+			using ViewType = std::string_view;
+			using LookupType = std::string_view;
+
+			static constexpr std::uint32_t TypeCode = 0x400;
+
+			static std::size_t BlobSize(const std::string& value) noexcept { return value.size(); }
+
+			// string must lie within the blob
+			static bool IsValid(const Field& field, std::uint64_t blobSize) noexcept
+			{
+				return field.value <= blobSize && field.length <= blobSize - field.value;
+			}
+
+			static Field Encode(const std::string& value, std::uint64_t blobOffset) noexcept
+			{
+				return Field{ blobOffset, value.size() };
+			}
+
+			static std::string_view Decode(const Field& field, const char* blob) noexcept
+			{
+				return std::string_view(blob + field.value, static_cast<std::size_t>(field.length));
+			}
+
+			static std::uint64_t HashOf(std::string_view value) noexcept
+			{
+				return Hash(value.data(), value.size());
+			}
+
+			static void WriteBlob(std::ostream& stream, const std::string& value)
+			{
+				stream.write(value.data(), value.size());
+			}
+		};
+
+		namespace Detail
+		{
+			inline std::uint64_t AlignedSize(std::uint64_t size) noexcept
+			{
+				return (size + 7) & ~std::uint64_t(7);
+			}
+
+			// capacity of index that keeps load factor below 3/4
+			inline std::uint64_t IndexCapacity(std::uint64_t count) noexcept
+			{
+				return count + count / 3 + 1;
+			}
+
+			// maps upper 32 bits of the hash onto the range [0, capacity)
+			inline std::uint64_t IndexSlot(std::uint64_t hash, std::uint64_t capacity) noexcept
+			{
+				return ((hash >> 32) * capacity) >> 32;
+			}
+
+			inline std::vector<std::uint64_t> BuildIndex(const std::vector<std::uint64_t>& hashes, std::uint64_t capacity)
+			{
+				std::vector<std::uint64_t> index(static_cast<std::size_t>(capacity), 0);
+				for (std::size_t i = 0; i < hashes.size(); ++i)
+				{
+					std::uint64_t slot = IndexSlot(hashes[i], capacity);
+					while (index[static_cast<std::size_t>(slot)] != 0)
+					{
+						if (++slot == capacity)
+							slot = 0;
+					}
+					index[static_cast<std::size_t>(slot)] = (hashes[i] << 32) | (i + 1);
+				}
+				return index;
+			}
+
+			template<typename TVector>
+			void WriteVector(std::ostream& stream, const TVector& vector)
+			{
+				stream.write(reinterpret_cast<const char*>(vector.data()), vector.size() * sizeof(typename TVector::value_type));
+			}
+		} // namespace Detail
+
+		// write the keypairs from the range [begin, end) into a snapshot file. The file is written under a temporary
+		// name and then renamed over the target, so views that map an existing file keep reading its old content.
+		template<typename TIterator>
+		void Write(const std::string& path, TIterator begin, TIterator end, std::size_t count)
+		{
+			using T1 = typename std::decay<decltype(begin->first)>::type;
+			using T2 = typename std::decay<decltype(begin->second)>::type;
+			using Traits1 = SnapshotTraits<T1>;
+			using Traits2 = SnapshotTraits<T2>;
+
+			if (count >= UINT32_MAX)
+				throw std::length_error("Too many keypairs for snapshot.");
+
+			std::vector<PairRecord> records;
+			std::vector<std::uint64_t> hashes1;
+			std::vector<std::uint64_t> hashes2;
+			records.reserve(count);
+			hashes1.reserve(count);
+			hashes2.reserve(count);
+			std::uint64_t blobSize = 0;
+			for (auto it = begin; it != end; ++it)
+			{
+				PairRecord record;
+				record.first = Traits1::Encode(it->first, blobSize);
+				blobSize += Traits1::BlobSize(it->first);
+				record.second = Traits2::Encode(it->second, blobSize);
+				blobSize += Traits2::BlobSize(it->second);
+				records.push_back(record);
+				hashes1.push_back(Traits1::HashOf(it->first));
+				hashes2.push_back(Traits2::HashOf(it->second));
+			}
+
+			SnapshotHeader header{};
+			std::memcpy(header.magic, Magic, sizeof(Magic));
+			header.formatVersion = FormatVersion;
+			header.byteOrderMark = ByteOrderMark;
+			header.firstType = Traits1::TypeCode;
+			header.secondType = Traits2::TypeCode;
+			header.count = records.size();
+			header.pairsOffset = Detail::AlignedSize(sizeof(SnapshotHeader));
+			header.blobOffset = header.pairsOffset + header.count * sizeof(PairRecord);
+			header.blobSize = blobSize;
+			header.indexCapacity = Detail::IndexCapacity(header.count);
+			header.index1Offset = header.blobOffset + Detail::AlignedSize(blobSize);
+			header.index2Offset = header.index1Offset + header.indexCapacity * sizeof(std::uint64_t);
+
+			const std::string temporaryPath = path + ".tmp";
+			std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+			if (!stream)
+				throw std::runtime_error("Cannot create snapshot file.");
+			const char padding[8] = {};
+			stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			stream.write(padding, header.pairsOffset - sizeof(header));
+			Detail::WriteVector(stream, records);
+			for (auto it = begin; it != end; ++it)
+			{
+				Traits1::WriteBlob(stream, it->first);
+				Traits2::WriteBlob(stream, it->second);
+			}
+			stream.write(padding, Detail::AlignedSize(blobSize) - blobSize);
+			Detail::WriteVector(stream, Detail::BuildIndex(hashes1, header.indexCapacity));
+			Detail::WriteVector(stream, Detail::BuildIndex(hashes2, header.indexCapacity));
+			stream.close();
+			if (!stream)
+			{
+				std::remove(temporaryPath.c_str());
+				throw std::runtime_error("Cannot write snapshot file.");
+			}
+			// replaces an existing target, with MoveFileEx and MOVEFILE_REPLACE_EXISTING on Windows
+			std::error_code error;
+			std::filesystem::rename(temporaryPath, path, error);
+			if (error)
+			{
+				std::remove(temporaryPath.c_str());
+				throw std::runtime_error("Cannot replace snapshot file.");
+			}
+		}
+
+		// read the keypairs from a snapshot file and pass them to the callback in the order they were written
+		template<typename T1, typename T2, typename TCallback>
+		void Read(const std::string& path, TCallback callback)
+		{
+			using Traits1 = SnapshotTraits<T1>;
+			using Traits2 = SnapshotTraits<T2>;
+
+			std::ifstream stream(path, std::ios::binary);
+			if (!stream)
+				throw std::runtime_error("Cannot open snapshot file.");
+			SnapshotHeader header;
+			if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header))
+				|| std::memcmp(header.magic, Magic, sizeof(Magic)) != 0
+				|| header.formatVersion != FormatVersion
+				|| header.byteOrderMark != ByteOrderMark)
+				throw std::runtime_error("Invalid snapshot file.");
+			if (header.firstType != Traits1::TypeCode || header.secondType != Traits2::TypeCode)
+				throw std::runtime_error("Snapshot key types do not match.");
+
+			std::vector<PairRecord> records(static_cast<std::size_t>(header.count));
+			std::vector<char> blob(static_cast<std::size_t>(header.blobSize));
+			stream.seekg(header.pairsOffset);
+			stream.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(PairRecord));
+			stream.seekg(header.blobOffset);
+			stream.read(blob.data(), blob.size());
+			if (!stream)
+				throw std::runtime_error("Snapshot file is truncated.");
+			for (const auto& record : records)
+				callback(T1(Traits1::Decode(record.first, blob.data())), T2(Traits2::Decode(record.second, blob.data())));
+		}
+
+	} // namespace Snapshot
+
+} // namespace MapSpecial
@@ -0,0 +1,184 @@
+#pragma once
+
+/*
+Copyright(c) 2017 Julijan Šribar
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software.If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "BidirectionalMapSnapshot.h"
+#include "MappedFile.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace MapSpecial
+{
+
+	// read-only bidirectional map served directly from a memory-mapped snapshot created by SaveSnapshot;
+	// string keys are returned as views into the mapping, which remain valid as long as the view exists
+	template<typename T1, typename T2>
+	class BidirectionalMapView
+	{
+		using Traits1 = Snapshot::SnapshotTraits<T1>;
+		using Traits2 = Snapshot::SnapshotTraits<T2>;
+
+	public:
+		using FirstView = typename Traits1::ViewType;
+		using SecondView = typename Traits2::ViewType;
+
+		explicit BidirectionalMapView(const std::string& path)
+			: file(path)
+		{
+			if (file.Size() < sizeof(Snapshot::SnapshotHeader))
+				throw std::runtime_error("Invalid snapshot file.");
+			header = reinterpret_cast<const Snapshot::SnapshotHeader*>(file.Data());
+			if (std::memcmp(header->magic, Snapshot::Magic, sizeof(Snapshot::Magic)) != 0
+				|| header->formatVersion != Snapshot::FormatVersion
+				|| header->byteOrderMark != Snapshot::ByteOrderMark)
+				throw std::runtime_error("Invalid snapshot file.");
+			if (header->firstType != Traits1::TypeCode || header->secondType != Traits2::TypeCode)
+				throw std::runtime_error("Snapshot key types do not match.");
+			ValidateLayout();
+			pairs = reinterpret_cast<const Snapshot::PairRecord*>(file.Data() + header->pairsOffset);
+			blob = file.Data() + header->blobOffset;
+			index1 = reinterpret_cast<const std::uint64_t*>(file.Data() + header->index1Offset);
+			index2 = reinterpret_cast<const std::uint64_t*>(file.Data() + header->index2Offset);
+			for (std::uint64_t i = 0; i < header->count; ++i)
+			{
+				if (!Traits1::IsValid(pairs[i].first, header->blobSize) || !Traits2::IsValid(pairs[i].second, header->blobSize))
+					throw std::runtime_error("Snapshot file is corrupted.");
+			}
+		}
+
+		// get number of keypairs in the map
+		size_t Size() const noexcept
+		{
+			return static_cast<size_t>(header->count);
+		}
+
+		// check if first key exists in the map
+		bool FirstExists(typename Traits1::LookupType first) const noexcept
+		{
+			return FindFirst(first) != nullptr;
+		}
+
+		// check if second key exists in the map
+		bool SecondExists(typename Traits2::LookupType second) const noexcept
+		{
+			return FindSecond(second) != nullptr;
+		}
+
+		// get the value assigned to given first key
+		SecondView AtFirst(typename Traits1::LookupType first) const
+		{
+			const Snapshot::PairRecord* record = FindFirst(first);
+			if (record == nullptr)
+				throw std::out_of_range("The first key must exist in the map.");
+			return Traits2::Decode(record->second, blob);
+		}
+
+		// get the value assigned to given second key
+		FirstView AtSecond(typename Traits2::LookupType second) const
+		{
+			const Snapshot::PairRecord* record = FindSecond(second);
+			if (record == nullptr)
+				throw std::out_of_range("The second key must exist in the map.");
+			return Traits1::Decode(record->first, blob);
+		}
+
+		// check if keypair with given first key exists
+		bool Exists(typename Traits1::LookupType first) const noexcept
+		{
+			return FirstExists(first);
+		}
+
+		// check if keypair with given second key exists
+		template <typename Q = T1, typename R = T2>
+		typename std::enable_if<!std::is_same<Q, R>::value, bool>::type
+		Exists(typename Traits2::LookupType second) const noexcept
+		{
+			return SecondExists(second);
+		}
+
+	private:
+		Detail::MappedFile file;
+		const Snapshot::SnapshotHeader* header;
+		const Snapshot::PairRecord* pairs;
+		const char* blob;
+		const std::uint64_t* index1;
+		const std::uint64_t* index2;
+
+		const Snapshot::PairRecord* FindFirst(typename Traits1::LookupType first) const noexcept
+		{
+			return Find(index1, Traits1::HashOf(first), [this, &first](const Snapshot::PairRecord& record) { return Traits1::Decode(record.first, blob) == first; });
+		}
+
+		const Snapshot::PairRecord* FindSecond(typename Traits2::LookupType second) const noexcept
+		{
+			return Find(index2, Traits2::HashOf(second), [this, &second](const Snapshot::PairRecord& record) { return Traits2::Decode(record.second, blob) == second; });
+		}
+
+		// check that all sections lie within the file, so that lookups do not read outside the mapping; the sizes
+		// are compared with the space remaining after each offset, which cannot overflow
+		void ValidateLayout() const
+		{
+			const std::uint64_t size = file.Size();
+			auto fits = [size](std::uint64_t offset, std::uint64_t count, std::uint64_t elementSize)
+			{
+				return offset % 8 == 0 && offset <= size && count <= (size - offset) / elementSize;
+			};
+			if (header->count >= UINT32_MAX || header->indexCapacity <= header->count)
+				throw std::runtime_error("Snapshot file is corrupted.");
+			if (!fits(header->pairsOffset, header->count, sizeof(Snapshot::PairRecord))
+				|| !fits(header->blobOffset, header->blobSize, 1)
+				|| !fits(header->index1Offset, header->indexCapacity, sizeof(std::uint64_t))
+				|| !fits(header->index2Offset, header->indexCapacity, sizeof(std::uint64_t)))
+				throw std::runtime_error("Snapshot file is truncated.");
+		}
+
+		// probing stops after visiting every slot, and entries that refer to nonexistent keypairs are skipped,
+		// so that a corrupted index cannot make a lookup loop forever or read outside the keypairs
+		template<typename TEqual>
+		const Snapshot::PairRecord* Find(const std::uint64_t* index, std::uint64_t hash, TEqual equal) const noexcept
+		{
+			const std::uint64_t capacity = header->indexCapacity;
+			const std::uint64_t tag = hash & 0xFFFFFFFFull;
+			const std::uint64_t count = header->count;
+			std::uint64_t slot = Snapshot::Detail::IndexSlot(hash, capacity);
+			for (std::uint64_t probes = 0; probes < capacity && index[slot] != 0; ++probes)
+			{
+				const std::uint64_t entry = index[slot];
+				const std::uint64_t pairIndex = entry & 0xFFFFFFFFull;
+				if ((entry >> 32) == tag && pairIndex - 1 < count)
+				{
+					const Snapshot::PairRecord& record = pairs[pairIndex - 1];
+					if (equal(record))
+						return &record;
+				}
+				if (++slot == capacity)
+					slot = 0;
+			}
+			return nullptr;
+		}
+
+	}; // class BidirectionalMapView
+
+} // namespace MapSpecial
@@ -0,0 +1,392 @@
+#pragma once
+
+/*
+Copyright(c) 2017 Julijan Šribar
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software.If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include "BidirectionalMap.h"
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <list>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+namespace MapSpecial
+{
+
+	namespace Detail
+	{
+		// random access iterator over contiguous array of list iterators that refer to keypairs
+		template<typename TItemIterator, typename TValue>
+		class KeyPairSpanIterator
+		{
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = TValue;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const TValue*;
+			using reference = const TValue&;
+
+			KeyPairSpanIterator() = default;
+			explicit KeyPairSpanIterator(const TItemIterator* it) : it(it) {}
+
+			reference operator*() const { return **it; }
+			pointer operator->() const { return &**it; }
+			reference operator[](difference_type n) const { return *it[n]; }
+
+			KeyPairSpanIterator& operator++() { ++it; return *this; }
+			KeyPairSpanIterator operator++(int) { KeyPairSpanIterator old(*this); ++it; return old; }
+			KeyPairSpanIterator& operator--() { --it; return *this; }
+			KeyPairSpanIterator operator--(int) { KeyPairSpanIterator old(*this); --it; return old; }
+			KeyPairSpanIterator& operator+=(difference_type n) { it += n; return *this; }
+			KeyPairSpanIterator& operator-=(difference_type n) { it -= n; return *this; }
+			KeyPairSpanIterator operator+(difference_type n) const { return KeyPairSpanIterator(it + n); }
+			KeyPairSpanIterator operator-(difference_type n) const { return KeyPairSpanIterator(it - n); }
+			difference_type operator-(const KeyPairSpanIterator& other) const { return it - other.it; }
+
+			bool operator==(const KeyPairSpanIterator& other) const { return it == other.it; }
+			bool operator!=(const KeyPairSpanIterator& other) const { return it != other.it; }
+			bool operator<(const KeyPairSpanIterator& other) const { return it < other.it; }
+			bool operator>(const KeyPairSpanIterator& other) const { return it > other.it; }
+			bool operator<=(const KeyPairSpanIterator& other) const { return it <= other.it; }
+			bool operator>=(const KeyPairSpanIterator& other) const { return it >= other.it; }
+
+		private:
+			const TItemIterator* it = nullptr;
+		};
+
+		// keypairs that share a key; references to them are stored contiguously
+		template<typename TItemIterator, typename TValue>
+		class KeyPairSpan
+		{
+		public:
+			using iterator = KeyPairSpanIterator<TItemIterator, TValue>;
+			using const_iterator = iterator;
+
+			KeyPairSpan() = default;
+			KeyPairSpan(const TItemIterator* data, std::size_t count) : data(data), count(count) {}
+
+			iterator begin() const { return iterator(data); }
+			iterator end() const { return iterator(data + count); }
+			std::size_t size() const { return count; }
+			bool empty() const { return count == 0; }
+			const TValue& operator[](std::size_t n) const { return *data[n]; }
+
+		private:
+			const TItemIterator* data = nullptr;
+			std::size_t count = 0;
+		};
+
+	} // namespace Detail
+
+
+	// bidirectional map in which a key may be paired with several keys of the other side. Every keypair is stored
+	// once in a list; each index maps a key to an array of list iterators to all keypairs with that key, so
+	// keypairs of a key are found in O(1) and visited contiguously. Each keypair remembers its positions in
+	// both arrays, which lets a single keypair be removed in O(1) by moving the last array element into its
+	// place. If UniqueSecond is true, a second key may be paired with only one first key.
+	template<typename T1, typename T2, bool UniqueSecond>
+	class BidirectionalMultiMapBase
+	{
+	public:
+		using value_type = std::pair<T1, T2>;
+
+	protected:
+		// keypair together with its positions in the arrays of both indices
+		struct Item : value_type
+		{
+			Item(const T1& first, const T2& second) : value_type(first, second) {}
+
+			std::size_t position1 = 0;
+			std::size_t position2 = 0;
+		};
+
+		using Container = std::list<Item>;
+		using ItemIterator = typename Container::iterator;
+		using Group = std::vector<ItemIterator>;
+		using Map1 = std::unordered_map<KeyPointer<T1>, Group, DereferencedPointerHash<T1>, DereferencedPointerEquality<T1>>;
+		using Map2 = std::unordered_map<KeyPointer<T2>, Group, DereferencedPointerHash<T2>, DereferencedPointerEquality<T2>>;
+
+	public:
+		// keypairs are visited in unspecified order and cannot be modified through iterators
+		using const_iterator = typename Container::const_iterator;
+		using iterator = const_iterator;
+		using Span = Detail::KeyPairSpan<ItemIterator, value_type>;
+
+		BidirectionalMultiMapBase() = default;
+
+		// initializer list constructor; keypairs that cannot be inserted throw as in Insert
+		BidirectionalMultiMapBase(std::initializer_list<value_type> il)
+		{
+			for (const auto& keyPair : il)
+				Insert(keyPair.first, keyPair.second);
+		}
+
+		// indices refer to the items of this map, so it is not copied
+		BidirectionalMultiMapBase(const BidirectionalMultiMapBase&) = delete;
+		BidirectionalMultiMapBase& operator=(const BidirectionalMultiMapBase&) = delete;
+
+		// insert a new keypair; returns false if it already exists. If second keys are unique, throws
+		// std::invalid_argument if the second key is paired with another first key.
+		bool Insert(const T1& first, const T2& second)
+		{
+			auto itKey1 = map1.find(&first);
+			auto itKey2 = map2.find(&second);
+			if (itKey1 != map1.end() && itKey2 != map2.end() && FindItem(itKey1->second, itKey2->second, first, second) != items.end())
+				return false;
+			if (UniqueSecond && itKey2 != map2.end())
+				throw std::invalid_argument("Second key already exists in the map.");
+
+			items.emplace_front(first, second);
+			auto itItem = items.begin();
+			try
+			{
+				Attach(map1, itKey1, itItem->first, itItem, itItem->position1);
+				try
+				{
+					Attach(map2, itKey2, itItem->second, itItem, itItem->position2);
+				}
+				catch (...)
+				{
+					Detach(map1, map1.find(&itItem->first), itItem->position1, &Item::position1, &value_type::first);
+					throw;
+				}
+			}
+			catch (...)
+			{
+				items.pop_front();
+				throw;
+			}
+			return true;
+		}
+
+		// remove the keypair; the other keypairs of both keys are kept
+		void RemovePair(const T1& first, const T2& second)
+		{
+			auto itKey1 = map1.find(&first);
+			auto itKey2 = map2.find(&second);
+			if (itKey1 == map1.end() || itKey2 == map2.end())
+				throw std::out_of_range("The keypair must exist in the map.");
+			auto itItem = FindItem(itKey1->second, itKey2->second, first, second);
+			if (itItem == items.end())
+				throw std::out_of_range("The keypair must exist in the map.");
+			Detach(map1, itKey1, itItem->position1, &Item::position1, &value_type::first);
+			Detach(map2, itKey2, itItem->position2, &Item::position2, &value_type::second);
+			items.erase(itItem);
+		}
+
+		// remove all keypairs which have given first key
+		void RemoveFirst(const T1& first)
+		{
+			auto itKey1 = map1.find(&first);
+			if (itKey1 == map1.end())
+				throw std::out_of_range("The first key must exist in the map.");
+			// index entry is erased while its key still exists
+			Group group = std::move(itKey1->second);
+			map1.erase(itKey1);
+			for (auto itItem : group)
+			{
+				Detach(map2, map2.find(&itItem->second), itItem->position2, &Item::position2, &value_type::second);
+				items.erase(itItem);
+			}
+		}
+
+		// remove all keypairs which have given second key
+		void RemoveSecond(const T2& second)
+		{
+			auto itKey2 = map2.find(&second);
+			if (itKey2 == map2.end())
+				throw std::out_of_range("The second key must exist in the map.");
+			Group group = std::move(itKey2->second);
+			map2.erase(itKey2);
+			for (auto itItem : group)
+			{
+				Detach(map1, map1.find(&itItem->first), itItem->position1, &Item::position1, &value_type::first);
+				items.erase(itItem);
+			}
+		}
+
+		// clear the map
+		void Clear() noexcept
+		{
+			map1.clear();
+			map2.clear();
+			items.clear();
+		}
+
+		// get number of keypairs in the map
+		size_t Size() const noexcept
+		{
+			return items.size();
+		}
+
+		const_iterator begin() const noexcept { return items.cbegin(); }
+		const_iterator end() const noexcept { return items.cend(); }
+		const_iterator cbegin() const noexcept { return items.cbegin(); }
+		const_iterator cend() const noexcept { return items.cend(); }
+
+		// check if first key exists in the map
+		bool FirstExists(const T1& first) const noexcept
+		{
+			return map1.find(&first) != map1.cend();
+		}
+
+		// check if second key exists in the map
+		bool SecondExists(const T2& second) const noexcept
+		{
+			return map2.find(&second) != map2.cend();
+		}
+
+		// check if keypair exists in the map
+		bool PairExists(const T1& first, const T2& second) const
+		{
+			auto itKey1 = map1.find(&first);
+			auto itKey2 = map2.find(&second);
+			return itKey1 != map1.end() && itKey2 != map2.end() && FindItem(itKey1->second, itKey2->second, first, second) != items.end();
+		}
+
+		// get all keypairs with given first key; the span is valid until the map is modified
+		Span EqualRangeFirst(const T1& first) const
+		{
+			auto itKey1 = map1.find(&first);
+			return itKey1 == map1.end() ? Span() : Span(itKey1->second.data(), itKey1->second.size());
+		}
+
+		// get all keypairs with given second key; the span is valid until the map is modified
+		Span EqualRangeSecond(const T2& second) const
+		{
+			auto itKey2 = map2.find(&second);
+			return itKey2 == map2.end() ? Span() : Span(itKey2->second.data(), itKey2->second.size());
+		}
+
+		// get number of keypairs with given first key
+		size_t CountFirst(const T1& first) const
+		{
+			auto itKey1 = map1.find(&first);
+			return itKey1 == map1.end() ? 0 : itKey1->second.size();
+		}
+
+		// get number of keypairs with given second key
+		size_t CountSecond(const T2& second) const
+		{
+			auto itKey2 = map2.find(&second);
+			return itKey2 == map2.end() ? 0 : itKey2->second.size();
+		}
+
+	protected:
+		Container items;
+		Map1 map1;
+		Map2 map2;
+
+	private:
+		// the shorter of both arrays is searched
+		const_iterator FindItem(const Group& group1, const Group& group2, const T1& first, const T2& second) const
+		{
+			if (group1.size() <= group2.size())
+			{
+				for (auto itItem : group1)
+				{
+					if (itItem->second == second)
+						return itItem;
+				}
+			}
+			else
+			{
+				for (auto itItem : group2)
+				{
+					if (itItem->first == first)
+						return itItem;
+				}
+			}
+			return items.cend();
+		}
+
+		// add the item to the array of its key, creating the index entry if the key is new
+		template<typename TMap, typename TKey>
+		static void Attach(TMap& map, typename TMap::iterator itKey, const TKey& key, ItemIterator itItem, std::size_t& position)
+		{
+			if (itKey == map.end())
+				itKey = map.emplace(&key, Group()).first;
+			try
+			{
+				itKey->second.push_back(itItem);
+			}
+			catch (...)
+			{
+				if (itKey->second.empty())
+					map.erase(itKey);
+				throw;
+			}
+			position = itKey->second.size() - 1;
+		}
+
+		// remove the item at given position of the array by moving the last item into its place. Index entry
+		// points to the key of the first item in the array and is erased together with the last item.
+		template<typename TMap, typename TKey>
+		static void Detach(TMap& map, typename TMap::iterator itKey, std::size_t position, std::size_t Item::* itemPosition, TKey value_type::* key)
+		{
+			Group& group = itKey->second;
+			if (position + 1 != group.size())
+			{
+				group[position] = group.back();
+				(*group[position]).*itemPosition = position;
+			}
+			group.pop_back();
+			if (group.empty())
+				map.erase(itKey);
+			else if (position == 0)
+				itKey->first.pointer = &((*group.front()).*key);
+		}
+	};
+
+	// many-to-many bidirectional map: both first and second keys may be paired with several keys
+	template <typename T1, typename T2>
+	class BidirectionalMultiMap : public BidirectionalMultiMapBase<T1, T2, false>
+	{
+	public:
+		// Inherit all constructors from base class
+		using BidirectionalMultiMapBase<T1, T2, false>::BidirectionalMultiMapBase;
+	};
+
+	// one-to-many bidirectional map: a first key may be paired with several second keys, but each second key
+	// is paired with a single first key
+	template <typename T1, typename T2>
+	class BidirectionalOneToManyMap : public BidirectionalMultiMapBase<T1, T2, true>
+	{
+	public:
+		// Inherit all constructors from base class
+		using BidirectionalMultiMapBase<T1, T2, true>::BidirectionalMultiMapBase;
+
+		// get the first key paired to given second key
+		const T1& AtSecond(const T2& second) const
+		{
+			auto itKey2 = this->map2.find(&second);
+			if (itKey2 == this->map2.end())
+				throw std::out_of_range("The second key must exist in the map.");
+			return itKey2->second.front()->first;
+		}
+	};
+
+} // namespace MapSpecial
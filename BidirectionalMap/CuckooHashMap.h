@@ -0,0 +1,633 @@
+#pragma once
+
+/*
+Copyright(c) 2017 Julijan Šribar
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software.If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include "BidirectionalMapHash.h"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Bucketized cuckoo hash table. Every key has two candidate buckets of four slots, both derived from its hash,
+// and is stored in one of them; a key that does not fit displaces a key from a full bucket into that key's other
+// bucket, and so on. Keys that cannot be placed after a bounded number of displacements go to a small stash, and
+// when the stash is full the table is rehashed with new bucket indices, growing if it is more than half full.
+// A lookup therefore compares the hashes in at most two buckets of one cache line each, plus the stash if it is
+// not empty, no matter how the keys are distributed. Slots hold hashes next to pointers to the elements, so
+// elements never move and rehashing does not compute any hash again.
+
+namespace MapSpecial
+{
+
+	// unordered map implemented as bucketized cuckoo hash table; provides the subset of std::unordered_map interface
+	// used by bidirectional maps. Insertion may move elements between slots and invalidates iterators; erasing
+	// invalidates only iterators to the erased element.
+	template<typename TKey, typename TValue, typename THash, typename TEqual>
+	class CuckooHashMap
+	{
+	public:
+		using key_type = TKey;
+		using mapped_type = TValue;
+		using value_type = std::pair<const TKey, TValue>;
+		using size_type = std::size_t;
+		using hasher = THash;
+		using key_equal = TEqual;
+
+	private:
+		static constexpr std::size_t BucketSize = 4;
+		static constexpr std::size_t StashSize = 4;
+		static constexpr std::size_t MinBucketCount = 4;
+		// displacements before the key is put into the stash
+		static constexpr unsigned MaxDisplacements = 128;
+
+		struct Slot
+		{
+			std::size_t hash;
+			value_type* element;
+		};
+
+		// hashes and elements are kept in separate arrays, so that the hashes are compared without loading elements
+		struct alignas(64) Bucket
+		{
+			std::size_t hashes[BucketSize] = {};
+			value_type* elements[BucketSize] = {};
+		};
+
+		struct Table
+		{
+			std::vector<Bucket> buckets;
+			// slots of erased stashed elements are empty and are reused
+			std::vector<Slot> stash;
+			std::size_t stashed = 0;
+			std::uint64_t seed = 0;
+		};
+
+		template<bool IsConst>
+		class Iterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = typename CuckooHashMap::value_type;
+			using difference_type = std::ptrdiff_t;
+			using pointer = typename std::conditional<IsConst, const value_type*, value_type*>::type;
+			using reference = typename std::conditional<IsConst, const value_type&, value_type&>::type;
+
+			Iterator() = default;
+
+			// conversion of iterator to const_iterator
+			template<bool OtherIsConst, typename = typename std::enable_if<IsConst && !OtherIsConst>::type>
+			Iterator(const Iterator<OtherIsConst>& other) : map(other.map), position(other.position) {}
+
+			reference operator*() const { return *map->ElementAt(position); }
+			pointer operator->() const { return map->ElementAt(position); }
+
+			Iterator& operator++()
+			{
+				position = map->Occupied(position + 1);
+				return *this;
+			}
+
+			Iterator operator++(int)
+			{
+				Iterator old(*this);
+				++*this;
+				return old;
+			}
+
+			bool operator==(const Iterator& other) const { return position == other.position; }
+			bool operator!=(const Iterator& other) const { return position != other.position; }
+
+		private:
+			friend class CuckooHashMap;
+			template<bool> friend class Iterator;
+
+			Iterator(const CuckooHashMap* map, std::size_t position) : map(map), position(position) {}
+
+			const CuckooHashMap* map = nullptr;
+			// index of the slot in all buckets followed by the stash
+			std::size_t position = 0;
+		};
+
+	public:
+		using iterator = Iterator<false>;
+		using const_iterator = Iterator<true>;
+
+		// element detached from the map, which can be inserted into another map without allocation
+		class node_type
+		{
+		public:
+			node_type() = default;
+
+			node_type(node_type&& other) noexcept
+				: element(other.element)
+			{
+				other.element = nullptr;
+			}
+
+			node_type& operator=(node_type&& other) noexcept
+			{
+				std::swap(element, other.element);
+				return *this;
+			}
+
+			~node_type()
+			{
+				delete element;
+			}
+
+			bool empty() const noexcept { return element == nullptr; }
+			explicit operator bool() const noexcept { return element != nullptr; }
+
+			const key_type& key() const noexcept { return element->first; }
+			mapped_type& mapped() const noexcept { return element->second; }
+
+		private:
+			friend class CuckooHashMap;
+
+			explicit node_type(value_type* element) noexcept : element(element) {}
+
+			value_type* element = nullptr;
+		};
+
+		struct insert_return_type
+		{
+			iterator position;
+			bool inserted;
+			node_type node;
+		};
+
+		CuckooHashMap() = default;
+
+		// copy constructor copies the elements into the same slots, so no keys are hashed or compared
+		CuckooHashMap(const CuckooHashMap& other)
+			: elementCount(other.elementCount)
+		{
+			table.buckets.resize(other.table.buckets.size());
+			table.stash.resize(other.table.stash.size(), Slot{ 0, nullptr });
+			table.stash.reserve(other.table.stash.capacity());
+			table.stashed = other.table.stashed;
+			table.seed = other.table.seed;
+			try
+			{
+				for (std::size_t i = 0; i < table.buckets.size(); ++i)
+				{
+					for (std::size_t j = 0; j < BucketSize; ++j)
+					{
+						if (other.table.buckets[i].elements[j] != nullptr)
+						{
+							table.buckets[i].elements[j] = new value_type(*other.table.buckets[i].elements[j]);
+							table.buckets[i].hashes[j] = other.table.buckets[i].hashes[j];
+						}
+					}
+				}
+				for (std::size_t i = 0; i < table.stash.size(); ++i)
+				{
+					if (other.table.stash[i].element != nullptr)
+						table.stash[i] = Slot{ other.table.stash[i].hash, new value_type(*other.table.stash[i].element) };
+				}
+			}
+			catch (...)
+			{
+				clear();
+				throw;
+			}
+		}
+
+		CuckooHashMap(CuckooHashMap&& other) noexcept
+		{
+			swap(other);
+		}
+
+		CuckooHashMap& operator=(const CuckooHashMap& other)
+		{
+			if (this != &other)
+			{
+				CuckooHashMap copy(other);
+				swap(copy);
+			}
+			return *this;
+		}
+
+		CuckooHashMap& operator=(CuckooHashMap&& other) noexcept
+		{
+			swap(other);
+			return *this;
+		}
+
+		~CuckooHashMap()
+		{
+			clear();
+		}
+
+		void swap(CuckooHashMap& other) noexcept
+		{
+			table.buckets.swap(other.table.buckets);
+			table.stash.swap(other.table.stash);
+			std::swap(table.stashed, other.table.stashed);
+			std::swap(table.seed, other.table.seed);
+			std::swap(elementCount, other.elementCount);
+		}
+
+		iterator begin() noexcept { return iterator(this, Occupied(0)); }
+		const_iterator begin() const noexcept { return const_iterator(this, Occupied(0)); }
+		const_iterator cbegin() const noexcept { return begin(); }
+		iterator end() noexcept { return iterator(this, EndPosition()); }
+		const_iterator end() const noexcept { return const_iterator(this, EndPosition()); }
+		const_iterator cend() const noexcept { return end(); }
+
+		size_type size() const noexcept { return elementCount; }
+		bool empty() const noexcept { return elementCount == 0; }
+		size_type bucket_count() const noexcept { return table.buckets.size(); }
+		// number of elements that did not fit into their buckets; lookups of missing keys also search them
+		size_type stash_size() const noexcept { return table.stashed; }
+		float load_factor() const noexcept { return table.buckets.empty() ? 0.0f : float(elementCount) / float(table.buckets.size() * BucketSize); }
+		hasher hash_function() const { return hasher(); }
+		key_equal key_eq() const { return key_equal(); }
+
+		// elements are deleted, the buckets are kept
+		void clear() noexcept
+		{
+			for (auto& bucket : table.buckets)
+			{
+				for (std::size_t j = 0; j < BucketSize; ++j)
+				{
+					delete bucket.elements[j];
+					bucket.elements[j] = nullptr;
+					bucket.hashes[j] = 0;
+				}
+			}
+			for (const auto& slot : table.stash)
+				delete slot.element;
+			table.stash.clear();
+			table.stashed = 0;
+			elementCount = 0;
+		}
+
+		// make room for given number of elements without rehashing
+		void reserve(size_type count)
+		{
+			std::size_t bucketCount = table.buckets.empty() ? MinBucketCount : table.buckets.size();
+			while (!HasRoom(bucketCount, count))
+				bucketCount *= 2;
+			if (bucketCount != table.buckets.size())
+				Rehash(bucketCount);
+		}
+
+		// insert the element constructed from arguments unless an element with equal key exists
+		template<typename... Args>
+		std::pair<iterator, bool> emplace(Args&&... args)
+		{
+			std::unique_ptr<value_type> element(new value_type(std::forward<Args>(args)...));
+			std::size_t hash = THash{}(element->first);
+			std::size_t position = FindPosition(element->first, hash);
+			if (position != EndPosition())
+				return { iterator(this, position), false };
+			position = Add(Slot{ hash, element.get() });
+			element.release();
+			return { iterator(this, position), true };
+		}
+
+		// detach the element from the map without deallocating it
+		node_type extract(const_iterator position) noexcept
+		{
+			value_type* element = ElementAt(position.position);
+			Vacate(position.position);
+			return node_type(element);
+		}
+
+		node_type extract(const key_type& key)
+		{
+			std::size_t position = FindPosition(key, THash{}(key));
+			if (position == EndPosition())
+				return node_type();
+			return extract(const_iterator(this, position));
+		}
+
+		// insert detached element; if an element with equal key exists, ownership stays with returned node
+		insert_return_type insert(node_type&& handle)
+		{
+			if (handle.empty())
+				return { end(), false, node_type() };
+			std::size_t hash = THash{}(handle.element->first);
+			std::size_t position = FindPosition(handle.element->first, hash);
+			if (position != EndPosition())
+				return { iterator(this, position), false, std::move(handle) };
+			position = Add(Slot{ hash, handle.element });
+			handle.element = nullptr;
+			return { iterator(this, position), true, node_type() };
+		}
+
+		iterator find(const key_type& key) { return iterator(this, FindPosition(key, THash{}(key))); }
+		const_iterator find(const key_type& key) const { return const_iterator(this, FindPosition(key, THash{}(key))); }
+
+		size_type count(const key_type& key) const { return FindPosition(key, THash{}(key)) != EndPosition() ? 1 : 0; }
+
+		mapped_type& at(const key_type& key)
+		{
+			std::size_t position = FindPosition(key, THash{}(key));
+			if (position == EndPosition())
+				throw std::out_of_range("Key does not exist in the map.");
+			return ElementAt(position)->second;
+		}
+
+		const mapped_type& at(const key_type& key) const
+		{
+			std::size_t position = FindPosition(key, THash{}(key));
+			if (position == EndPosition())
+				throw std::out_of_range("Key does not exist in the map.");
+			return ElementAt(position)->second;
+		}
+
+		// erase the element and return iterator to the following one
+		iterator erase(const_iterator position)
+		{
+			delete ElementAt(position.position);
+			Vacate(position.position);
+			return iterator(this, Occupied(position.position + 1));
+		}
+
+		iterator erase(iterator position)
+		{
+			return erase(const_iterator(position));
+		}
+
+		size_type erase(const key_type& key)
+		{
+			std::size_t position = FindPosition(key, THash{}(key));
+			if (position == EndPosition())
+				return 0;
+			erase(const_iterator(this, position));
+			return 1;
+		}
+
+	private:
+		Table table;
+		size_type elementCount = 0;
+
+		// tables are grown before they are 90% full
+		static bool HasRoom(std::size_t bucketCount, std::size_t count) noexcept
+		{
+			return count * 10 <= bucketCount * BucketSize * 9;
+		}
+
+		// the two buckets of a hash are taken from the halves of the hash mixed with the seed of the table
+		static std::pair<std::size_t, std::size_t> BucketsOf(const Table& table, std::size_t hash) noexcept
+		{
+			std::uint64_t mixed = Detail::MultiplyMix(static_cast<std::uint64_t>(hash) ^ table.seed, 0x9E3779B97F4A7C15ull);
+			std::size_t mask = table.buckets.size() - 1;
+			return { static_cast<std::size_t>(mixed) & mask, static_cast<std::size_t>(mixed >> 32) & mask };
+		}
+
+		std::size_t SlotCount() const noexcept { return table.buckets.size() * BucketSize; }
+		std::size_t EndPosition() const noexcept { return SlotCount() + table.stash.size(); }
+
+		value_type* ElementAt(std::size_t position) const noexcept
+		{
+			if (position < SlotCount())
+				return table.buckets[position / BucketSize].elements[position % BucketSize];
+			return table.stash[position - SlotCount()].element;
+		}
+
+		// the first occupied position from given one on
+		std::size_t Occupied(std::size_t position) const noexcept
+		{
+			std::size_t end = EndPosition();
+			while (position < end && ElementAt(position) == nullptr)
+				++position;
+			return position;
+		}
+
+		void Vacate(std::size_t position) noexcept
+		{
+			if (position < SlotCount())
+			{
+				Bucket& bucket = table.buckets[position / BucketSize];
+				bucket.elements[position % BucketSize] = nullptr;
+				bucket.hashes[position % BucketSize] = 0;
+			}
+			else
+			{
+				table.stash[position - SlotCount()].element = nullptr;
+				--table.stashed;
+			}
+			--elementCount;
+		}
+
+		std::size_t FindPosition(const key_type& key, std::size_t hash) const
+		{
+			if (elementCount == 0)
+				return EndPosition();
+			auto buckets = BucketsOf(table, hash);
+			for (std::size_t index : { buckets.first, buckets.second })
+			{
+				const Bucket& bucket = table.buckets[index];
+				for (std::size_t j = 0; j < BucketSize; ++j)
+				{
+					if (bucket.hashes[j] == hash && bucket.elements[j] != nullptr && TEqual{}(bucket.elements[j]->first, key))
+						return index * BucketSize + j;
+				}
+			}
+			if (table.stashed != 0)
+			{
+				for (std::size_t i = 0; i < table.stash.size(); ++i)
+				{
+					const Slot& slot = table.stash[i];
+					if (slot.hash == hash && slot.element != nullptr && TEqual{}(slot.element->first, key))
+						return SlotCount() + i;
+				}
+			}
+			return EndPosition();
+		}
+
+		// position of an element that is known to be in the table
+		std::size_t Locate(const value_type* element, std::size_t hash) const noexcept
+		{
+			auto buckets = BucketsOf(table, hash);
+			for (std::size_t index : { buckets.first, buckets.second })
+			{
+				for (std::size_t j = 0; j < BucketSize; ++j)
+				{
+					if (table.buckets[index].elements[j] == element)
+						return index * BucketSize + j;
+				}
+			}
+			std::size_t i = 0;
+			while (table.stash[i].element != element)
+				++i;
+			return SlotCount() + i;
+		}
+
+		static bool PutIntoBucket(Bucket& bucket, const Slot& slot) noexcept
+		{
+			for (std::size_t j = 0; j < BucketSize; ++j)
+			{
+				if (bucket.elements[j] == nullptr)
+				{
+					bucket.hashes[j] = slot.hash;
+					bucket.elements[j] = slot.element;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		// place the slot into one of its buckets, displacing other slots, or into the stash. Keys with equal hashes
+		// cannot be separated by rehashing, so if the buckets are full of them the stash may exceed its size. If
+		// placing fails, slot is the one that remains without place, which need not be the given one. The stash
+		// must have capacity for one more slot.
+		static bool Place(Table& table, Slot& slot, std::uint32_t& random) noexcept
+		{
+			auto buckets = BucketsOf(table, slot.hash);
+			if (PutIntoBucket(table.buckets[buckets.first], slot) || PutIntoBucket(table.buckets[buckets.second], slot))
+				return true;
+			std::size_t index = buckets.first;
+			for (unsigned displacements = 0; displacements < MaxDisplacements; ++displacements)
+			{
+				// xorshift chooses the slot to displace, so that displacements do not cycle
+				random ^= random << 13;
+				random ^= random >> 17;
+				random ^= random << 5;
+				Bucket& bucket = table.buckets[index];
+				std::size_t j = random % BucketSize;
+				std::swap(slot.hash, bucket.hashes[j]);
+				std::swap(slot.element, bucket.elements[j]);
+				buckets = BucketsOf(table, slot.hash);
+				index = buckets.first == index ? buckets.second : buckets.first;
+				if (PutIntoBucket(table.buckets[index], slot))
+					return true;
+			}
+			for (auto& stashed : table.stash)
+			{
+				if (stashed.element == nullptr)
+				{
+					stashed = slot;
+					++table.stashed;
+					return true;
+				}
+			}
+			if (table.stash.size() < StashSize || IsCrowded(table, slot.hash))
+			{
+				table.stash.push_back(slot);
+				++table.stashed;
+				return true;
+			}
+			return false;
+		}
+
+		// check if both buckets of the hash hold only keys with the same hash
+		static bool IsCrowded(const Table& table, std::size_t hash) noexcept
+		{
+			auto buckets = BucketsOf(table, hash);
+			for (std::size_t index : { buckets.first, buckets.second })
+			{
+				for (std::size_t j = 0; j < BucketSize; ++j)
+				{
+					if (table.buckets[index].hashes[j] != hash)
+						return false;
+				}
+			}
+			return true;
+		}
+
+		// add the slot of an element whose key is not in the table and return its position
+		std::size_t Add(Slot slot)
+		{
+			if (table.buckets.empty() || !HasRoom(table.buckets.size(), elementCount + 1))
+				Rehash(table.buckets.empty() ? MinBucketCount : table.buckets.size() * 2);
+			if (table.stash.size() == table.stash.capacity())
+				table.stash.reserve(table.stash.size() + StashSize);
+			Slot homeless = slot;
+			++elementCount;
+			if (!Place(table, homeless, random))
+			{
+				// the slot left without place is stashed over the size of the stash until the table is rehashed;
+				// if rehashing fails, it stays there, which only makes lookups of missing keys slower
+				table.stash.push_back(homeless);
+				++table.stashed;
+				try
+				{
+					Rehash(table.buckets.size());
+				}
+				catch (...)
+				{
+				}
+			}
+			return Locate(slot.element, slot.hash);
+		}
+
+		// move all slots into a new table with given number of buckets. Each failed attempt changes the seed of the
+		// table, and every fourth attempt or an attempt with the table more than half full doubles the number of
+		// buckets. The map is unchanged if an exception is thrown.
+		void Rehash(std::size_t bucketCount)
+		{
+			std::vector<Slot> slots;
+			slots.reserve(elementCount);
+			for (const auto& bucket : table.buckets)
+			{
+				for (std::size_t j = 0; j < BucketSize; ++j)
+				{
+					if (bucket.elements[j] != nullptr)
+						slots.push_back(Slot{ bucket.hashes[j], bucket.elements[j] });
+				}
+			}
+			for (const auto& slot : table.stash)
+			{
+				if (slot.element != nullptr)
+					slots.push_back(slot);
+			}
+
+			for (std::uint64_t seed = table.seed + 1; ; ++seed)
+			{
+				Table rehashed;
+				rehashed.buckets.resize(bucketCount);
+				rehashed.stash.reserve(StashSize);
+				rehashed.seed = seed;
+				bool placed = true;
+				for (auto slot : slots)
+				{
+					if (rehashed.stash.size() == rehashed.stash.capacity())
+						rehashed.stash.reserve(rehashed.stash.size() * 2);
+					if (!Place(rehashed, slot, random))
+					{
+						placed = false;
+						break;
+					}
+				}
+				if (placed)
+				{
+					std::swap(table, rehashed);
+					elementCount = slots.size();
+					return;
+				}
+				if (2 * slots.size() > bucketCount * BucketSize || (seed - table.seed) % 4 == 0)
+					bucketCount *= 2;
+			}
+		}
+
+		std::uint32_t random = 2463534242u;
+	};
+
+} // namespace MapSpecial
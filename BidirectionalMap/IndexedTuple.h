@@ -0,0 +1,273 @@
+#pragma once
+
+/*
+Copyright(c) 2017 Julijan Šribar
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software.If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include "BidirectionalMap.h"
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <cassert>
+
+namespace MapSpecial
+{
+
+	// container of records with several columns in which every column is unique and searchable, a generalization
+	// of the bidirectional map to any number of keys. Each record is stored once in a list and every column has
+	// its own index of pointers to the keys in the records. Columns are given either as key types, which are
+	// hashed, or as HashedIndex, CuckooIndex, OrderedIndex or RadixTreeIndex of the key type.
+	template<typename ...TColumns>
+	class IndexedTuple
+	{
+	public:
+		using value_type = std::tuple<typename Detail::ColumnIndex<TColumns>::type::key_type...>;
+		// key type of given column
+		template<std::size_t Col> using column_type = typename std::tuple_element<Col, value_type>::type;
+
+	private:
+		using Container = std::list<value_type>;
+		using Indices = std::tuple<typename Detail::ColumnIndex<TColumns>::type::template Map<typename Container::iterator>...>;
+
+		static constexpr std::size_t columns = sizeof...(TColumns);
+
+	public:
+		// records are visited in unspecified order and cannot be modified through iterators
+		using const_iterator = typename Container::const_iterator;
+		using iterator = const_iterator;
+
+		IndexedTuple() = default;
+
+		// copy constructor indexes the copied records
+		IndexedTuple(const IndexedTuple& other)
+			: items(other.items)
+		{
+			for (auto it = items.begin(); it != items.end(); ++it)
+				Link<0>(it);
+		}
+
+		IndexedTuple(IndexedTuple&& other) = default;
+
+		// initializer list constructor; records with existing keys throw as in Insert
+		IndexedTuple(std::initializer_list<value_type> il)
+		{
+			for (const auto& record : il)
+				std::apply([this](const auto& ...values) { Insert(values...); }, record);
+		}
+
+		IndexedTuple& operator=(const IndexedTuple& other)
+		{
+			if (this != &other)
+				*this = IndexedTuple(other);
+			return *this;
+		}
+
+		IndexedTuple& operator=(IndexedTuple&& other) = default;
+
+		// insert a new record; returns false if identical record already exists. Throws std::invalid_argument if a
+		// key exists in another record.
+		template<typename ...Args>
+		bool Insert(Args&& ...values)
+		{
+			static_assert(sizeof...(Args) == columns, "A value must be given for every column.");
+			items.emplace_front(std::forward<Args>(values)...);
+			auto it = items.begin();
+			try
+			{
+				auto found = FindAll(*it, std::make_index_sequence<columns>());
+				std::size_t column = 0;
+				while (column < columns && found[column] == items.end())
+					++column;
+				if (column < columns)
+				{
+					// do not perform insertion if the same record already exists
+					bool sameRecord = true;
+					for (const auto& record : found)
+						sameRecord = sameRecord && record == found[column];
+					if (sameRecord)
+					{
+						items.pop_front();
+						return false;
+					}
+					throw std::invalid_argument("Key of column " + std::to_string(column) + " already exists in the map.");
+				}
+				Link<0>(it);
+			}
+			catch (...)
+			{
+				items.pop_front();
+				throw;
+			}
+
+			assert(items.size() == std::get<0>(indices).size());
+			return true;
+		}
+
+		// get the record with given key in column Col
+		template<std::size_t Col>
+		const value_type& At(const column_type<Col>& key) const
+		{
+			const auto& index = std::get<Col>(indices);
+			auto itKey = index.find(&key);
+			if (itKey == index.end())
+				throw std::out_of_range("The key must exist in the map.");
+			return *itKey->second;
+		}
+
+		// check if key exists in column Col
+		template<std::size_t Col>
+		bool Exists(const column_type<Col>& key) const
+		{
+			const auto& index = std::get<Col>(indices);
+			return index.find(&key) != index.end();
+		}
+
+		// change the key in column Col of the record that has given key in column ByCol, which is Col by default.
+		// Returns false if the record already has the new key; throws std::invalid_argument if another record has it.
+		template<std::size_t Col, std::size_t ByCol = Col, typename V>
+		bool Change(const column_type<ByCol>& key, V&& value)
+		{
+			const auto& byIndex = std::get<ByCol>(indices);
+			auto itKey = byIndex.find(&key);
+			if (itKey == byIndex.end())
+				throw std::out_of_range("The key must exist in the map.");
+			return ChangeKey<Col>(itKey->second, Detail::AsKey<column_type<Col>>(std::forward<V>(value)));
+		}
+
+		// remove the record with given key in column Col
+		template<std::size_t Col>
+		void Remove(const column_type<Col>& key)
+		{
+			auto& index = std::get<Col>(indices);
+			auto itKey = index.find(&key);
+			if (itKey == index.end())
+				throw std::out_of_range("The key must exist in the map.");
+			auto itItem = itKey->second;
+			Unlink<0, Col>(itItem);
+			index.erase(itKey);
+			items.erase(itItem);
+		}
+
+		// remove all records
+		void Clear() noexcept
+		{
+			std::apply([](auto& ...index) { (index.clear(), ...); }, indices);
+			items.clear();
+		}
+
+		// get number of records
+		size_t Size() const noexcept
+		{
+			assert(items.size() == std::get<0>(indices).size());
+			return items.size();
+		}
+
+		const_iterator begin() const noexcept { return items.cbegin(); }
+		const_iterator end() const noexcept { return items.cend(); }
+		const_iterator cbegin() const noexcept { return items.cbegin(); }
+		const_iterator cend() const noexcept { return items.cend(); }
+
+	private:
+		Container items;
+		Indices indices;
+
+		// records that contain the keys of given record, or end of the list for keys that do not exist
+		template<std::size_t ...Cols>
+		std::array<typename Container::iterator, columns> FindAll(const value_type& record, std::index_sequence<Cols...>)
+		{
+			return { { Find<Cols>(std::get<Cols>(record))... } };
+		}
+
+		template<std::size_t Col>
+		typename Container::iterator Find(const column_type<Col>& key)
+		{
+			auto& index = std::get<Col>(indices);
+			auto itKey = index.find(&key);
+			return itKey == index.end() ? items.end() : itKey->second;
+		}
+
+		// add keys of the record to indices of columns starting at Col; on exception, added keys are removed
+		template<std::size_t Col>
+		void Link(typename Container::iterator itItem)
+		{
+			if constexpr (Col < columns)
+			{
+				auto& index = std::get<Col>(indices);
+				index.emplace(&std::get<Col>(*itItem), itItem);
+				try
+				{
+					Link<Col + 1>(itItem);
+				}
+				catch (...)
+				{
+					index.erase(&std::get<Col>(*itItem));
+					throw;
+				}
+			}
+		}
+
+		// remove keys of the record from indices of columns starting at Col, except column Skip
+		template<std::size_t Col, std::size_t Skip>
+		void Unlink(typename Container::iterator itItem)
+		{
+			if constexpr (Col < columns)
+			{
+				if constexpr (Col != Skip)
+					std::get<Col>(indices).erase(&std::get<Col>(*itItem));
+				Unlink<Col + 1, Skip>(itItem);
+			}
+		}
+
+		// index node of the key is detached and reinserted after the key has changed, so no allocation is needed
+		template<std::size_t Col, typename K>
+		bool ChangeKey(typename Container::iterator itItem, K&& value)
+		{
+			auto& index = std::get<Col>(indices);
+			auto itExisting = index.find(&value);
+			if (itExisting != index.end())
+			{
+				if (itExisting->second == itItem)
+					return false;
+				throw std::invalid_argument("Key of column " + std::to_string(Col) + " already exists in the map.");
+			}
+			auto node = index.extract(&std::get<Col>(*itItem));
+			try
+			{
+				std::get<Col>(*itItem) = std::forward<K>(value);
+			}
+			catch (...)
+			{
+				Detail::RefreshKey(node.key());
+				index.insert(std::move(node));
+				throw;
+			}
+			Detail::RefreshKey(node.key());
+			index.insert(std::move(node));
+			return true;
+		}
+	};
+
+} // namespace MapSpecial
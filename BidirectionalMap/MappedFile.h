@@ -0,0 +1,141 @@
+#pragma once
+
+/*
+Copyright(c) 2017 Julijan Šribar
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software.If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace MapSpecial
+{
+
+	namespace Detail
+	{
+		// read-only mapping of a whole file into memory; empty file is represented by null data
+		class MappedFile
+		{
+		public:
+			explicit MappedFile(const std::string& path)
+			{
+#ifdef _WIN32
+				HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+				if (file == INVALID_HANDLE_VALUE)
+					throw std::runtime_error("Cannot open file.");
+				LARGE_INTEGER fileSize;
+				if (!::GetFileSizeEx(file, &fileSize))
+				{
+					::CloseHandle(file);
+					throw std::runtime_error("Cannot map file.");
+				}
+				if (fileSize.QuadPart == 0)
+				{
+					::CloseHandle(file);
+					return;
+				}
+				HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				::CloseHandle(file);
+				if (mapping == nullptr)
+					throw std::runtime_error("Cannot map file.");
+				data = static_cast<const char*>(::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+				::CloseHandle(mapping);
+				if (data == nullptr)
+					throw std::runtime_error("Cannot map file.");
+				size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+				int file = ::open(path.c_str(), O_RDONLY);
+				if (file == -1)
+					throw std::runtime_error("Cannot open file.");
+				struct stat status;
+				if (::fstat(file, &status) != 0)
+				{
+					::close(file);
+					throw std::runtime_error("Cannot map file.");
+				}
+				if (status.st_size == 0)
+				{
+					::close(file);
+					return;
+				}
+				size = static_cast<std::size_t>(status.st_size);
+				void* address = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0);
+				::close(file);
+				if (address == MAP_FAILED)
+					throw std::runtime_error("Cannot map file.");
+				data = static_cast<const char*>(address);
+#endif
+			}
+
+			MappedFile(MappedFile&& other) noexcept
+				: data(other.data)
+				, size(other.size)
+			{
+				other.data = nullptr;
+				other.size = 0;
+			}
+
+			MappedFile& operator=(MappedFile&& other) noexcept
+			{
+				std::swap(data, other.data);
+				std::swap(size, other.size);
+				return *this;
+			}
+
+			MappedFile(const MappedFile&) = delete;
+			MappedFile& operator=(const MappedFile&) = delete;
+
+			~MappedFile()
+			{
+				if (data == nullptr)
+					return;
+#ifdef _WIN32
+				::UnmapViewOfFile(data);
+#else
+				::munmap(const_cast<char*>(data), size);
+#endif
+			}
+
+			const char* Data() const noexcept { return data; }
+			std::size_t Size() const noexcept { return size; }
+
+		private:
+			const char* data = nullptr;
+			std::size_t size = 0;
+		};
+
+	} // namespace Detail
+
+} // namespace MapSpecial
@@ -0,0 +1,650 @@
+#pragma once
+
+/*
+Copyright(c) 2017 Julijan Šribar
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software.If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace MapSpecial
+{
+
+	namespace Detail
+	{
+		template<typename TValue>
+		struct OrderStatisticNode
+		{
+			template<typename... Args>
+			explicit OrderStatisticNode(Args&&... args) : value(std::forward<Args>(args)...) {}
+
+			TValue value;
+			OrderStatisticNode* left = nullptr;
+			OrderStatisticNode* right = nullptr;
+			OrderStatisticNode* parent = nullptr;
+			// number of nodes in the subtree rooted at this node
+			std::size_t size = 1;
+			int height = 1;
+		};
+
+	} // namespace Detail
+
+
+	// ordered map implemented as AVL tree in which each node stores the size of its subtree, so that the position
+	// of a key (rank) and the key at a given position (select) are found in logarithmic time. Provides the subset
+	// of std::map interface used by bidirectional maps; iterators stay valid until the element is erased.
+	template<typename TKey, typename TValue, typename TCompare = std::less<TKey>>
+	class OrderStatisticMap
+	{
+	public:
+		using key_type = TKey;
+		using mapped_type = TValue;
+		using value_type = std::pair<const TKey, TValue>;
+		using size_type = std::size_t;
+		using key_compare = TCompare;
+
+	private:
+		using Node = Detail::OrderStatisticNode<value_type>;
+
+		template<bool IsConst>
+		class Iterator
+		{
+		public:
+			using iterator_category = std::bidirectional_iterator_tag;
+			using value_type = typename OrderStatisticMap::value_type;
+			using difference_type = std::ptrdiff_t;
+			using pointer = typename std::conditional<IsConst, const value_type*, value_type*>::type;
+			using reference = typename std::conditional<IsConst, const value_type&, value_type&>::type;
+
+			Iterator() = default;
+
+			// conversion of iterator to const_iterator
+			template<bool OtherIsConst, typename = typename std::enable_if<IsConst && !OtherIsConst>::type>
+			Iterator(const Iterator<OtherIsConst>& other) : node(other.node), map(other.map) {}
+
+			reference operator*() const { return node->value; }
+			pointer operator->() const { return &node->value; }
+
+			Iterator& operator++()
+			{
+				node = OrderStatisticMap::Next(node);
+				return *this;
+			}
+
+			Iterator operator++(int)
+			{
+				Iterator old(*this);
+				++*this;
+				return old;
+			}
+
+			// decrementing end iterator moves to the last element
+			Iterator& operator--()
+			{
+				node = node == nullptr ? OrderStatisticMap::Rightmost(map->root) : OrderStatisticMap::Previous(node);
+				return *this;
+			}
+
+			Iterator operator--(int)
+			{
+				Iterator old(*this);
+				--*this;
+				return old;
+			}
+
+			// iterators compare equal to const_iterators, as in standard containers
+			template<bool OtherIsConst>
+			bool operator==(const Iterator<OtherIsConst>& other) const { return node == other.node; }
+			template<bool OtherIsConst>
+			bool operator!=(const Iterator<OtherIsConst>& other) const { return node != other.node; }
+
+		private:
+			friend class OrderStatisticMap;
+			template<bool> friend class Iterator;
+
+			Iterator(Node* node, const OrderStatisticMap* map) : node(node), map(map) {}
+
+			Node* node = nullptr;
+			const OrderStatisticMap* map = nullptr;
+		};
+
+	public:
+		using iterator = Iterator<false>;
+		using const_iterator = Iterator<true>;
+
+		// element detached from the map, which can be inserted into another map without allocation
+		class node_type
+		{
+		public:
+			node_type() = default;
+
+			node_type(node_type&& other) noexcept
+				: node(other.node)
+			{
+				other.node = nullptr;
+			}
+
+			node_type& operator=(node_type&& other) noexcept
+			{
+				std::swap(node, other.node);
+				return *this;
+			}
+
+			~node_type()
+			{
+				delete node;
+			}
+
+			bool empty() const noexcept { return node == nullptr; }
+			explicit operator bool() const noexcept { return node != nullptr; }
+
+			const key_type& key() const noexcept { return node->value.first; }
+			mapped_type& mapped() const noexcept { return node->value.second; }
+
+		private:
+			friend class OrderStatisticMap;
+
+			explicit node_type(Node* node) noexcept : node(node) {}
+
+			Node* node = nullptr;
+		};
+
+		struct insert_return_type
+		{
+			iterator position;
+			bool inserted;
+			node_type node;
+		};
+
+		explicit OrderStatisticMap(const TCompare& compare = TCompare())
+			: compare(compare)
+		{
+		}
+
+		// copy constructor clones the tree structure, so no keys are compared
+		OrderStatisticMap(const OrderStatisticMap& other)
+			: compare(other.compare)
+			, root(Clone(other.root, nullptr))
+		{
+		}
+
+		OrderStatisticMap(OrderStatisticMap&& other) noexcept
+			: compare(std::move(other.compare))
+			, root(other.root)
+		{
+			other.root = nullptr;
+		}
+
+		OrderStatisticMap& operator=(const OrderStatisticMap& other)
+		{
+			if (this != &other)
+			{
+				OrderStatisticMap copy(other);
+				swap(copy);
+			}
+			return *this;
+		}
+
+		OrderStatisticMap& operator=(OrderStatisticMap&& other) noexcept
+		{
+			swap(other);
+			return *this;
+		}
+
+		~OrderStatisticMap()
+		{
+			Destroy(root);
+		}
+
+		void swap(OrderStatisticMap& other) noexcept
+		{
+			std::swap(compare, other.compare);
+			std::swap(root, other.root);
+		}
+
+		iterator begin() noexcept { return iterator(Leftmost(root), this); }
+		const_iterator begin() const noexcept { return const_iterator(Leftmost(root), this); }
+		const_iterator cbegin() const noexcept { return begin(); }
+		iterator end() noexcept { return iterator(nullptr, this); }
+		const_iterator end() const noexcept { return const_iterator(nullptr, this); }
+		const_iterator cend() const noexcept { return end(); }
+
+		size_type size() const noexcept { return Size(root); }
+		bool empty() const noexcept { return root == nullptr; }
+		key_compare key_comp() const { return compare; }
+
+		void clear() noexcept
+		{
+			Destroy(root);
+			root = nullptr;
+		}
+
+		// insert the element constructed from arguments unless an element with equal key exists
+		template<typename... Args>
+		std::pair<iterator, bool> emplace(Args&&... args)
+		{
+			std::unique_ptr<Node> node(new Node(std::forward<Args>(args)...));
+			auto result = Link(node.get());
+			if (result.second)
+				node.release();
+			return { iterator(result.first, this), result.second };
+		}
+
+		// detach the element from the map without deallocating it
+		node_type extract(const_iterator position) noexcept
+		{
+			Node* node = position.node;
+			Unlink(node);
+			node->left = node->right = node->parent = nullptr;
+			node->size = 1;
+			node->height = 1;
+			return node_type(node);
+		}
+
+		node_type extract(const key_type& key)
+		{
+			Node* node = FindNode(key);
+			if (node == nullptr)
+				return node_type();
+			return extract(const_iterator(node, this));
+		}
+
+		// insert detached element; if an element with equal key exists, ownership stays with returned node
+		insert_return_type insert(node_type&& handle)
+		{
+			if (handle.empty())
+				return { end(), false, node_type() };
+			auto result = Link(handle.node);
+			if (!result.second)
+				return { iterator(result.first, this), false, std::move(handle) };
+			handle.node = nullptr;
+			return { iterator(result.first, this), true, node_type() };
+		}
+
+		iterator find(const key_type& key) { return iterator(FindNode(key), this); }
+		const_iterator find(const key_type& key) const { return const_iterator(FindNode(key), this); }
+
+		size_type count(const key_type& key) const { return FindNode(key) != nullptr ? 1 : 0; }
+
+		mapped_type& at(const key_type& key)
+		{
+			Node* node = FindNode(key);
+			if (node == nullptr)
+				throw std::out_of_range("Key does not exist in the map.");
+			return node->value.second;
+		}
+
+		const mapped_type& at(const key_type& key) const
+		{
+			Node* node = FindNode(key);
+			if (node == nullptr)
+				throw std::out_of_range("Key does not exist in the map.");
+			return node->value.second;
+		}
+
+		iterator lower_bound(const key_type& key) { return iterator(LowerBound(key), this); }
+		const_iterator lower_bound(const key_type& key) const { return const_iterator(LowerBound(key), this); }
+		iterator upper_bound(const key_type& key) { return iterator(UpperBound(key), this); }
+		const_iterator upper_bound(const key_type& key) const { return const_iterator(UpperBound(key), this); }
+
+		// erase the element and return iterator to the following one
+		iterator erase(const_iterator position)
+		{
+			Node* node = position.node;
+			Node* next = Next(node);
+			Unlink(node);
+			delete node;
+			return iterator(next, this);
+		}
+
+		iterator erase(iterator position)
+		{
+			return erase(const_iterator(position));
+		}
+
+		size_type erase(const key_type& key)
+		{
+			Node* node = FindNode(key);
+			if (node == nullptr)
+				return 0;
+			Unlink(node);
+			delete node;
+			return 1;
+		}
+
+		// number of elements preceding the element; for end iterator it is the size of the map
+		size_type rank(const_iterator position) const noexcept
+		{
+			Node* node = position.node;
+			if (node == nullptr)
+				return size();
+			size_type result = Size(node->left);
+			for (; node->parent != nullptr; node = node->parent)
+			{
+				if (node == node->parent->right)
+					result += Size(node->parent->left) + 1;
+			}
+			return result;
+		}
+
+		// element at given position in key order, or end iterator if position is not less than size
+		iterator select(size_type position) noexcept { return iterator(Select(position), this); }
+		const_iterator select(size_type position) const noexcept { return const_iterator(Select(position), this); }
+
+	private:
+		TCompare compare;
+		Node* root = nullptr;
+
+		static std::size_t Size(const Node* node) noexcept { return node != nullptr ? node->size : 0; }
+		static int Height(const Node* node) noexcept { return node != nullptr ? node->height : 0; }
+
+		static void Update(Node* node) noexcept
+		{
+			node->size = Size(node->left) + Size(node->right) + 1;
+			node->height = (std::max)(Height(node->left), Height(node->right)) + 1;
+		}
+
+		static Node* Leftmost(Node* node) noexcept
+		{
+			if (node != nullptr)
+			{
+				while (node->left != nullptr)
+					node = node->left;
+			}
+			return node;
+		}
+
+		static Node* Rightmost(Node* node) noexcept
+		{
+			if (node != nullptr)
+			{
+				while (node->right != nullptr)
+					node = node->right;
+			}
+			return node;
+		}
+
+		static Node* Next(Node* node) noexcept
+		{
+			if (node->right != nullptr)
+				return Leftmost(node->right);
+			while (node->parent != nullptr && node == node->parent->right)
+				node = node->parent;
+			return node->parent;
+		}
+
+		static Node* Previous(Node* node) noexcept
+		{
+			if (node->left != nullptr)
+				return Rightmost(node->left);
+			while (node->parent != nullptr && node == node->parent->left)
+				node = node->parent;
+			return node->parent;
+		}
+
+		static Node* Clone(const Node* node, Node* parent)
+		{
+			if (node == nullptr)
+				return nullptr;
+			Node* clone = new Node(node->value);
+			clone->parent = parent;
+			clone->size = node->size;
+			clone->height = node->height;
+			try
+			{
+				clone->left = Clone(node->left, clone);
+				clone->right = Clone(node->right, clone);
+			}
+			catch (...)
+			{
+				Destroy(clone);
+				throw;
+			}
+			return clone;
+		}
+
+		static void Destroy(Node* node) noexcept
+		{
+			while (node != nullptr)
+			{
+				Destroy(node->right);
+				Node* left = node->left;
+				delete node;
+				node = left;
+			}
+		}
+
+		// link the node into the tree unless a node with equal key exists; returns the node with the key
+		std::pair<Node*, bool> Link(Node* node)
+		{
+			Node* parent = nullptr;
+			Node** link = &root;
+			// like in std::map, keys are compared once per level and equality is checked only at the end;
+			// sizes along the path are increased while descending and restored if the key exists
+			Node* candidate = nullptr;
+			bool exists;
+			try
+			{
+				while (*link != nullptr)
+				{
+					parent = *link;
+					++parent->size;
+					if (compare(parent->value.first, node->value.first))
+						link = &parent->right;
+					else
+					{
+						candidate = parent;
+						link = &parent->left;
+					}
+				}
+				exists = candidate != nullptr && !compare(node->value.first, candidate->value.first);
+			}
+			catch (...)
+			{
+				DecreaseSizes(parent);
+				throw;
+			}
+			if (exists)
+			{
+				DecreaseSizes(parent);
+				return { candidate, false };
+			}
+			node->parent = parent;
+			*link = node;
+			Retrace(parent);
+			return { node, true };
+		}
+
+		// decrease subtree sizes of the node and all its ancestors
+		static void DecreaseSizes(Node* node) noexcept
+		{
+			for (; node != nullptr; node = node->parent)
+				--node->size;
+		}
+
+		Node* FindNode(const key_type& key) const
+		{
+			Node* node = LowerBound(key);
+			return node != nullptr && !compare(key, node->value.first) ? node : nullptr;
+		}
+
+		Node* LowerBound(const key_type& key) const
+		{
+			Node* result = nullptr;
+			for (Node* node = root; node != nullptr; )
+			{
+				if (compare(node->value.first, key))
+					node = node->right;
+				else
+				{
+					result = node;
+					node = node->left;
+				}
+			}
+			return result;
+		}
+
+		Node* UpperBound(const key_type& key) const
+		{
+			Node* result = nullptr;
+			for (Node* node = root; node != nullptr; )
+			{
+				if (compare(key, node->value.first))
+				{
+					result = node;
+					node = node->left;
+				}
+				else
+					node = node->right;
+			}
+			return result;
+		}
+
+		Node* Select(size_type position) const noexcept
+		{
+			Node* node = root;
+			while (node != nullptr)
+			{
+				size_type leftSize = Size(node->left);
+				if (position < leftSize)
+					node = node->left;
+				else if (position == leftSize)
+					return node;
+				else
+				{
+					position -= leftSize + 1;
+					node = node->right;
+				}
+			}
+			return nullptr;
+		}
+
+		void ReplaceChild(Node* parent, Node* oldChild, Node* newChild) noexcept
+		{
+			if (parent == nullptr)
+				root = newChild;
+			else if (parent->left == oldChild)
+				parent->left = newChild;
+			else
+				parent->right = newChild;
+			if (newChild != nullptr)
+				newChild->parent = parent;
+		}
+
+		Node* RotateLeft(Node* node) noexcept
+		{
+			Node* pivot = node->right;
+			node->right = pivot->left;
+			if (pivot->left != nullptr)
+				pivot->left->parent = node;
+			ReplaceChild(node->parent, node, pivot);
+			pivot->left = node;
+			node->parent = pivot;
+			Update(node);
+			Update(pivot);
+			return pivot;
+		}
+
+		Node* RotateRight(Node* node) noexcept
+		{
+			Node* pivot = node->left;
+			node->left = pivot->right;
+			if (pivot->right != nullptr)
+				pivot->right->parent = node;
+			ReplaceChild(node->parent, node, pivot);
+			pivot->right = node;
+			node->parent = pivot;
+			Update(node);
+			Update(pivot);
+			return pivot;
+		}
+
+		// restore balance of the subtree and return its new root
+		Node* Rebalance(Node* node) noexcept
+		{
+			Update(node);
+			int balance = Height(node->left) - Height(node->right);
+			if (balance > 1)
+			{
+				if (Height(node->left->left) < Height(node->left->right))
+					RotateLeft(node->left);
+				return RotateRight(node);
+			}
+			if (balance < -1)
+			{
+				if (Height(node->right->right) < Height(node->right->left))
+					RotateRight(node->right);
+				return RotateLeft(node);
+			}
+			return node;
+		}
+
+		// restore balance going up from the node until the height of a subtree does not change
+		void Retrace(Node* node) noexcept
+		{
+			while (node != nullptr)
+			{
+				int height = node->height;
+				Node* subtreeRoot = Rebalance(node);
+				if (subtreeRoot == node && node->height == height)
+					return;
+				node = subtreeRoot->parent;
+			}
+		}
+
+		// detach node from the tree; other nodes are relinked rather than having their values moved,
+		// so iterators to them stay valid
+		void Unlink(Node* node) noexcept
+		{
+			Node* rebalanceFrom;
+			if (node->left != nullptr && node->right != nullptr)
+			{
+				Node* successor = Leftmost(node->right);
+				if (successor->parent != node)
+				{
+					rebalanceFrom = successor->parent;
+					ReplaceChild(successor->parent, successor, successor->right);
+					successor->right = node->right;
+					successor->right->parent = successor;
+				}
+				else
+					rebalanceFrom = successor;
+				successor->left = node->left;
+				successor->left->parent = successor;
+				successor->size = node->size;
+				successor->height = node->height;
+				ReplaceChild(node->parent, node, successor);
+			}
+			else
+			{
+				rebalanceFrom = node->parent;
+				ReplaceChild(node->parent, node, node->left != nullptr ? node->left : node->right);
+			}
+			DecreaseSizes(rebalanceFrom);
+			Retrace(rebalanceFrom);
+		}
+	};
+
+} // namespace MapSpecial
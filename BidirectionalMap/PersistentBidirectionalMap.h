@@ -0,0 +1,342 @@
+#pragma once
+
+/*
+Copyright(c) 2017 Julijan Šribar
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software.If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <algorithm>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <cassert>
+
+namespace MapSpecial
+{
+
+	namespace Detail
+	{
+		// immutable node of a persistent AVL tree; nodes are shared between versions of the tree
+		template<typename TItem> struct PersistentTreeNode
+		{
+			using Pointer = std::shared_ptr<const PersistentTreeNode>;
+
+			PersistentTreeNode(std::shared_ptr<const TItem> item, Pointer left, Pointer right)
+				: item(std::move(item))
+				, left(std::move(left))
+				, right(std::move(right))
+				, height(1 + (std::max)(Height(this->left), Height(this->right)))
+			{
+			}
+
+			static int Height(const Pointer& node) noexcept
+			{
+				return node ? node->height : 0;
+			}
+
+			std::shared_ptr<const TItem> item;
+			Pointer left;
+			Pointer right;
+			int height;
+		};
+
+		// persistent AVL tree of items ordered by the key that TKeyOf extracts from the item;
+		// every modification copies only the path from the root to the modified node
+		template<typename TItem, typename TKeyOf> class PersistentTree
+		{
+		public:
+			using Node = PersistentTreeNode<TItem>;
+			using Pointer = typename Node::Pointer;
+			using ItemPointer = std::shared_ptr<const TItem>;
+
+			template <typename TKey>
+			static const TItem* Find(const Pointer& root, const TKey& key) noexcept
+			{
+				const Node* node = root.get();
+				while (node != nullptr)
+				{
+					const auto& nodeKey = TKeyOf{}(*node->item);
+					if (key < nodeKey)
+						node = node->left.get();
+					else if (nodeKey < key)
+						node = node->right.get();
+					else
+						return node->item.get();
+				}
+				return nullptr;
+			}
+
+			// insert an item whose key does not exist in the tree
+			static Pointer Insert(const Pointer& root, const ItemPointer& item)
+			{
+				if (!root)
+					return std::make_shared<const Node>(item, nullptr, nullptr);
+				const auto& key = TKeyOf{}(*item);
+				const auto& nodeKey = TKeyOf{}(*root->item);
+				assert(key < nodeKey || nodeKey < key);
+				if (key < nodeKey)
+					return Balance(root->item, Insert(root->left, item), root->right);
+				return Balance(root->item, root->left, Insert(root->right, item));
+			}
+
+			// replace an item with another one with identical key
+			static Pointer Replace(const Pointer& root, const ItemPointer& item)
+			{
+				assert(root);
+				const auto& key = TKeyOf{}(*item);
+				const auto& nodeKey = TKeyOf{}(*root->item);
+				if (key < nodeKey)
+					return std::make_shared<const Node>(root->item, Replace(root->left, item), root->right);
+				if (nodeKey < key)
+					return std::make_shared<const Node>(root->item, root->left, Replace(root->right, item));
+				return std::make_shared<const Node>(item, root->left, root->right);
+			}
+
+			// erase the item with given key, which must exist in the tree
+			template <typename TKey>
+			static Pointer Erase(const Pointer& root, const TKey& key)
+			{
+				assert(root);
+				const auto& nodeKey = TKeyOf{}(*root->item);
+				if (key < nodeKey)
+					return Balance(root->item, Erase(root->left, key), root->right);
+				if (nodeKey < key)
+					return Balance(root->item, root->left, Erase(root->right, key));
+				return Merge(root->left, root->right);
+			}
+
+		private:
+			static Pointer Balance(const ItemPointer& item, const Pointer& left, const Pointer& right)
+			{
+				int heightLeft = Node::Height(left);
+				int heightRight = Node::Height(right);
+				if (heightLeft > heightRight + 1)
+				{
+					if (Node::Height(left->left) >= Node::Height(left->right))
+						return std::make_shared<const Node>(left->item, left->left, std::make_shared<const Node>(item, left->right, right));
+					const auto& pivot = left->right;
+					return std::make_shared<const Node>(pivot->item,
+						std::make_shared<const Node>(left->item, left->left, pivot->left),
+						std::make_shared<const Node>(item, pivot->right, right));
+				}
+				if (heightRight > heightLeft + 1)
+				{
+					if (Node::Height(right->right) >= Node::Height(right->left))
+						return std::make_shared<const Node>(right->item, std::make_shared<const Node>(item, left, right->left), right->right);
+					const auto& pivot = right->left;
+					return std::make_shared<const Node>(pivot->item,
+						std::make_shared<const Node>(item, left, pivot->left),
+						std::make_shared<const Node>(right->item, pivot->right, right->right));
+				}
+				return std::make_shared<const Node>(item, left, right);
+			}
+
+			static Pointer Merge(const Pointer& left, const Pointer& right)
+			{
+				if (!left)
+					return right;
+				if (!right)
+					return left;
+				const Node* leftmost = right.get();
+				while (leftmost->left)
+					leftmost = leftmost->left.get();
+				return Balance(leftmost->item, left, EraseLeftmost(right));
+			}
+
+			static Pointer EraseLeftmost(const Pointer& root)
+			{
+				if (!root->left)
+					return root->right;
+				return Balance(root->item, EraseLeftmost(root->left), root->right);
+			}
+		};
+
+		struct PairFirst
+		{
+			template <typename TPair>
+			const typename TPair::first_type& operator()(const TPair& pair) const noexcept { return pair.first; }
+		};
+
+		struct PairSecond
+		{
+			template <typename TPair>
+			const typename TPair::second_type& operator()(const TPair& pair) const noexcept { return pair.second; }
+		};
+
+	} // namespace Detail
+
+
+	// immutable bidirectional map; every modification returns a new version that shares
+	// unchanged keypairs and index nodes with the original, so copying a version is O(1)
+	// and modifications are O(log n). Versions can be safely shared between threads.
+	template<typename T1, typename T2>
+	class PersistentBidirectionalMap
+	{
+	public:
+		using value_type = std::pair<T1, T2>;
+
+		PersistentBidirectionalMap() = default;
+
+		// initializer list constructor
+		PersistentBidirectionalMap(std::initializer_list<value_type> il)
+		{
+			for (const auto& item : il)
+				*this = Insert(item.first, item.second);
+		}
+
+		// get a version with a new keypair inserted; identical version is returned if keypair already exists
+		template <typename Q, typename R>
+		PersistentBidirectionalMap Insert(Q&& first, R&& second) const
+		{
+			auto item = std::make_shared<const value_type>(std::forward<Q>(first), std::forward<R>(second));
+			const value_type* existing = Tree1::Find(root1, item->first);
+			if (existing != nullptr)
+			{
+				// do not perform insertion if provided keypair already exists
+				if (existing->second == item->second)
+					return *this;
+				throw std::invalid_argument("First key already exists in the map.");
+			}
+			if (SecondExists(item->second))
+				throw std::invalid_argument("Second key already exists in the map.");
+			return PersistentBidirectionalMap(Tree1::Insert(root1, item), Tree2::Insert(root2, item), size + 1);
+		}
+
+		// get a version with the first key paired to existing second key changed
+		template <typename Q, typename R>
+		PersistentBidirectionalMap ChangeFirst(Q&& first, R&& second) const
+		{
+			const value_type* existing = Tree2::Find(root2, second);
+			if (existing == nullptr)
+				throw std::out_of_range("The second key must exist in the map.");
+			auto item = std::make_shared<const value_type>(std::forward<Q>(first), existing->second);
+			const value_type* other = Tree1::Find(root1, item->first);
+			if (other != nullptr)
+			{
+				// if key is already assigned to the new first key, return identical version
+				if (other == existing)
+					return *this;
+				throw std::invalid_argument("First key is already assigned to another second key.");
+			}
+			return PersistentBidirectionalMap(Tree1::Insert(Tree1::Erase(root1, existing->first), item), Tree2::Replace(root2, item), size);
+		}
+
+		// get a version with the second key paired to existing first key changed
+		template <typename Q, typename R>
+		PersistentBidirectionalMap ChangeSecond(Q&& first, R&& second) const
+		{
+			const value_type* existing = Tree1::Find(root1, first);
+			if (existing == nullptr)
+				throw std::out_of_range("The first key must exist in the map.");
+			auto item = std::make_shared<const value_type>(existing->first, std::forward<R>(second));
+			const value_type* other = Tree2::Find(root2, item->second);
+			if (other != nullptr)
+			{
+				// if key is already assigned to the new second key, return identical version
+				if (other == existing)
+					return *this;
+				throw std::invalid_argument("Second key is already assigned to another first key.");
+			}
+			return PersistentBidirectionalMap(Tree1::Replace(root1, item), Tree2::Insert(Tree2::Erase(root2, existing->second), item), size);
+		}
+
+		// get a version without the keypair which has given first key
+		PersistentBidirectionalMap RemoveFirst(const T1& first) const
+		{
+			const value_type* existing = Tree1::Find(root1, first);
+			if (existing == nullptr)
+				throw std::out_of_range("The first key must exist in the map.");
+			return PersistentBidirectionalMap(Tree1::Erase(root1, first), Tree2::Erase(root2, existing->second), size - 1);
+		}
+
+		// get a version without the keypair which has given second key
+		PersistentBidirectionalMap RemoveSecond(const T2& second) const
+		{
+			const value_type* existing = Tree2::Find(root2, second);
+			if (existing == nullptr)
+				throw std::out_of_range("The second key must exist in the map.");
+			return PersistentBidirectionalMap(Tree1::Erase(root1, existing->first), Tree2::Erase(root2, second), size - 1);
+		}
+
+		// get an empty version
+		PersistentBidirectionalMap Clear() const noexcept
+		{
+			return PersistentBidirectionalMap();
+		}
+
+		// get number of keypairs in the map
+		size_t Size() const noexcept
+		{
+			return size;
+		}
+
+		// check if first key exists in the map
+		bool FirstExists(const T1& first) const noexcept
+		{
+			return Tree1::Find(root1, first) != nullptr;
+		}
+
+		// check if second key exists in the map
+		bool SecondExists(const T2& second) const noexcept
+		{
+			return Tree2::Find(root2, second) != nullptr;
+		}
+
+		// get the value assigned to given first key
+		const T2& AtFirst(const T1& first) const
+		{
+			const value_type* existing = Tree1::Find(root1, first);
+			if (existing == nullptr)
+				throw std::out_of_range("The first key must exist in the map.");
+			return existing->second;
+		}
+
+		// get the value assigned to given second key
+		const T1& AtSecond(const T2& second) const
+		{
+			const value_type* existing = Tree2::Find(root2, second);
+			if (existing == nullptr)
+				throw std::out_of_range("The second key must exist in the map.");
+			return existing->first;
+		}
+
+		// check if both versions share the same data
+		bool IsSameVersion(const PersistentBidirectionalMap& other) const noexcept
+		{
+			return root1 == other.root1 && root2 == other.root2;
+		}
+
+	private:
+		using Tree1 = Detail::PersistentTree<value_type, Detail::PairFirst>;
+		using Tree2 = Detail::PersistentTree<value_type, Detail::PairSecond>;
+
+		typename Tree1::Pointer root1;
+		typename Tree2::Pointer root2;
+		size_t size = 0;
+
+		PersistentBidirectionalMap(typename Tree1::Pointer root1, typename Tree2::Pointer root2, size_t size)
+			: root1(std::move(root1))
+			, root2(std::move(root2))
+			, size(size)
+		{
+		}
+
+	}; // class PersistentBidirectionalMap
+
+} // namespace MapSpecial
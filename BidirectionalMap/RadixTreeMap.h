@@ -0,0 +1,1085 @@
+#pragma once
+
+/*
+Copyright(c) 2017 Julijan Šribar
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software.If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+// Adaptive radix tree (ART) over the bytes of string keys. Each inner node branches on one byte of the key and
+// has room for 4, 16, 48 or 256 children, growing and shrinking with the number of children it has. Bytes shared
+// by all keys below a node are stored in the node as its prefix and skipped without branching, and a subtree with
+// a single key is replaced by the leaf with that key. Looking up a key therefore costs one step per branching
+// byte and one comparison of the key at the leaf, independently of the number of keys in the tree. Leaves are
+// linked in key order, so iterating the tree and finding keys that start with a prefix do not walk inner nodes.
+
+namespace MapSpecial
+{
+
+	namespace Detail
+	{
+		enum class RadixNodeKind : std::uint8_t
+		{
+			Leaf,
+			Node4,
+			Node16,
+			Node48,
+			Node256
+		};
+
+		struct RadixNode
+		{
+			explicit RadixNode(RadixNodeKind kind) noexcept : kind(kind) {}
+
+			RadixNodeKind kind;
+		};
+
+		// inner node; the key that ends after the prefix of the node is its terminal leaf, longer keys are found
+		// in the child for their next byte
+		struct RadixInnerNode : RadixNode
+		{
+			explicit RadixInnerNode(RadixNodeKind kind) noexcept : RadixNode(kind) {}
+
+			std::string prefix;
+			RadixNode* terminal = nullptr;
+			unsigned count = 0;
+		};
+
+		// children ordered by their bytes
+		struct RadixNode4 : RadixInnerNode
+		{
+			RadixNode4() noexcept : RadixInnerNode(RadixNodeKind::Node4) {}
+
+			unsigned char bytes[4] = {};
+			RadixNode* children[4] = {};
+		};
+
+		struct RadixNode16 : RadixInnerNode
+		{
+			RadixNode16() noexcept : RadixInnerNode(RadixNodeKind::Node16) {}
+
+			unsigned char bytes[16] = {};
+			RadixNode* children[16] = {};
+		};
+
+		// children in arbitrary slots; for each byte, index of its slot increased by one, or zero
+		struct RadixNode48 : RadixInnerNode
+		{
+			RadixNode48() noexcept : RadixInnerNode(RadixNodeKind::Node48) {}
+
+			unsigned char slots[256] = {};
+			RadixNode* children[48] = {};
+		};
+
+		struct RadixNode256 : RadixInnerNode
+		{
+			RadixNode256() noexcept : RadixInnerNode(RadixNodeKind::Node256) {}
+
+			RadixNode* children[256] = {};
+		};
+
+		inline void DeleteRadixNode(RadixInnerNode* node) noexcept
+		{
+			switch (node->kind)
+			{
+			case RadixNodeKind::Node4: delete static_cast<RadixNode4*>(node); break;
+			case RadixNodeKind::Node16: delete static_cast<RadixNode16*>(node); break;
+			case RadixNodeKind::Node48: delete static_cast<RadixNode48*>(node); break;
+			default: delete static_cast<RadixNode256*>(node); break;
+			}
+		}
+
+		// position of the byte among sorted bytes of a node with 16 children, or count if it is not there
+		inline unsigned FindRadixByte(const RadixNode16* node, unsigned char byte) noexcept
+		{
+#if defined(__SSE2__) || defined(_M_X64)
+			__m128i matches = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(node->bytes)));
+			unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(matches)) & ((1u << node->count) - 1);
+			if (mask == 0)
+				return node->count;
+			unsigned position = 0;
+			while ((mask & 1) == 0)
+			{
+				mask >>= 1;
+				++position;
+			}
+			return position;
+#else
+			unsigned position = 0;
+			while (position < node->count && node->bytes[position] != byte)
+				++position;
+			return position;
+#endif
+		}
+
+		// link to the child for given byte, or null if there is no such child
+		inline RadixNode** FindRadixChild(RadixInnerNode* node, unsigned char byte) noexcept
+		{
+			switch (node->kind)
+			{
+			case RadixNodeKind::Node4:
+			{
+				auto node4 = static_cast<RadixNode4*>(node);
+				for (unsigned i = 0; i < node4->count; ++i)
+				{
+					if (node4->bytes[i] == byte)
+						return &node4->children[i];
+				}
+				return nullptr;
+			}
+			case RadixNodeKind::Node16:
+			{
+				auto node16 = static_cast<RadixNode16*>(node);
+				unsigned position = FindRadixByte(node16, byte);
+				return position < node16->count ? &node16->children[position] : nullptr;
+			}
+			case RadixNodeKind::Node48:
+			{
+				auto node48 = static_cast<RadixNode48*>(node);
+				return node48->slots[byte] != 0 ? &node48->children[node48->slots[byte] - 1] : nullptr;
+			}
+			default:
+			{
+				auto node256 = static_cast<RadixNode256*>(node);
+				return node256->children[byte] != nullptr ? &node256->children[byte] : nullptr;
+			}
+			}
+		}
+
+		// child with the smallest byte greater than given byte; the first child if byte is negative
+		inline RadixNode* NextRadixChild(const RadixInnerNode* node, int byte) noexcept
+		{
+			switch (node->kind)
+			{
+			case RadixNodeKind::Node4:
+			{
+				auto node4 = static_cast<const RadixNode4*>(node);
+				for (unsigned i = 0; i < node4->count; ++i)
+				{
+					if (node4->bytes[i] > byte)
+						return node4->children[i];
+				}
+				return nullptr;
+			}
+			case RadixNodeKind::Node16:
+			{
+				auto node16 = static_cast<const RadixNode16*>(node);
+				for (unsigned i = 0; i < node16->count; ++i)
+				{
+					if (node16->bytes[i] > byte)
+						return node16->children[i];
+				}
+				return nullptr;
+			}
+			case RadixNodeKind::Node48:
+			{
+				auto node48 = static_cast<const RadixNode48*>(node);
+				for (int i = byte + 1; i < 256; ++i)
+				{
+					if (node48->slots[i] != 0)
+						return node48->children[node48->slots[i] - 1];
+				}
+				return nullptr;
+			}
+			default:
+			{
+				auto node256 = static_cast<const RadixNode256*>(node);
+				for (int i = byte + 1; i < 256; ++i)
+				{
+					if (node256->children[i] != nullptr)
+						return node256->children[i];
+				}
+				return nullptr;
+			}
+			}
+		}
+
+		// call the function with byte and child for all children in the order of their bytes
+		template<typename TFunction>
+		void ForEachRadixChild(const RadixInnerNode* node, TFunction function)
+		{
+			switch (node->kind)
+			{
+			case RadixNodeKind::Node4:
+			{
+				auto node4 = static_cast<const RadixNode4*>(node);
+				for (unsigned i = 0; i < node4->count; ++i)
+					function(node4->bytes[i], node4->children[i]);
+				break;
+			}
+			case RadixNodeKind::Node16:
+			{
+				auto node16 = static_cast<const RadixNode16*>(node);
+				for (unsigned i = 0; i < node16->count; ++i)
+					function(node16->bytes[i], node16->children[i]);
+				break;
+			}
+			case RadixNodeKind::Node48:
+			{
+				auto node48 = static_cast<const RadixNode48*>(node);
+				for (unsigned i = 0; i < 256; ++i)
+				{
+					if (node48->slots[i] != 0)
+						function(static_cast<unsigned char>(i), node48->children[node48->slots[i] - 1]);
+				}
+				break;
+			}
+			default:
+			{
+				auto node256 = static_cast<const RadixNode256*>(node);
+				for (unsigned i = 0; i < 256; ++i)
+				{
+					if (node256->children[i] != nullptr)
+						function(static_cast<unsigned char>(i), node256->children[i]);
+				}
+				break;
+			}
+			}
+		}
+
+		inline bool IsRadixNodeFull(const RadixInnerNode* node) noexcept
+		{
+			switch (node->kind)
+			{
+			case RadixNodeKind::Node4: return node->count == 4;
+			case RadixNodeKind::Node16: return node->count == 16;
+			case RadixNodeKind::Node48: return node->count == 48;
+			default: return false;
+			}
+		}
+
+		// add child for a byte that has no child yet to a node that is not full
+		inline void AddRadixChild(RadixInnerNode* node, unsigned char byte, RadixNode* child) noexcept
+		{
+			switch (node->kind)
+			{
+			case RadixNodeKind::Node4:
+			case RadixNodeKind::Node16:
+			{
+				unsigned char* bytes = node->kind == RadixNodeKind::Node4 ? static_cast<RadixNode4*>(node)->bytes : static_cast<RadixNode16*>(node)->bytes;
+				RadixNode** children = node->kind == RadixNodeKind::Node4 ? static_cast<RadixNode4*>(node)->children : static_cast<RadixNode16*>(node)->children;
+				unsigned position = node->count;
+				for (; position > 0 && bytes[position - 1] > byte; --position)
+				{
+					bytes[position] = bytes[position - 1];
+					children[position] = children[position - 1];
+				}
+				bytes[position] = byte;
+				children[position] = child;
+				break;
+			}
+			case RadixNodeKind::Node48:
+			{
+				auto node48 = static_cast<RadixNode48*>(node);
+				unsigned slot = 0;
+				while (node48->children[slot] != nullptr)
+					++slot;
+				node48->children[slot] = child;
+				node48->slots[byte] = static_cast<unsigned char>(slot + 1);
+				break;
+			}
+			default:
+				static_cast<RadixNode256*>(node)->children[byte] = child;
+				break;
+			}
+			++node->count;
+		}
+
+		inline void RemoveRadixChild(RadixInnerNode* node, unsigned char byte) noexcept
+		{
+			switch (node->kind)
+			{
+			case RadixNodeKind::Node4:
+			case RadixNodeKind::Node16:
+			{
+				unsigned char* bytes = node->kind == RadixNodeKind::Node4 ? static_cast<RadixNode4*>(node)->bytes : static_cast<RadixNode16*>(node)->bytes;
+				RadixNode** children = node->kind == RadixNodeKind::Node4 ? static_cast<RadixNode4*>(node)->children : static_cast<RadixNode16*>(node)->children;
+				unsigned position = 0;
+				while (bytes[position] != byte)
+					++position;
+				for (; position + 1 < node->count; ++position)
+				{
+					bytes[position] = bytes[position + 1];
+					children[position] = children[position + 1];
+				}
+				children[position] = nullptr;
+				break;
+			}
+			case RadixNodeKind::Node48:
+			{
+				auto node48 = static_cast<RadixNode48*>(node);
+				node48->children[node48->slots[byte] - 1] = nullptr;
+				node48->slots[byte] = 0;
+				break;
+			}
+			default:
+				static_cast<RadixNode256*>(node)->children[byte] = nullptr;
+				break;
+			}
+			--node->count;
+		}
+
+		// move prefix, terminal leaf and children of a node into a new node of another size and delete the node
+		template<typename TTo>
+		TTo* ResizeRadixNode(RadixInnerNode* node)
+		{
+			auto resized = new TTo();
+			resized->prefix.swap(node->prefix);
+			resized->terminal = node->terminal;
+			ForEachRadixChild(node, [resized](unsigned char byte, RadixNode* child) { AddRadixChild(resized, byte, child); });
+			DeleteRadixNode(node);
+			return resized;
+		}
+
+		// replace a full node with a larger one
+		inline void GrowRadixNode(RadixNode*& link)
+		{
+			auto node = static_cast<RadixInnerNode*>(link);
+			switch (node->kind)
+			{
+			case RadixNodeKind::Node4: link = ResizeRadixNode<RadixNode16>(node); break;
+			case RadixNodeKind::Node16: link = ResizeRadixNode<RadixNode48>(node); break;
+			default: link = ResizeRadixNode<RadixNode256>(node); break;
+			}
+		}
+
+		// after a child or the terminal leaf has been removed, replace the node by its only remaining entry, or
+		// by a smaller node if it has few children left. Nodes shrink at fewer children than they grow, so that
+		// alternating insertion and removal does not resize them every time. If memory cannot be allocated, the
+		// node is left as it is, which is still a valid tree.
+		inline void CompactRadixNode(RadixNode*& link) noexcept
+		{
+			auto node = static_cast<RadixInnerNode*>(link);
+			if (node->count == 0)
+			{
+				link = node->terminal;
+				DeleteRadixNode(node);
+				return;
+			}
+			if (node->count == 1 && node->terminal == nullptr)
+			{
+				unsigned char byte = 0;
+				RadixNode* child = nullptr;
+				ForEachRadixChild(node, [&](unsigned char childByte, RadixNode* onlyChild) { byte = childByte; child = onlyChild; });
+				try
+				{
+					if (child->kind != RadixNodeKind::Leaf)
+					{
+						// the prefix of the child is extended by the prefix of the node and the byte between them
+						auto inner = static_cast<RadixInnerNode*>(child);
+						std::string prefix;
+						prefix.reserve(node->prefix.size() + 1 + inner->prefix.size());
+						prefix.append(node->prefix).push_back(static_cast<char>(byte));
+						prefix.append(inner->prefix);
+						inner->prefix.swap(prefix);
+					}
+				}
+				catch (...)
+				{
+					return;
+				}
+				link = child;
+				DeleteRadixNode(node);
+				return;
+			}
+			try
+			{
+				if (node->kind == RadixNodeKind::Node16 && node->count <= 3)
+					link = ResizeRadixNode<RadixNode4>(node);
+				else if (node->kind == RadixNodeKind::Node48 && node->count <= 12)
+					link = ResizeRadixNode<RadixNode16>(node);
+				else if (node->kind == RadixNodeKind::Node256 && node->count <= 37)
+					link = ResizeRadixNode<RadixNode48>(node);
+			}
+			catch (...)
+			{
+			}
+		}
+
+		template<typename TValue>
+		struct RadixLeaf : RadixNode
+		{
+			template<typename... Args>
+			explicit RadixLeaf(Args&&... args) : RadixNode(RadixNodeKind::Leaf), value(std::forward<Args>(args)...) {}
+
+			TValue value;
+			RadixLeaf* previous = nullptr;
+			RadixLeaf* next = nullptr;
+		};
+
+	} // namespace Detail
+
+
+	// ordered map implemented as adaptive radix tree over the bytes of keys, which TBytes returns as string_view.
+	// Keys are ordered as their bytes compared as unsigned characters, i.e. as std::string compares them.
+	// Provides the subset of std::map interface used by bidirectional maps and finds all keys that start with
+	// a prefix; iterators stay valid until the element is erased.
+	template<typename TKey, typename TValue, typename TBytes>
+	class RadixTreeMap
+	{
+	public:
+		using key_type = TKey;
+		using mapped_type = TValue;
+		using value_type = std::pair<const TKey, TValue>;
+		using size_type = std::size_t;
+
+		struct key_compare
+		{
+			bool operator()(const TKey& key1, const TKey& key2) const { return TBytes{}(key1) < TBytes{}(key2); }
+		};
+
+	private:
+		using Leaf = Detail::RadixLeaf<value_type>;
+		using Node = Detail::RadixNode;
+		using InnerNode = Detail::RadixInnerNode;
+
+		template<bool IsConst>
+		class Iterator
+		{
+		public:
+			using iterator_category = std::bidirectional_iterator_tag;
+			using value_type = typename RadixTreeMap::value_type;
+			using difference_type = std::ptrdiff_t;
+			using pointer = typename std::conditional<IsConst, const value_type*, value_type*>::type;
+			using reference = typename std::conditional<IsConst, const value_type&, value_type&>::type;
+
+			Iterator() = default;
+
+			// conversion of iterator to const_iterator
+			template<bool OtherIsConst, typename = typename std::enable_if<IsConst && !OtherIsConst>::type>
+			Iterator(const Iterator<OtherIsConst>& other) : leaf(other.leaf), map(other.map) {}
+
+			reference operator*() const { return leaf->value; }
+			pointer operator->() const { return &leaf->value; }
+
+			Iterator& operator++()
+			{
+				leaf = leaf->next;
+				return *this;
+			}
+
+			Iterator operator++(int)
+			{
+				Iterator old(*this);
+				++*this;
+				return old;
+			}
+
+			// decrementing end iterator moves to the last element
+			Iterator& operator--()
+			{
+				leaf = leaf == nullptr ? map->last : leaf->previous;
+				return *this;
+			}
+
+			Iterator operator--(int)
+			{
+				Iterator old(*this);
+				--*this;
+				return old;
+			}
+
+			bool operator==(const Iterator& other) const { return leaf == other.leaf; }
+			bool operator!=(const Iterator& other) const { return leaf != other.leaf; }
+
+		private:
+			friend class RadixTreeMap;
+			template<bool> friend class Iterator;
+
+			Iterator(Leaf* leaf, const RadixTreeMap* map) : leaf(leaf), map(map) {}
+
+			Leaf* leaf = nullptr;
+			const RadixTreeMap* map = nullptr;
+		};
+
+	public:
+		using iterator = Iterator<false>;
+		using const_iterator = Iterator<true>;
+
+		// element detached from the map, which can be inserted into another map without allocation
+		class node_type
+		{
+		public:
+			node_type() = default;
+
+			node_type(node_type&& other) noexcept
+				: leaf(other.leaf)
+			{
+				other.leaf = nullptr;
+			}
+
+			node_type& operator=(node_type&& other) noexcept
+			{
+				std::swap(leaf, other.leaf);
+				return *this;
+			}
+
+			~node_type()
+			{
+				delete leaf;
+			}
+
+			bool empty() const noexcept { return leaf == nullptr; }
+			explicit operator bool() const noexcept { return leaf != nullptr; }
+
+			const key_type& key() const noexcept { return leaf->value.first; }
+			mapped_type& mapped() const noexcept { return leaf->value.second; }
+
+		private:
+			friend class RadixTreeMap;
+
+			explicit node_type(Leaf* leaf) noexcept : leaf(leaf) {}
+
+			Leaf* leaf = nullptr;
+		};
+
+		struct insert_return_type
+		{
+			iterator position;
+			bool inserted;
+			node_type node;
+		};
+
+		RadixTreeMap() = default;
+
+		// copy constructor clones the tree structure, so no keys are compared
+		RadixTreeMap(const RadixTreeMap& other)
+		{
+			try
+			{
+				if (other.root != nullptr)
+					root = Clone(other.root);
+			}
+			catch (...)
+			{
+				clear();
+				throw;
+			}
+		}
+
+		RadixTreeMap(RadixTreeMap&& other) noexcept
+		{
+			swap(other);
+		}
+
+		RadixTreeMap& operator=(const RadixTreeMap& other)
+		{
+			if (this != &other)
+			{
+				RadixTreeMap copy(other);
+				swap(copy);
+			}
+			return *this;
+		}
+
+		RadixTreeMap& operator=(RadixTreeMap&& other) noexcept
+		{
+			swap(other);
+			return *this;
+		}
+
+		~RadixTreeMap()
+		{
+			clear();
+		}
+
+		void swap(RadixTreeMap& other) noexcept
+		{
+			std::swap(root, other.root);
+			std::swap(first, other.first);
+			std::swap(last, other.last);
+			std::swap(elementCount, other.elementCount);
+		}
+
+		iterator begin() noexcept { return iterator(first, this); }
+		const_iterator begin() const noexcept { return const_iterator(first, this); }
+		const_iterator cbegin() const noexcept { return begin(); }
+		iterator end() noexcept { return iterator(nullptr, this); }
+		const_iterator end() const noexcept { return const_iterator(nullptr, this); }
+		const_iterator cend() const noexcept { return end(); }
+
+		size_type size() const noexcept { return elementCount; }
+		bool empty() const noexcept { return elementCount == 0; }
+		key_compare key_comp() const { return key_compare(); }
+
+		void clear() noexcept
+		{
+			if (root != nullptr && root->kind != Detail::RadixNodeKind::Leaf)
+				Destroy(static_cast<InnerNode*>(root));
+			for (Leaf* leaf = first; leaf != nullptr; )
+			{
+				Leaf* next = leaf->next;
+				delete leaf;
+				leaf = next;
+			}
+			root = nullptr;
+			first = last = nullptr;
+			elementCount = 0;
+		}
+
+		// insert the element constructed from arguments unless an element with equal key exists
+		template<typename... Args>
+		std::pair<iterator, bool> emplace(Args&&... args)
+		{
+			std::unique_ptr<Leaf> leaf(new Leaf(std::forward<Args>(args)...));
+			auto result = Link(leaf.get());
+			if (result.second)
+				leaf.release();
+			return { iterator(result.first, this), result.second };
+		}
+
+		// detach the element from the map without deallocating it
+		node_type extract(const_iterator position) noexcept
+		{
+			Leaf* leaf = position.leaf;
+			Unlink(leaf);
+			return node_type(leaf);
+		}
+
+		node_type extract(const key_type& key)
+		{
+			Leaf* leaf = FindLeaf(TBytes{}(key));
+			if (leaf == nullptr)
+				return node_type();
+			return extract(const_iterator(leaf, this));
+		}
+
+		// insert detached element; if an element with equal key exists, ownership stays with returned node
+		insert_return_type insert(node_type&& handle)
+		{
+			if (handle.empty())
+				return { end(), false, node_type() };
+			auto result = Link(handle.leaf);
+			if (!result.second)
+				return { iterator(result.first, this), false, std::move(handle) };
+			handle.leaf = nullptr;
+			return { iterator(result.first, this), true, node_type() };
+		}
+
+		iterator find(const key_type& key) { return iterator(FindLeaf(TBytes{}(key)), this); }
+		const_iterator find(const key_type& key) const { return const_iterator(FindLeaf(TBytes{}(key)), this); }
+
+		size_type count(const key_type& key) const { return FindLeaf(TBytes{}(key)) != nullptr ? 1 : 0; }
+
+		mapped_type& at(const key_type& key)
+		{
+			Leaf* leaf = FindLeaf(TBytes{}(key));
+			if (leaf == nullptr)
+				throw std::out_of_range("Key does not exist in the map.");
+			return leaf->value.second;
+		}
+
+		const mapped_type& at(const key_type& key) const
+		{
+			Leaf* leaf = FindLeaf(TBytes{}(key));
+			if (leaf == nullptr)
+				throw std::out_of_range("Key does not exist in the map.");
+			return leaf->value.second;
+		}
+
+		iterator lower_bound(const key_type& key) { return iterator(LowerBound(TBytes{}(key)), this); }
+		const_iterator lower_bound(const key_type& key) const { return const_iterator(LowerBound(TBytes{}(key)), this); }
+		iterator upper_bound(const key_type& key) { return iterator(UpperBound(TBytes{}(key)), this); }
+		const_iterator upper_bound(const key_type& key) const { return const_iterator(UpperBound(TBytes{}(key)), this); }
+
+		// elements with keys that start with the prefix; the subtree of the prefix is found in one descent and its
+		// leaves are consecutive in the list of leaves
+		std::pair<iterator, iterator> prefix_range(std::string_view prefix)
+		{
+			auto range = PrefixRange(prefix);
+			return { iterator(range.first, this), iterator(range.second, this) };
+		}
+
+		std::pair<const_iterator, const_iterator> prefix_range(std::string_view prefix) const
+		{
+			auto range = PrefixRange(prefix);
+			return { const_iterator(range.first, this), const_iterator(range.second, this) };
+		}
+
+		// erase the element and return iterator to the following one
+		iterator erase(const_iterator position)
+		{
+			Leaf* leaf = position.leaf;
+			Leaf* next = leaf->next;
+			Unlink(leaf);
+			delete leaf;
+			return iterator(next, this);
+		}
+
+		iterator erase(iterator position)
+		{
+			return erase(const_iterator(position));
+		}
+
+		size_type erase(const key_type& key)
+		{
+			Leaf* leaf = FindLeaf(TBytes{}(key));
+			if (leaf == nullptr)
+				return 0;
+			Unlink(leaf);
+			delete leaf;
+			return 1;
+		}
+
+	private:
+		Node* root = nullptr;
+		// leaves in key order
+		Leaf* first = nullptr;
+		Leaf* last = nullptr;
+		size_type elementCount = 0;
+
+		static std::string_view KeyOf(const Leaf* leaf) noexcept(noexcept(TBytes{}(leaf->value.first)))
+		{
+			return TBytes{}(leaf->value.first);
+		}
+
+		// number of equal bytes of two keys from given position on
+		static std::size_t CommonLength(std::string_view key1, std::string_view key2, std::size_t position) noexcept
+		{
+			std::size_t length = key1.size() < key2.size() ? key1.size() : key2.size();
+			while (position < length && key1[position] == key2[position])
+				++position;
+			return position;
+		}
+
+		// leaf with the smallest key in the subtree
+		static Leaf* FirstLeaf(Node* node) noexcept
+		{
+			while (node != nullptr && node->kind != Detail::RadixNodeKind::Leaf)
+			{
+				auto inner = static_cast<InnerNode*>(node);
+				node = inner->terminal != nullptr ? inner->terminal : Detail::NextRadixChild(inner, -1);
+			}
+			return static_cast<Leaf*>(node);
+		}
+
+		// clone the subtree; inner nodes are visited in key order, so cloned leaves are appended to the list of
+		// leaves. If cloning fails, cloned inner nodes are deleted and cloned leaves are left in the list.
+		Node* Clone(const Node* node)
+		{
+			if (node->kind == Detail::RadixNodeKind::Leaf)
+			{
+				Leaf* leaf = new Leaf(static_cast<const Leaf*>(node)->value);
+				leaf->previous = last;
+				if (last != nullptr)
+					last->next = leaf;
+				else
+					first = leaf;
+				last = leaf;
+				++elementCount;
+				return leaf;
+			}
+			auto inner = static_cast<const InnerNode*>(node);
+			InnerNode* clone;
+			switch (inner->kind)
+			{
+			case Detail::RadixNodeKind::Node4: clone = new Detail::RadixNode4(); break;
+			case Detail::RadixNodeKind::Node16: clone = new Detail::RadixNode16(); break;
+			case Detail::RadixNodeKind::Node48: clone = new Detail::RadixNode48(); break;
+			default: clone = new Detail::RadixNode256(); break;
+			}
+			try
+			{
+				clone->prefix = inner->prefix;
+				// terminal key is a prefix of all keys in the children, so it precedes them
+				if (inner->terminal != nullptr)
+					clone->terminal = Clone(inner->terminal);
+				Detail::ForEachRadixChild(inner, [this, clone](unsigned char byte, Node* child) { Detail::AddRadixChild(clone, byte, Clone(child)); });
+			}
+			catch (...)
+			{
+				Destroy(clone);
+				throw;
+			}
+			return clone;
+		}
+
+		static void Destroy(InnerNode* node) noexcept
+		{
+			Detail::ForEachRadixChild(node, [](unsigned char, Node* child)
+			{
+				if (child->kind != Detail::RadixNodeKind::Leaf)
+					Destroy(static_cast<InnerNode*>(child));
+			});
+			Detail::DeleteRadixNode(node);
+		}
+
+		Leaf* FindLeaf(std::string_view key) const
+		{
+			Node* node = root;
+			std::size_t depth = 0;
+			while (node != nullptr)
+			{
+				if (node->kind == Detail::RadixNodeKind::Leaf)
+				{
+					// bytes before depth are equal to the bytes of the path to the leaf
+					std::string_view leafKey = KeyOf(static_cast<Leaf*>(node));
+					if (leafKey.size() != key.size() || std::memcmp(leafKey.data() + depth, key.data() + depth, key.size() - depth) != 0)
+						return nullptr;
+					return static_cast<Leaf*>(node);
+				}
+				auto inner = static_cast<InnerNode*>(node);
+				std::size_t prefixLength = inner->prefix.size();
+				if (key.size() - depth < prefixLength || std::memcmp(inner->prefix.data(), key.data() + depth, prefixLength) != 0)
+					return nullptr;
+				depth += prefixLength;
+				if (depth == key.size())
+					return static_cast<Leaf*>(inner->terminal);
+				Node** child = Detail::FindRadixChild(inner, static_cast<unsigned char>(key[depth]));
+				if (child == nullptr)
+					return nullptr;
+				node = *child;
+				++depth;
+			}
+			return nullptr;
+		}
+
+		// the first leaf with key not less than given key. While descending, the child that follows the path in
+		// the deepest node that has one is remembered, since its first leaf follows all keys below the path.
+		Leaf* LowerBound(std::string_view key) const
+		{
+			Node* node = root;
+			Node* following = nullptr;
+			std::size_t depth = 0;
+			while (node != nullptr)
+			{
+				if (node->kind == Detail::RadixNodeKind::Leaf)
+					return KeyOf(static_cast<Leaf*>(node)) < key ? FirstLeaf(following) : static_cast<Leaf*>(node);
+				auto inner = static_cast<InnerNode*>(node);
+				std::size_t remaining = key.size() - depth;
+				std::size_t length = inner->prefix.size() < remaining ? inner->prefix.size() : remaining;
+				int comparison = std::memcmp(inner->prefix.data(), key.data() + depth, length);
+				if (comparison < 0)
+					return FirstLeaf(following);
+				// keys in the subtree are greater, or the key ends within or right after the prefix
+				if (comparison > 0 || length == remaining)
+					return FirstLeaf(inner);
+				depth += length;
+				unsigned char byte = static_cast<unsigned char>(key[depth]);
+				if (Node* next = Detail::NextRadixChild(inner, byte))
+					following = next;
+				Node** child = Detail::FindRadixChild(inner, byte);
+				if (child == nullptr)
+					return FirstLeaf(following);
+				node = *child;
+				++depth;
+			}
+			return nullptr;
+		}
+
+		Leaf* UpperBound(std::string_view key) const
+		{
+			Leaf* leaf = LowerBound(key);
+			return leaf != nullptr && KeyOf(leaf) == key ? leaf->next : leaf;
+		}
+
+		// first leaf with the prefix and the first leaf after them
+		std::pair<Leaf*, Leaf*> PrefixRange(std::string_view prefix) const
+		{
+			Node* node = root;
+			Node* following = nullptr;
+			std::size_t depth = 0;
+			while (node != nullptr)
+			{
+				if (node->kind == Detail::RadixNodeKind::Leaf)
+				{
+					auto leaf = static_cast<Leaf*>(node);
+					std::string_view leafKey = KeyOf(leaf);
+					if (leafKey.size() < prefix.size() || std::memcmp(leafKey.data() + depth, prefix.data() + depth, prefix.size() - depth) != 0)
+						break;
+					return { leaf, FirstLeaf(following) };
+				}
+				auto inner = static_cast<InnerNode*>(node);
+				std::size_t remaining = prefix.size() - depth;
+				std::size_t length = inner->prefix.size() < remaining ? inner->prefix.size() : remaining;
+				if (std::memcmp(inner->prefix.data(), prefix.data() + depth, length) != 0)
+					break;
+				// all keys in the subtree start with the prefix
+				if (length == remaining)
+					return { FirstLeaf(inner), FirstLeaf(following) };
+				depth += length;
+				unsigned char byte = static_cast<unsigned char>(prefix[depth]);
+				if (Node* next = Detail::NextRadixChild(inner, byte))
+					following = next;
+				Node** child = Detail::FindRadixChild(inner, byte);
+				if (child == nullptr)
+					break;
+				node = *child;
+				++depth;
+			}
+			return { nullptr, nullptr };
+		}
+
+		// insert the leaf into the tree and the list of leaves, or return the leaf with equal key
+		std::pair<Leaf*, bool> Link(Leaf* leaf)
+		{
+			std::string_view key = KeyOf(leaf);
+			Node** link = &root;
+			Node* following = nullptr;
+			std::size_t depth = 0;
+			while (*link != nullptr)
+			{
+				if ((*link)->kind == Detail::RadixNodeKind::Leaf)
+				{
+					// the leaf is replaced by a node with both keys, branching where they differ
+					auto other = static_cast<Leaf*>(*link);
+					std::string_view otherKey = KeyOf(other);
+					std::size_t common = CommonLength(key, otherKey, depth);
+					if (common == key.size() && common == otherKey.size())
+						return { other, false };
+					auto inner = new Detail::RadixNode4();
+					try
+					{
+						inner->prefix.assign(key.data() + depth, common - depth);
+					}
+					catch (...)
+					{
+						delete inner;
+						throw;
+					}
+					AddToNode(inner, other, otherKey, common);
+					AddToNode(inner, leaf, key, common);
+					*link = inner;
+					bool isBefore = common == key.size() || (common < otherKey.size() && static_cast<unsigned char>(key[common]) < static_cast<unsigned char>(otherKey[common]));
+					LinkLeaf(leaf, isBefore ? other : FirstLeaf(following));
+					return { leaf, true };
+				}
+				auto inner = static_cast<InnerNode*>(*link);
+				std::size_t common = CommonLength(std::string_view(inner->prefix), key.substr(depth), 0);
+				if (common < inner->prefix.size())
+				{
+					// the prefix is split by a new node with the node and the leaf as its entries
+					auto parent = new Detail::RadixNode4();
+					try
+					{
+						parent->prefix.assign(inner->prefix, 0, common);
+					}
+					catch (...)
+					{
+						delete parent;
+						throw;
+					}
+					unsigned char byte = static_cast<unsigned char>(inner->prefix[common]);
+					inner->prefix.erase(0, common + 1);
+					Detail::AddRadixChild(parent, byte, inner);
+					AddToNode(parent, leaf, key, depth + common);
+					*link = parent;
+					bool isBefore = depth + common == key.size() || static_cast<unsigned char>(key[depth + common]) < byte;
+					LinkLeaf(leaf, isBefore ? FirstLeaf(inner) : FirstLeaf(following));
+					return { leaf, true };
+				}
+				depth += common;
+				if (depth == key.size())
+				{
+					if (inner->terminal != nullptr)
+						return { static_cast<Leaf*>(inner->terminal), false };
+					inner->terminal = leaf;
+					LinkLeaf(leaf, FirstLeaf(Detail::NextRadixChild(inner, -1)));
+					return { leaf, true };
+				}
+				unsigned char byte = static_cast<unsigned char>(key[depth]);
+				if (Node* next = Detail::NextRadixChild(inner, byte))
+					following = next;
+				Node** child = Detail::FindRadixChild(inner, byte);
+				if (child == nullptr)
+				{
+					if (Detail::IsRadixNodeFull(inner))
+						Detail::GrowRadixNode(*link);
+					Detail::AddRadixChild(static_cast<InnerNode*>(*link), byte, leaf);
+					LinkLeaf(leaf, FirstLeaf(following));
+					return { leaf, true };
+				}
+				link = child;
+				++depth;
+			}
+			*link = leaf;
+			LinkLeaf(leaf, nullptr);
+			return { leaf, true };
+		}
+
+		// add the leaf to a new node as its terminal leaf or as child for the byte at given position of the key
+		static void AddToNode(InnerNode* node, Leaf* leaf, std::string_view key, std::size_t position) noexcept
+		{
+			if (position == key.size())
+				node->terminal = leaf;
+			else
+				Detail::AddRadixChild(node, static_cast<unsigned char>(key[position]), leaf);
+		}
+
+		// link the leaf into the list of leaves before given leaf, or at the end if it is null
+		void LinkLeaf(Leaf* leaf, Leaf* next) noexcept
+		{
+			leaf->next = next;
+			leaf->previous = next != nullptr ? next->previous : last;
+			(leaf->previous != nullptr ? leaf->previous->next : first) = leaf;
+			(next != nullptr ? next->previous : last) = leaf;
+			++elementCount;
+		}
+
+		// remove the leaf from the tree and the list of leaves
+		void Unlink(Leaf* leaf) noexcept
+		{
+			std::string_view key = KeyOf(leaf);
+			Node** link = &root;
+			std::size_t depth = 0;
+			while (*link != leaf)
+			{
+				auto inner = static_cast<InnerNode*>(*link);
+				depth += inner->prefix.size();
+				if (depth == key.size())
+				{
+					inner->terminal = nullptr;
+					Detail::CompactRadixNode(*link);
+					break;
+				}
+				unsigned char byte = static_cast<unsigned char>(key[depth]);
+				Node** child = Detail::FindRadixChild(inner, byte);
+				if (*child == leaf)
+				{
+					Detail::RemoveRadixChild(inner, byte);
+					Detail::CompactRadixNode(*link);
+					break;
+				}
+				link = child;
+				++depth;
+			}
+			if (*link == leaf)
+				*link = nullptr;
+			(leaf->previous != nullptr ? leaf->previous->next : first) = leaf->next;
+			(leaf->next != nullptr ? leaf->next->previous : last) = leaf->previous;
+			leaf->previous = leaf->next = nullptr;
+			--elementCount;
+		}
+	};
+
+} // namespace MapSpecial
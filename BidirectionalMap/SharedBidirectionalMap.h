@@ -0,0 +1,678 @@
+#pragma once
+
+/*
+Copyright(c) 2017 Julijan Šribar
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software.If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "BidirectionalMapSnapshot.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <cassert>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace MapSpecial
+{
+
+	namespace Detail
+	{
+		// reader/writer spin lock that can be placed into memory shared between processes;
+		// pending writer blocks new readers
+		class SharedReaderWriterLock
+		{
+		public:
+			void LockShared() noexcept
+			{
+				for (;;)
+				{
+					std::uint32_t current = state.load(std::memory_order_relaxed);
+					if ((current & Writer) == 0 && state.compare_exchange_weak(current, current + 1, std::memory_order_acquire))
+						return;
+					std::this_thread::yield();
+				}
+			}
+
+			void UnlockShared() noexcept
+			{
+				state.fetch_sub(1, std::memory_order_release);
+			}
+
+			void Lock() noexcept
+			{
+				for (;;)
+				{
+					std::uint32_t current = state.load(std::memory_order_relaxed);
+					if ((current & Writer) == 0 && state.compare_exchange_weak(current, current | Writer, std::memory_order_acquire))
+						break;
+					std::this_thread::yield();
+				}
+				// wait for active readers to finish
+				while (state.load(std::memory_order_acquire) != Writer)
+					std::this_thread::yield();
+			}
+
+			void Unlock() noexcept
+			{
+				state.store(0, std::memory_order_release);
+			}
+
+		private:
+			static constexpr std::uint32_t Writer = 0x80000000u;
+			std::atomic<std::uint32_t> state{ 0 };
+
+			static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "Atomic must be address-free to be shared between processes.");
+		};
+
+		// named shared memory segment; the first process that opens the segment creates it. Other processes
+		// wait for the creator to set the size until the timeout expires.
+		class SharedMemorySegment
+		{
+		public:
+			SharedMemorySegment(const std::string& name, std::size_t requestedSize, std::chrono::milliseconds timeout)
+			{
+#ifdef _WIN32
+				LARGE_INTEGER largeSize;
+				largeSize.QuadPart = static_cast<LONGLONG>(requestedSize);
+				mapping = ::CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, largeSize.HighPart, largeSize.LowPart, name.c_str());
+				if (mapping == nullptr)
+					throw std::runtime_error("Cannot create shared memory segment.");
+				creator = ::GetLastError() != ERROR_ALREADY_EXISTS;
+				data = static_cast<char*>(::MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+				if (data == nullptr)
+				{
+					::CloseHandle(mapping);
+					throw std::runtime_error("Cannot map shared memory segment.");
+				}
+				MEMORY_BASIC_INFORMATION info;
+				::VirtualQuery(data, &info, sizeof(info));
+				size = info.RegionSize;
+#else
+				std::string posixName = name.empty() || name[0] != '/' ? "/" + name : name;
+				int segment = ::shm_open(posixName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+				creator = segment != -1;
+				if (creator)
+				{
+					if (::ftruncate(segment, static_cast<off_t>(requestedSize)) != 0)
+					{
+						::close(segment);
+						::shm_unlink(posixName.c_str());
+						throw std::runtime_error("Cannot create shared memory segment.");
+					}
+					size = requestedSize;
+				}
+				else
+				{
+					if (errno != EEXIST || (segment = ::shm_open(posixName.c_str(), O_RDWR, 0600)) == -1)
+						throw std::runtime_error("Cannot open shared memory segment.");
+					// creator may not have set the size yet, or may have terminated before setting it
+					auto deadline = std::chrono::steady_clock::now() + timeout;
+					struct stat status;
+					while (::fstat(segment, &status) == 0 && status.st_size == 0)
+					{
+						if (std::chrono::steady_clock::now() >= deadline)
+						{
+							::close(segment);
+							throw std::runtime_error("Shared memory segment was not created in time.");
+						}
+						std::this_thread::yield();
+					}
+					size = static_cast<std::size_t>(status.st_size);
+				}
+				void* address = size == 0 ? MAP_FAILED : ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, segment, 0);
+				::close(segment);
+				if (address == MAP_FAILED)
+					throw std::runtime_error("Cannot map shared memory segment.");
+				data = static_cast<char*>(address);
+#endif
+			}
+
+			SharedMemorySegment(const SharedMemorySegment&) = delete;
+			SharedMemorySegment& operator=(const SharedMemorySegment&) = delete;
+
+			~SharedMemorySegment()
+			{
+#ifdef _WIN32
+				::UnmapViewOfFile(data);
+				::CloseHandle(mapping);
+#else
+				::munmap(data, size);
+#endif
+			}
+
+			// remove the name of the segment; processes that have it opened can continue to use it
+			static void Remove(const std::string& name) noexcept
+			{
+#ifndef _WIN32
+				std::string posixName = name.empty() || name[0] != '/' ? "/" + name : name;
+				::shm_unlink(posixName.c_str());
+#endif
+			}
+
+			char* Data() const noexcept { return data; }
+			std::size_t Size() const noexcept { return size; }
+			bool IsCreator() const noexcept { return creator; }
+
+		private:
+			char* data = nullptr;
+			std::size_t size = 0;
+			bool creator = false;
+#ifdef _WIN32
+			HANDLE mapping = nullptr;
+#endif
+		};
+
+	} // namespace Detail
+
+
+	// bidirectional map stored entirely in a named shared memory segment, so that several processes can
+	// look up and modify a single copy. Keypairs, both hash indices and string contents live in the segment
+	// and refer to each other by offsets. The segment has a fixed capacity set by the process that creates it.
+	// Access is synchronized with a process-shared reader/writer lock; a process that terminates while
+	// modifying the map leaves the lock held. A process that terminates while creating the segment leaves it
+	// uninitialized; processes opening it throw std::runtime_error after the attach timeout, and the segment
+	// must be removed with RemoveSegment. Lookup methods return values by copy, since the storage
+	// they reside in may be modified by another process as soon as the lock is released.
+	template<typename T1, typename T2>
+	class SharedBidirectionalMap
+	{
+		using Traits1 = Snapshot::SnapshotTraits<T1>;
+		using Traits2 = Snapshot::SnapshotTraits<T2>;
+		using Lookup1 = typename Traits1::LookupType;
+		using Lookup2 = typename Traits2::LookupType;
+
+	public:
+		// open the segment with given name or create it with given capacity if it does not exist yet; an existing
+		// segment that its creator does not initialize within attachTimeout is rejected
+		SharedBidirectionalMap(const std::string& name, size_t pairCapacity, size_t blobCapacity = 0,
+			std::chrono::milliseconds attachTimeout = std::chrono::seconds(5))
+			: segment(name, SegmentSize(pairCapacity, blobCapacity), attachTimeout)
+		{
+			if (segment.IsCreator())
+				Initialize(pairCapacity, blobCapacity);
+			else
+				Attach(attachTimeout);
+		}
+
+		SharedBidirectionalMap(const SharedBidirectionalMap&) = delete;
+		SharedBidirectionalMap& operator=(const SharedBidirectionalMap&) = delete;
+
+		// remove the segment name so that the next process opening the map creates a new one
+		static void RemoveSegment(const std::string& name) noexcept
+		{
+			Detail::SharedMemorySegment::Remove(name);
+		}
+
+		// insert a new keypair
+		bool Insert(Lookup1 first, Lookup2 second)
+		{
+			WriteLock lock(header->lock);
+			std::uint64_t hash1 = Traits1::HashOf(first);
+			std::uint64_t position = Find(index1, hash1, [this, &first](const Snapshot::PairRecord& pair) { return Load<T1>(pair.first) == first; });
+			if (position != NotFound)
+			{
+				// do not perform insertion if provided keypair already exists
+				if (Load<T2>(PairAt(index1[position]).second) == second)
+					return false;
+				throw std::invalid_argument("First key already exists in the map.");
+			}
+			std::uint64_t hash2 = Traits2::HashOf(second);
+			if (Find(index2, hash2, [this, &second](const Snapshot::PairRecord& pair) { return Load<T2>(pair.second) == second; }) != NotFound)
+				throw std::invalid_argument("Second key already exists in the map.");
+			if (header->count == header->pairCapacity)
+				throw std::length_error("Shared map capacity exceeded.");
+
+			Snapshot::Field field1 = Store<T1>(first);
+			Snapshot::Field field2;
+			try
+			{
+				field2 = Store<T2>(second);
+			}
+			catch (...)
+			{
+				Release<T1>(field1);
+				throw;
+			}
+			std::uint64_t pairIndex = AllocatePair();
+			pairs[pairIndex].first = field1;
+			pairs[pairIndex].second = field2;
+			IndexInsert(index1, hash1, pairIndex);
+			IndexInsert(index2, hash2, pairIndex);
+			++header->count;
+			return true;
+		}
+
+		// change the first key paired to existing second key
+		bool ChangeFirst(Lookup1 first, Lookup2 second)
+		{
+			WriteLock lock(header->lock);
+			std::uint64_t position2 = Find(index2, Traits2::HashOf(second), [this, &second](const Snapshot::PairRecord& pair) { return Load<T2>(pair.second) == second; });
+			if (position2 == NotFound)
+				throw std::out_of_range("The second key must exist in the map.");
+			std::uint64_t pairIndex = PairIndex(index2[position2]);
+			std::uint64_t hash1 = Traits1::HashOf(first);
+			std::uint64_t position1 = Find(index1, hash1, [this, &first](const Snapshot::PairRecord& pair) { return Load<T1>(pair.first) == first; });
+			if (position1 != NotFound)
+			{
+				// if key is already assigned to the new first key, return false
+				if (PairIndex(index1[position1]) == pairIndex)
+					return false;
+				throw std::invalid_argument("First key is already assigned to another second key.");
+			}
+			Snapshot::Field field = Store<T1>(first);
+			Snapshot::PairRecord& pair = pairs[pairIndex];
+			IndexErase(index1, Traits1::HashOf(Load<T1>(pair.first)), pairIndex);
+			Release<T1>(pair.first);
+			pair.first = field;
+			IndexInsert(index1, hash1, pairIndex);
+			return true;
+		}
+
+		// change the second key paired to existing first key
+		bool ChangeSecond(Lookup1 first, Lookup2 second)
+		{
+			WriteLock lock(header->lock);
+			std::uint64_t position1 = Find(index1, Traits1::HashOf(first), [this, &first](const Snapshot::PairRecord& pair) { return Load<T1>(pair.first) == first; });
+			if (position1 == NotFound)
+				throw std::out_of_range("The first key must exist in the map.");
+			std::uint64_t pairIndex = PairIndex(index1[position1]);
+			std::uint64_t hash2 = Traits2::HashOf(second);
+			std::uint64_t position2 = Find(index2, hash2, [this, &second](const Snapshot::PairRecord& pair) { return Load<T2>(pair.second) == second; });
+			if (position2 != NotFound)
+			{
+				// if key is already assigned to the new second key, return false
+				if (PairIndex(index2[position2]) == pairIndex)
+					return false;
+				throw std::invalid_argument("Second key is already assigned to another first key.");
+			}
+			Snapshot::Field field = Store<T2>(second);
+			Snapshot::PairRecord& pair = pairs[pairIndex];
+			IndexErase(index2, Traits2::HashOf(Load<T2>(pair.second)), pairIndex);
+			Release<T2>(pair.second);
+			pair.second = field;
+			IndexInsert(index2, hash2, pairIndex);
+			return true;
+		}
+
+		// remove a keypair which has given first key
+		void RemoveFirst(Lookup1 first)
+		{
+			WriteLock lock(header->lock);
+			std::uint64_t position = Find(index1, Traits1::HashOf(first), [this, &first](const Snapshot::PairRecord& pair) { return Load<T1>(pair.first) == first; });
+			if (position == NotFound)
+				throw std::out_of_range("The first key must exist in the map.");
+			RemovePair(PairIndex(index1[position]));
+		}
+
+		// remove a keypair which has given second key
+		void RemoveSecond(Lookup2 second)
+		{
+			WriteLock lock(header->lock);
+			std::uint64_t position = Find(index2, Traits2::HashOf(second), [this, &second](const Snapshot::PairRecord& pair) { return Load<T2>(pair.second) == second; });
+			if (position == NotFound)
+				throw std::out_of_range("The second key must exist in the map.");
+			RemovePair(PairIndex(index2[position]));
+		}
+
+		// clear the map
+		void Clear() noexcept
+		{
+			WriteLock lock(header->lock);
+			std::memset(index1, 0, header->indexCapacity * sizeof(std::uint64_t));
+			std::memset(index2, 0, header->indexCapacity * sizeof(std::uint64_t));
+			header->count = 0;
+			header->pairsUsed = 0;
+			header->freePair = 0;
+			header->blobUsed = 0;
+			std::memset(header->freeBlocks, 0, sizeof(header->freeBlocks));
+		}
+
+		// get number of keypairs in the map
+		size_t Size() const noexcept
+		{
+			ReadLock lock(header->lock);
+			return static_cast<size_t>(header->count);
+		}
+
+		// get maximal number of keypairs the map can hold
+		size_t Capacity() const noexcept
+		{
+			return static_cast<size_t>(header->pairCapacity);
+		}
+
+		// check if first key exists in the map
+		bool FirstExists(Lookup1 first) const noexcept
+		{
+			ReadLock lock(header->lock);
+			return Find(index1, Traits1::HashOf(first), [this, &first](const Snapshot::PairRecord& pair) { return Load<T1>(pair.first) == first; }) != NotFound;
+		}
+
+		// check if second key exists in the map
+		bool SecondExists(Lookup2 second) const noexcept
+		{
+			ReadLock lock(header->lock);
+			return Find(index2, Traits2::HashOf(second), [this, &second](const Snapshot::PairRecord& pair) { return Load<T2>(pair.second) == second; }) != NotFound;
+		}
+
+		// get a copy of the value assigned to given first key
+		T2 AtFirst(Lookup1 first) const
+		{
+			ReadLock lock(header->lock);
+			std::uint64_t position = Find(index1, Traits1::HashOf(first), [this, &first](const Snapshot::PairRecord& pair) { return Load<T1>(pair.first) == first; });
+			if (position == NotFound)
+				throw std::out_of_range("The first key must exist in the map.");
+			return T2(Load<T2>(PairAt(index1[position]).second));
+		}
+
+		// get a copy of the value assigned to given second key
+		T1 AtSecond(Lookup2 second) const
+		{
+			ReadLock lock(header->lock);
+			std::uint64_t position = Find(index2, Traits2::HashOf(second), [this, &second](const Snapshot::PairRecord& pair) { return Load<T2>(pair.second) == second; });
+			if (position == NotFound)
+				throw std::out_of_range("The second key must exist in the map.");
+			return T1(Load<T1>(PairAt(index2[position]).first));
+		}
+
+	private:
+		static constexpr char Magic[8] = { 'B', 'I', 'M', 'A', 'P', 'S', 'H', 'M' };
+		static constexpr std::uint32_t FormatVersion = 1;
+		static constexpr std::uint64_t NotFound = ~std::uint64_t(0);
+		// strings are stored in blocks of 16 << n bytes
+		static constexpr std::size_t BlockClasses = 40;
+
+		struct SegmentHeader
+		{
+			char magic[8];
+			std::uint32_t formatVersion;
+			std::uint32_t firstType;
+			std::uint32_t secondType;
+			std::atomic<std::uint32_t> initialized;
+			Detail::SharedReaderWriterLock lock;
+			std::uint64_t pairCapacity;
+			std::uint64_t indexCapacity;
+			std::uint64_t blobCapacity;
+			std::uint64_t count;
+			// number of pair records ever used; records below are either used or in the free list
+			std::uint64_t pairsUsed;
+			// first record in the free list + 1, 0 if the list is empty
+			std::uint64_t freePair;
+			std::uint64_t blobUsed;
+			// first block in the free list of each block class + 1, 0 if the list is empty
+			std::uint64_t freeBlocks[BlockClasses];
+		};
+
+		class ReadLock
+		{
+		public:
+			explicit ReadLock(Detail::SharedReaderWriterLock& lock) noexcept : lock(lock) { lock.LockShared(); }
+			~ReadLock() { lock.UnlockShared(); }
+		private:
+			Detail::SharedReaderWriterLock& lock;
+		};
+
+		class WriteLock
+		{
+		public:
+			explicit WriteLock(Detail::SharedReaderWriterLock& lock) noexcept : lock(lock) { lock.Lock(); }
+			~WriteLock() { lock.Unlock(); }
+		private:
+			Detail::SharedReaderWriterLock& lock;
+		};
+
+		Detail::SharedMemorySegment segment;
+		SegmentHeader* header = nullptr;
+		Snapshot::PairRecord* pairs = nullptr;
+		std::uint64_t* index1 = nullptr;
+		std::uint64_t* index2 = nullptr;
+		char* blob = nullptr;
+
+		static std::uint64_t IndexCapacity(std::uint64_t pairCapacity) noexcept
+		{
+			return Snapshot::Detail::IndexCapacity(pairCapacity);
+		}
+
+		static std::size_t SegmentSize(std::uint64_t pairCapacity, std::uint64_t blobCapacity) noexcept
+		{
+			return static_cast<std::size_t>(Snapshot::Detail::AlignedSize(sizeof(SegmentHeader))
+				+ pairCapacity * sizeof(Snapshot::PairRecord)
+				+ 2 * IndexCapacity(pairCapacity) * sizeof(std::uint64_t)
+				+ blobCapacity);
+		}
+
+		void Initialize(size_t pairCapacity, size_t blobCapacity)
+		{
+			if (pairCapacity >= UINT32_MAX)
+				throw std::length_error("Too many keypairs for shared map.");
+			header = new (segment.Data()) SegmentHeader();
+			std::memcpy(header->magic, Magic, sizeof(Magic));
+			header->formatVersion = FormatVersion;
+			header->firstType = Traits1::TypeCode;
+			header->secondType = Traits2::TypeCode;
+			header->pairCapacity = pairCapacity;
+			header->indexCapacity = IndexCapacity(pairCapacity);
+			header->blobCapacity = blobCapacity;
+			SetPointers();
+			std::memset(index1, 0, 2 * header->indexCapacity * sizeof(std::uint64_t));
+			header->initialized.store(1, std::memory_order_release);
+		}
+
+		void Attach(std::chrono::milliseconds timeout)
+		{
+			if (segment.Size() < Snapshot::Detail::AlignedSize(sizeof(SegmentHeader)))
+				throw std::runtime_error("Invalid shared memory segment.");
+			header = reinterpret_cast<SegmentHeader*>(segment.Data());
+			auto deadline = std::chrono::steady_clock::now() + timeout;
+			while (header->initialized.load(std::memory_order_acquire) == 0)
+			{
+				if (std::chrono::steady_clock::now() >= deadline)
+					throw std::runtime_error("Shared memory segment was not initialized in time.");
+				std::this_thread::yield();
+			}
+			if (std::memcmp(header->magic, Magic, sizeof(Magic)) != 0 || header->formatVersion != FormatVersion)
+				throw std::runtime_error("Invalid shared memory segment.");
+			if (header->firstType != Traits1::TypeCode || header->secondType != Traits2::TypeCode)
+				throw std::runtime_error("Shared map key types do not match.");
+			if (SegmentSize(header->pairCapacity, header->blobCapacity) > segment.Size())
+				throw std::runtime_error("Shared memory segment is truncated.");
+			SetPointers();
+		}
+
+		void SetPointers() noexcept
+		{
+			char* data = segment.Data();
+			std::uint64_t offset = Snapshot::Detail::AlignedSize(sizeof(SegmentHeader));
+			pairs = reinterpret_cast<Snapshot::PairRecord*>(data + offset);
+			offset += header->pairCapacity * sizeof(Snapshot::PairRecord);
+			index1 = reinterpret_cast<std::uint64_t*>(data + offset);
+			offset += header->indexCapacity * sizeof(std::uint64_t);
+			index2 = reinterpret_cast<std::uint64_t*>(data + offset);
+			offset += header->indexCapacity * sizeof(std::uint64_t);
+			blob = data + offset;
+		}
+
+		// index entry contains upper 32 bits of the key hash and pair index + 1
+
+		static std::uint64_t PairIndex(std::uint64_t entry) noexcept
+		{
+			return (entry & 0xFFFFFFFFull) - 1;
+		}
+
+		std::uint64_t HomeSlot(std::uint64_t entry) const noexcept
+		{
+			return ((entry >> 32) * header->indexCapacity) >> 32;
+		}
+
+		const Snapshot::PairRecord& PairAt(std::uint64_t entry) const noexcept
+		{
+			return pairs[PairIndex(entry)];
+		}
+
+		std::uint64_t NextSlot(std::uint64_t slot) const noexcept
+		{
+			return slot + 1 == header->indexCapacity ? 0 : slot + 1;
+		}
+
+		template<typename TEqual>
+		std::uint64_t Find(const std::uint64_t* index, std::uint64_t hash, TEqual equal) const noexcept
+		{
+			const std::uint64_t tag = hash >> 32;
+			for (std::uint64_t slot = Snapshot::Detail::IndexSlot(hash, header->indexCapacity); index[slot] != 0; slot = NextSlot(slot))
+			{
+				if ((index[slot] >> 32) == tag && equal(PairAt(index[slot])))
+					return slot;
+			}
+			return NotFound;
+		}
+
+		void IndexInsert(std::uint64_t* index, std::uint64_t hash, std::uint64_t pairIndex) noexcept
+		{
+			std::uint64_t slot = Snapshot::Detail::IndexSlot(hash, header->indexCapacity);
+			while (index[slot] != 0)
+				slot = NextSlot(slot);
+			index[slot] = (hash & 0xFFFFFFFF00000000ull) | (pairIndex + 1);
+		}
+
+		// remove the entry of given pair and shift following entries of the cluster back to keep probing valid
+		void IndexErase(std::uint64_t* index, std::uint64_t hash, std::uint64_t pairIndex) noexcept
+		{
+			std::uint64_t slot = Snapshot::Detail::IndexSlot(hash, header->indexCapacity);
+			while (PairIndex(index[slot]) != pairIndex)
+			{
+				assert(index[slot] != 0);
+				slot = NextSlot(slot);
+			}
+			for (std::uint64_t next = NextSlot(slot); index[next] != 0; next = NextSlot(next))
+			{
+				std::uint64_t home = HomeSlot(index[next]);
+				bool staysInPlace = slot <= next ? (slot < home && home <= next) : (slot < home || home <= next);
+				if (staysInPlace)
+					continue;
+				index[slot] = index[next];
+				slot = next;
+			}
+			index[slot] = 0;
+		}
+
+		std::uint64_t AllocatePair() noexcept
+		{
+			if (header->freePair != 0)
+			{
+				std::uint64_t pairIndex = header->freePair - 1;
+				header->freePair = pairs[pairIndex].first.value;
+				return pairIndex;
+			}
+			assert(header->pairsUsed < header->pairCapacity);
+			return header->pairsUsed++;
+		}
+
+		void RemovePair(std::uint64_t pairIndex) noexcept
+		{
+			Snapshot::PairRecord& pair = pairs[pairIndex];
+			IndexErase(index1, Traits1::HashOf(Load<T1>(pair.first)), pairIndex);
+			IndexErase(index2, Traits2::HashOf(Load<T2>(pair.second)), pairIndex);
+			Release<T1>(pair.first);
+			Release<T2>(pair.second);
+			pair.first.value = header->freePair;
+			header->freePair = pairIndex + 1;
+			--header->count;
+		}
+
+		static std::size_t BlockClass(std::uint64_t length) noexcept
+		{
+			std::size_t blockClass = 0;
+			while ((std::uint64_t(16) << blockClass) < length)
+				++blockClass;
+			return blockClass;
+		}
+
+		template<typename T>
+		Snapshot::Field Store(typename Snapshot::SnapshotTraits<T>::LookupType value)
+		{
+			if constexpr (std::is_same<T, std::string>::value)
+			{
+				Snapshot::Field field{ 0, value.size() };
+				if (value.empty())
+					return field;
+				std::size_t blockClass = BlockClass(value.size());
+				if (header->freeBlocks[blockClass] != 0)
+				{
+					field.value = header->freeBlocks[blockClass] - 1;
+					std::memcpy(&header->freeBlocks[blockClass], blob + field.value, sizeof(std::uint64_t));
+				}
+				else
+				{
+					std::uint64_t blockSize = std::uint64_t(16) << blockClass;
+					if (header->blobUsed + blockSize > header->blobCapacity)
+						throw std::length_error("Shared map string capacity exceeded.");
+					field.value = header->blobUsed;
+					header->blobUsed += blockSize;
+				}
+				std::memcpy(blob + field.value, value.data(), value.size());
+				return field;
+			}
+			else
+				return Snapshot::SnapshotTraits<T>::Encode(value, 0);
+		}
+
+		template<typename T>
+		void Release(const Snapshot::Field& field) noexcept
+		{
+			if constexpr (std::is_same<T, std::string>::value)
+			{
+				if (field.length == 0)
+					return;
+				std::size_t blockClass = BlockClass(field.length);
+				std::memcpy(blob + field.value, &header->freeBlocks[blockClass], sizeof(std::uint64_t));
+				header->freeBlocks[blockClass] = field.value + 1;
+			}
+		}
+
+		template<typename T>
+		typename Snapshot::SnapshotTraits<T>::ViewType Load(const Snapshot::Field& field) const noexcept
+		{
+			return Snapshot::SnapshotTraits<T>::Decode(field, blob);
+		}
+
+	}; // class SharedBidirectionalMap
+
+} // namespace MapSpecial
@@ -0,0 +1,186 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "../BidirectionalMap/BidirectionalExpiringMap.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace MapSpecial;
+
+namespace UnitTests
+{
+	// clock that advances only when the test sets its time
+	struct ManualClock
+	{
+		using rep = long long;
+		using period = std::milli;
+		using duration = std::chrono::duration<rep, period>;
+		using time_point = std::chrono::time_point<ManualClock>;
+		static constexpr bool is_steady = true;
+
+		static time_point now() noexcept { return current; }
+
+		static time_point current;
+	};
+
+	ManualClock::time_point ManualClock::current;
+
+	TEST_CLASS(BidirectionalExpiringMapTest)
+	{
+	public:
+
+		using Milliseconds = std::chrono::milliseconds;
+
+		TEST_METHOD_INITIALIZE(ResetClock)
+		{
+			ManualClock::current = ManualClock::time_point();
+		}
+
+		TEST_METHOD(BidirectionalExpiringMap_ExpiredKeyPairsAreAbsentBeforeTickAndRemovedByTick)
+		{
+			BidirectionalExpiringMap<std::string, int, ManualClock> bem;
+			bem.InsertFor("hello", 5, Milliseconds(10));
+			bem.InsertFor("world", 2, Milliseconds(20));
+
+			ManualClock::current += Milliseconds(10);
+			Assert::IsFalse(bem.FirstExists("hello"));
+			Assert::IsFalse(bem.SecondExists(5));
+			Assert::AreEqual(2, bem.AtFirst("world"));
+			Assert::AreEqual(size_t(2), bem.Size());
+			try
+			{
+				bem.AtFirst("hello");
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+
+			Assert::AreEqual(size_t(1), bem.Tick(ManualClock::now()));
+			Assert::AreEqual(size_t(1), bem.Size());
+
+			ManualClock::current += Milliseconds(10);
+			Assert::AreEqual(size_t(1), bem.Tick(ManualClock::now()));
+			Assert::AreEqual(size_t(0), bem.Size());
+		}
+
+		TEST_METHOD(BidirectionalExpiringMap_InsertReplacesExpiredKeyPairsAndThrowsForLiveOnes)
+		{
+			BidirectionalExpiringMap<std::string, int, ManualClock> bem;
+			bem.InsertFor("hello", 5, Milliseconds(10));
+			bem.InsertFor("world", 2, Milliseconds(100));
+
+			Assert::IsFalse(bem.InsertFor("hello", 5, Milliseconds(10)));
+			try
+			{
+				bem.InsertFor("hello", 2, Milliseconds(10));
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+
+			ManualClock::current += Milliseconds(50);
+			Assert::IsTrue(bem.InsertFor("hello", 7, Milliseconds(10)));
+			Assert::AreEqual(size_t(2), bem.Size());
+			Assert::AreEqual(7, bem.AtFirst("hello"));
+			Assert::IsFalse(bem.SecondExists(5));
+		}
+
+		TEST_METHOD(BidirectionalExpiringMap_RescheduleChangesDeadline)
+		{
+			BidirectionalExpiringMap<int, int, ManualClock> bem;
+			bem.InsertFor(1, 10, Milliseconds(10));
+			bem.InsertFor(2, 20, Milliseconds(10));
+
+			bem.RescheduleFirst(1, ManualClock::now() + Milliseconds(100000));
+			bem.RescheduleSecond(20, ManualClock::now() + Milliseconds(5));
+			Assert::IsTrue(bem.DeadlineOfFirst(1) == ManualClock::now() + Milliseconds(100000));
+
+			ManualClock::current += Milliseconds(10);
+			Assert::AreEqual(size_t(1), bem.Tick(ManualClock::now()));
+			Assert::IsTrue(bem.FirstExists(1));
+			Assert::IsFalse(bem.FirstExists(2));
+
+			ManualClock::current += Milliseconds(100000);
+			Assert::AreEqual(size_t(1), bem.Tick(ManualClock::now()));
+			Assert::AreEqual(size_t(0), bem.Size());
+		}
+
+		TEST_METHOD(BidirectionalExpiringMap_TickRemovesKeyPairsInOrderOfDeadlinesAcrossAllLevels)
+		{
+			BidirectionalExpiringMap<int, int, ManualClock> bem;
+			std::default_random_engine random;
+			// deadlines reach beyond the range of the wheel, so some keypairs pass through the overflow list
+			std::uniform_int_distribution<long long> distribution(1, 40000000);
+			std::vector<long long> deadlines;
+			for (int i = 0; i < 2000; ++i)
+			{
+				deadlines.push_back(distribution(random));
+				bem.Insert(i, -i, ManualClock::time_point(Milliseconds(deadlines.back())));
+			}
+			bem.RemoveFirst(0);
+
+			const long long steps[] = { 50, 4000, 300000, 17000000, 20000000, 40000000 };
+			for (long long step : steps)
+			{
+				ManualClock::current = ManualClock::time_point(Milliseconds(step));
+				bem.Tick(ManualClock::now());
+				size_t live = 0;
+				for (int i = 1; i < 2000; ++i)
+				{
+					Assert::AreEqual(deadlines[i] > step, bem.FirstExists(i));
+					live += deadlines[i] > step;
+				}
+				Assert::AreEqual(live, bem.Size());
+			}
+			Assert::AreEqual(size_t(0), bem.Size());
+		}
+
+		TEST_METHOD(BidirectionalExpiringMap_TickSkipsIdleTicksAndKeepsKeyPairsWithFarDeadlines)
+		{
+			BidirectionalExpiringMap<int, int, ManualClock> bem;
+			bem.Insert(1, -1, ManualClock::time_point::max());
+			bem.InsertFor(2, -2, Milliseconds(86400000));
+
+			ManualClock::current += Milliseconds(86399999);
+			Assert::AreEqual(size_t(0), bem.Tick(ManualClock::now()));
+			ManualClock::current += Milliseconds(1);
+			Assert::AreEqual(size_t(1), bem.Tick(ManualClock::now()));
+			Assert::IsTrue(bem.FirstExists(1));
+			Assert::IsTrue(ManualClock::time_point::max() == bem.DeadlineOfFirst(1));
+
+			ManualClock::current = ManualClock::time_point(ManualClock::duration::max() / 2);
+			Assert::AreEqual(size_t(0), bem.Tick(ManualClock::now()));
+			Assert::IsTrue(bem.FirstExists(1));
+			Assert::AreEqual(size_t(1), bem.Size());
+		}
+
+		TEST_METHOD(BidirectionalExpiringMap_TickInIrregularStepsRemovesKeyPairsWhenTheirDeadlinesPass)
+		{
+			BidirectionalExpiringMap<int, int, ManualClock> bem;
+			std::default_random_engine random;
+			std::uniform_int_distribution<long long> deadlineDistribution(1, 40000000);
+			std::vector<long long> deadlines;
+			for (int i = 0; i < 500; ++i)
+			{
+				deadlines.push_back(deadlineDistribution(random));
+				bem.Insert(i, -i, ManualClock::time_point(Milliseconds(deadlines.back())));
+			}
+
+			std::uniform_int_distribution<long long> stepDistribution(1, 200000);
+			while (bem.Size() > 0)
+			{
+				ManualClock::current += Milliseconds(stepDistribution(random));
+				bem.Tick(ManualClock::now());
+				long long now = ManualClock::now().time_since_epoch().count();
+				size_t live = 0;
+				for (long long deadline : deadlines)
+					live += deadline > now;
+				Assert::AreEqual(live, bem.Size());
+			}
+		}
+	};
+}
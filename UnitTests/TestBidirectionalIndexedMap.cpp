@@ -0,0 +1,340 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../BidirectionalMap/BidirectionalMap.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace MapSpecial;
+
+namespace UnitTests
+{
+	TEST_CLASS(BidirectionalIndexedMapTest)
+	{
+	public:
+
+		TEST_METHOD(BidirectionalIndexedMap_HashedFirstAndOrderedSecondFindKeysOnBothSides)
+		{
+			BidirectionalIndexedMap<int, std::string, HashedIndex<int>, OrderedIndex<std::string>> bim{ { 1, "one" }, { 2, "two" }, { 3, "three" } };
+
+			Assert::AreEqual(size_t(3), bim.Size());
+			Assert::IsTrue(bim.AtFirst(2) == "two");
+			Assert::AreEqual(3, bim.AtSecond("three"));
+			bim.ChangeFirst(4, "one");
+			bim.ChangeSecond(2, "zwei");
+			bim.RemoveFirst(3);
+			Assert::AreEqual(size_t(2), bim.Size());
+			Assert::AreEqual(4, bim.AtSecond("one"));
+			Assert::IsTrue(bim.AtFirst(2) == "zwei");
+			Assert::IsFalse(bim.FirstExists(1));
+			Assert::IsFalse(bim.SecondExists("three"));
+		}
+
+		TEST_METHOD(BidirectionalIndexedMap_OrderedSideProvidesRangesWhileOtherSideIsHashed)
+		{
+			BidirectionalIndexedMap<int, std::string, HashedIndex<int>, OrderedIndex<std::string>> bim;
+			for (int i = 0; i < 10; ++i)
+				bim.Insert(i, std::to_string(i * 10));
+
+			std::vector<int> firsts;
+			for (const auto& pair : bim.RangeSecond("20", "50"))
+				firsts.push_back(pair.first);
+			Assert::IsTrue(firsts == std::vector<int>{ 2, 3, 4 });
+
+			std::vector<std::string> seconds;
+			for (const auto& pair : bim.BySecond())
+				seconds.push_back(pair.second);
+			Assert::IsTrue(std::is_sorted(seconds.cbegin(), seconds.cend()));
+		}
+
+		TEST_METHOD(BidirectionalIndexedMap_RangeMethodsFollowOrderOfIndexComparator)
+		{
+			BidirectionalIndexedMap<int, std::string, OrderedIndex<int, std::greater<int>>, HashedIndex<std::string>> bim;
+			for (int i = 0; i < 10; ++i)
+				bim.Insert(i, std::to_string(i));
+
+			std::vector<int> firsts;
+			for (const auto& pair : bim.RangeFirst(7, 4))
+				firsts.push_back(pair.first);
+			Assert::IsTrue(firsts == std::vector<int>{ 7, 6, 5 });
+			Assert::IsTrue(bim.RangeFirst(4, 7).empty());
+			Assert::AreEqual(9, bim.ByFirst().begin()->first);
+		}
+
+		TEST_METHOD(BidirectionalIndexedMap_HashedIndexUsesGivenHashAndEquality)
+		{
+			struct CaseInsensitiveHash
+			{
+				std::size_t operator()(const std::string& text) const
+				{
+					std::string lower(text);
+					for (char& c : lower)
+						c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+					return std::hash<std::string>{}(lower);
+				}
+			};
+			struct CaseInsensitiveEquality
+			{
+				bool operator()(const std::string& text1, const std::string& text2) const
+				{
+					return text1.size() == text2.size() && std::equal(text1.cbegin(), text1.cend(), text2.cbegin(),
+						[](char c1, char c2) { return std::tolower(static_cast<unsigned char>(c1)) == std::tolower(static_cast<unsigned char>(c2)); });
+				}
+			};
+			BidirectionalIndexedMap<std::string, int, HashedIndex<std::string, CaseInsensitiveHash, CaseInsensitiveEquality>, OrderedIndex<int>> bim;
+
+			bim.Insert("Hello", 5);
+			Assert::IsTrue(bim.FirstExists("HELLO"));
+			Assert::AreEqual(5, bim.AtFirst("hello"));
+			try
+			{
+				bim.Insert("HELLO", 6);
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+		}
+
+		TEST_METHOD(BidirectionalIndexedMap_RankedIndexSideSupportsRangeQueries)
+		{
+			BidirectionalIndexedMap<int, std::string, RankedIndex<int>, HashedIndex<std::string>> bim{ { 5, "five" }, { 1, "one" }, { 3, "three" } };
+
+			std::vector<int> firsts;
+			for (const auto& pair : bim.ByFirst())
+				firsts.push_back(pair.first);
+			Assert::IsTrue(firsts == std::vector<int>{ 1, 3, 5 });
+			Assert::AreEqual(5, bim.AtSecond("five"));
+		}
+
+		TEST_METHOD(BidirectionalIndexedMap_FilteredIndexFindsAllKeysAndSkipsMostMissingOnes)
+		{
+			BidirectionalIndexedMap<int, std::string, HashedIndex<int>, FilteredIndex<std::string>> bim;
+			for (int i = 0; i < 10000; ++i)
+				bim.Insert(i, "key" + std::to_string(i));
+
+			for (int i = 0; i < 10000; ++i)
+				Assert::AreEqual(i, bim.AtSecond("key" + std::to_string(i)));
+			size_t found = 0;
+			for (int i = 10000; i < 20000; ++i)
+				found += bim.SecondExists("key" + std::to_string(i));
+
+			auto statistics = bim.SecondFilterStatistics();
+			Assert::AreEqual(size_t(0), found);
+			Assert::IsTrue(statistics.lookups >= 20000);
+			Assert::IsTrue(statistics.skipped >= 9500);
+			Assert::AreEqual(statistics.lookups - 10000 - statistics.skipped, statistics.falsePositives);
+			Assert::IsTrue(statistics.SkipRate() > 0.45);
+		}
+
+		TEST_METHOD(BidirectionalIndexedMap_RebuildFilterDiscardsRemovedKeys)
+		{
+			BidirectionalIndexedMap<int, std::string, FilteredIndex<int>, FilteredIndex<std::string>> bim;
+			for (int i = 0; i < 10000; ++i)
+				bim.Insert(i, std::to_string(i));
+			bim.EraseIf([](const std::pair<int, std::string>& keyPair) { return keyPair.first >= 100; });
+			bim.RemoveSecond("99");
+
+			auto before = bim.FirstFilterStatistics();
+			Assert::AreEqual(size_t(9901), before.removed);
+			Assert::AreEqual(size_t(9901), bim.SecondFilterStatistics().removed);
+			bim.RebuildFirstFilter();
+			auto after = bim.FirstFilterStatistics();
+
+			Assert::AreEqual(size_t(0), after.removed);
+			Assert::IsTrue(after.bytes < before.bytes);
+			for (int i = 0; i < 10000; ++i)
+				Assert::AreEqual(i < 99, bim.FirstExists(i));
+			Assert::AreEqual(size_t(99), bim.Size());
+		}
+
+		TEST_METHOD(BidirectionalIndexedMap_FilteredIndexRemainsConsistentAfterCopyRemapAndClear)
+		{
+			BidirectionalIndexedMap<int, int, FilteredIndex<int>, FilteredIndex<int>> bim;
+			for (int i = 0; i < 1000; ++i)
+				bim.Insert(i, -i);
+			auto copy = bim;
+			bim.RemapFirst([](int first) { return first + 5000; });
+			bim.ChangeSecond(5001, 1);
+			copy.DropSecondIndex();
+			copy.Insert(1000, -1000);
+
+			Assert::IsFalse(bim.FirstExists(1));
+			Assert::AreEqual(1, bim.AtFirst(5001));
+			Assert::AreEqual(5001, bim.AtSecond(1));
+			Assert::IsFalse(bim.SecondExists(-1));
+			Assert::AreEqual(1000, copy.AtSecond(-1000));
+			Assert::AreEqual(999, copy.AtSecond(-999));
+			bim.Clear();
+			Assert::IsFalse(bim.FirstExists(5001));
+			bim.Insert(1, 2);
+			Assert::AreEqual(2, bim.AtFirst(1));
+		}
+
+		TEST_METHOD(BidirectionalIndexedMap_RadixTreeIndexOrdersKeysAsStrings)
+		{
+			std::vector<std::string> keys{ "", "a", "ab", "abc", "abd", "b", "ba", std::string("a\0b", 3), "\xC3\xA9t\xC3\xA9", "zzz", "a\xFF" };
+			BidirectionalIndexedMap<std::string, int, RadixTreeIndex<std::string>, HashedIndex<int>> bim;
+			for (size_t i = 0; i < keys.size(); ++i)
+				bim.Insert(keys[i], int(i));
+
+			std::sort(keys.begin(), keys.end());
+			std::vector<std::string> firsts;
+			for (const auto& pair : bim.ByFirst())
+				firsts.push_back(pair.first);
+			Assert::IsTrue(firsts == keys);
+			for (const auto& key : keys)
+				Assert::IsTrue(bim.AtSecond(bim.AtFirst(key)) == key);
+			Assert::IsFalse(bim.FirstExists("abcd"));
+			Assert::IsFalse(bim.FirstExists("z"));
+			Assert::IsTrue(bim.LowerBoundFirst("abcd").begin()->first == "abd");
+			Assert::IsTrue(bim.UpperBoundFirst("b").begin()->first == "ba");
+			Assert::IsTrue((--bim.ByFirst().end())->first == "\xC3\xA9t\xC3\xA9");
+		}
+
+		TEST_METHOD(BidirectionalIndexedMap_PrefixFirstFindsKeysStartingWithPrefix)
+		{
+			BidirectionalIndexedMap<std::string, int, RadixTreeIndex<std::string>, OrderedIndex<int>> bim{
+				{ "/api/v1/users", 1 }, { "/api/v2/users", 2 }, { "/api/v2/orders", 3 }, { "/api/v2", 4 }, { "/api/v20/users", 5 }, { "/index.html", 6 } };
+
+			std::vector<int> seconds;
+			for (const auto& pair : bim.PrefixFirst("/api/v2/"))
+				seconds.push_back(pair.second);
+			Assert::IsTrue(seconds == std::vector<int>{ 3, 2 });
+			seconds.clear();
+			for (const auto& pair : bim.PrefixFirst("/api/v2"))
+				seconds.push_back(pair.second);
+			Assert::IsTrue(seconds == std::vector<int>{ 4, 3, 2, 5 });
+			auto all = bim.PrefixFirst("");
+			Assert::AreEqual(ptrdiff_t(6), std::distance(all.begin(), all.end()));
+			Assert::IsTrue(bim.PrefixFirst("/api/v3").empty());
+			Assert::IsTrue(bim.PrefixFirst("/index.html/").empty());
+
+			bim.RemoveFirst("/api/v2/orders");
+			bim.ChangeFirst("/api/v2/orders", 1);
+			seconds.clear();
+			for (const auto& pair : bim.PrefixFirst("/api/v2/"))
+				seconds.push_back(pair.second);
+			Assert::IsTrue(seconds == std::vector<int>{ 1, 2 });
+		}
+
+		TEST_METHOD(BidirectionalIndexedMap_RadixTreeIndexRemainsConsistentAfterManyChanges)
+		{
+			BidirectionalIndexedMap<int, std::string, HashedIndex<int>, RadixTreeIndex<std::string>> bim;
+			for (int i = 0; i < 2000; ++i)
+				bim.Insert(i, std::to_string(i * 7919 % 2000));
+			auto copy = bim;
+			bim.EraseIf([](const std::pair<int, std::string>& keyPair) { return keyPair.first % 3 != 0; });
+			for (int i = 0; i < 2000; i += 3)
+				bim.ChangeSecond(i, "x" + std::to_string(i));
+
+			Assert::AreEqual(size_t(667), bim.Size());
+			Assert::AreEqual(size_t(2000), copy.Size());
+			Assert::IsTrue(bim.PrefixSecond("1").empty());
+			auto changed = bim.PrefixSecond("x");
+			Assert::AreEqual(ptrdiff_t(667), std::distance(changed.begin(), changed.end()));
+			std::vector<std::string> seconds;
+			for (const auto& pair : copy.PrefixSecond("19"))
+				seconds.push_back(pair.second);
+			Assert::AreEqual(size_t(111), seconds.size());
+			Assert::IsTrue(std::is_sorted(seconds.cbegin(), seconds.cend()));
+			for (int i = 0; i < 2000; ++i)
+				Assert::AreEqual(i, copy.AtSecond(std::to_string(i * 7919 % 2000)));
+		}
+
+		TEST_METHOD(BidirectionalIndexedMap_CopyOfRadixTreeIndexKeepsOrderAndIsIndependent)
+		{
+			// keys branch on up to 256 bytes at a node and some keys are prefixes of others
+			BidirectionalIndexedMap<std::string, int, RadixTreeIndex<std::string>, HashedIndex<int>> bim;
+			std::vector<std::string> keys;
+			for (int i = 0; i < 256; ++i)
+			{
+				keys.push_back(std::string(1, static_cast<char>(i)));
+				for (int j = 0; j < 256; j += 5 + i % 50)
+					keys.push_back(std::string(1, static_cast<char>(i)) + std::string(1, static_cast<char>(j)) + "key");
+			}
+			for (size_t i = 0; i < keys.size(); ++i)
+				bim.Insert(keys[i], int(i));
+			auto copy = bim;
+			bim.Clear();
+
+			std::sort(keys.begin(), keys.end());
+			std::vector<std::string> firsts;
+			for (const auto& pair : copy.ByFirst())
+				firsts.push_back(pair.first);
+			Assert::IsTrue(firsts == keys);
+			for (const auto& key : keys)
+				Assert::IsTrue(copy.AtSecond(copy.AtFirst(key)) == key);
+			Assert::IsTrue((--copy.ByFirst().end())->first == keys.back());
+			auto range = copy.PrefixFirst(std::string(1, 'a'));
+			Assert::IsTrue(range.begin()->first == "a");
+
+			copy.RemoveFirst("a");
+			copy.Insert("a!", -1);
+			Assert::IsFalse(copy.FirstExists("a"));
+			Assert::AreEqual(-1, copy.AtFirst("a!"));
+			Assert::AreEqual(size_t(0), bim.Size());
+		}
+
+		TEST_METHOD(BidirectionalIndexedMap_CuckooIndexKeepsInsertSemanticsWhileGrowing)
+		{
+			BidirectionalIndexedMap<int, std::string, CuckooIndex<int>, CuckooIndex<std::string>> bim;
+			for (int i = 0; i < 10000; ++i)
+				Assert::IsTrue(bim.Insert(i, "key" + std::to_string(i)));
+			Assert::IsFalse(bim.Insert(5, "key5"));
+			try
+			{
+				bim.Insert(5, "other");
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+			try
+			{
+				bim.Insert(10000, "key5");
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+			bim.EraseIf([](const std::pair<int, std::string>& keyPair) { return keyPair.first % 2 == 0; });
+			bim.ChangeFirst(-1, "key1");
+
+			Assert::AreEqual(size_t(5000), bim.Size());
+			for (int i = 2; i < 10000; ++i)
+				Assert::AreEqual(i % 2 != 0, bim.FirstExists(i));
+			Assert::AreEqual(-1, bim.AtSecond("key1"));
+			Assert::IsTrue(bim.AtFirst(9999) == "key9999");
+			Assert::IsFalse(bim.SecondExists("key0"));
+		}
+
+		TEST_METHOD(BidirectionalIndexedMap_CuckooIndexFindsKeysWithCollidingHashes)
+		{
+			// hashes of many keys are equal, so they cannot be separated by rehashing and are stashed
+			struct CollidingHash
+			{
+				std::size_t operator()(int key) const { return std::size_t(key % 3); }
+			};
+			BidirectionalIndexedMap<int, int, CuckooIndex<int, CollidingHash>, CuckooIndex<int>> bim;
+			for (int i = 0; i < 300; ++i)
+				bim.Insert(i, -i);
+			auto copy = bim;
+			for (int i = 0; i < 300; i += 2)
+				bim.RemoveFirst(i);
+
+			for (int i = 0; i < 300; ++i)
+			{
+				Assert::AreEqual(i % 2 != 0, bim.FirstExists(i));
+				Assert::AreEqual(-i, copy.AtFirst(i));
+			}
+			Assert::IsFalse(copy.FirstExists(300));
+			Assert::AreEqual(size_t(150), bim.Size());
+		}
+	};
+}
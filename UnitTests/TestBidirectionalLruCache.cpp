@@ -0,0 +1,129 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <string>
+#include <utility>
+#include <vector>
+#include "../BidirectionalMap/BidirectionalLruCache.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace MapSpecial;
+
+namespace UnitTests
+{
+	TEST_CLASS(BidirectionalLruCacheTest)
+	{
+	public:
+
+		TEST_METHOD(BidirectionalLruCache_InsertBeyondCapacityEvictsLeastRecentlyUsedKeyPair)
+		{
+			BidirectionalLruCache<int, std::string> cache(3);
+			std::vector<std::pair<int, std::string>> evicted;
+			cache.SetEvictionCallback([&evicted](const int& first, const std::string& second) { evicted.emplace_back(first, second); });
+
+			cache.Insert(1, "one");
+			cache.Insert(2, "two");
+			cache.Insert(3, "three");
+			Assert::IsTrue(cache.AtFirst(1) == "one");
+			cache.Insert(4, "four");
+
+			Assert::AreEqual(size_t(3), cache.Size());
+			Assert::AreEqual(size_t(1), evicted.size());
+			Assert::AreEqual(2, evicted[0].first);
+			Assert::IsTrue(evicted[0].second == "two");
+			Assert::IsFalse(cache.FirstExists(2));
+			Assert::IsFalse(cache.SecondExists("two"));
+
+			Assert::AreEqual(3, cache.AtSecond("three"));
+			cache.Insert(5, "five");
+			Assert::IsFalse(cache.FirstExists(1));
+			Assert::AreEqual(size_t(2), cache.Evictions());
+
+			std::vector<int> order;
+			for (const auto& keyPair : cache)
+				order.push_back(keyPair.first);
+			Assert::IsTrue(order == std::vector<int>{ 5, 3, 4 });
+		}
+
+		TEST_METHOD(BidirectionalLruCache_InsertOfExistingKeyPairMakesItMostRecentlyUsed)
+		{
+			BidirectionalLruCache<int, std::string> cache(2);
+			cache.Insert(1, "one");
+			cache.Insert(2, "two");
+
+			Assert::IsFalse(cache.Insert(1, "one"));
+			cache.Insert(3, "three");
+
+			Assert::IsTrue(cache.FirstExists(1));
+			Assert::IsFalse(cache.FirstExists(2));
+
+			try
+			{
+				cache.Insert(1, "uno");
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+		}
+
+		TEST_METHOD(BidirectionalLruCache_LookupsWithoutRefreshKeepInsertionOrder)
+		{
+			BidirectionalLruCache<int, std::string> cache(2, false);
+			cache.Insert(1, "one");
+			cache.Insert(2, "two");
+
+			Assert::IsTrue(*cache.FindFirst(1) == "one");
+			cache.Insert(3, "three");
+
+			Assert::IsFalse(cache.FirstExists(1));
+			Assert::IsTrue(cache.FirstExists(2));
+		}
+
+		TEST_METHOD(BidirectionalLruCache_CountsHitsAndMisses)
+		{
+			BidirectionalLruCache<std::string, int> cache(10);
+			cache.Insert("hello", 5);
+
+			Assert::IsNotNull(cache.FindFirst("hello"));
+			Assert::IsNull(cache.FindFirst("world"));
+			Assert::IsNull(cache.FindSecond(2));
+			try
+			{
+				cache.AtSecond(7);
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+
+			Assert::AreEqual(size_t(1), cache.Hits());
+			Assert::AreEqual(size_t(3), cache.Misses());
+			cache.ResetCounters();
+			Assert::AreEqual(size_t(0), cache.Hits());
+			Assert::AreEqual(size_t(0), cache.Misses());
+		}
+
+		TEST_METHOD(BidirectionalLruCache_SetCapacityEvictsKeyPairsThatDoNotFit)
+		{
+			BidirectionalLruCache<int, int> cache(100);
+			for (int i = 0; i < 100; ++i)
+				cache.Insert(i, -i);
+
+			cache.SetCapacity(10);
+
+			Assert::AreEqual(size_t(10), cache.Size());
+			Assert::AreEqual(size_t(10), cache.Capacity());
+			for (int i = 90; i < 100; ++i)
+				Assert::AreEqual(-i, cache.AtFirst(i));
+
+			try
+			{
+				cache.SetCapacity(0);
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+		}
+	};
+}
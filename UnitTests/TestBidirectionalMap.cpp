@@ -1,6 +1,11 @@
 #include "stdafx.h"
 #include "CppUnitTest.h"
+#include <functional>
+#include <iterator>
+#include <string>
+#include <tuple>
 #include <utility>
+#include <vector>
 #include "../BidirectionalMap/BidirectionalMap.h"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
@@ -8,6 +13,22 @@ using namespace MapSpecial;
 
 namespace UnitTests
 {
+	// key type that counts how many times it has been copied
+	struct CopyCountingKey
+	{
+		explicit CopyCountingKey(int value) : value(value) {}
+		CopyCountingKey(const CopyCountingKey& other) : value(other.value) { ++copies; }
+		CopyCountingKey(CopyCountingKey&& other) noexcept : value(other.value) {}
+		CopyCountingKey& operator=(const CopyCountingKey& other) { value = other.value; ++copies; return *this; }
+		CopyCountingKey& operator=(CopyCountingKey&& other) noexcept { value = other.value; return *this; }
+
+		bool operator<(const CopyCountingKey& other) const { return value < other.value; }
+		bool operator==(const CopyCountingKey& other) const { return value == other.value; }
+
+		int value;
+		static inline int copies = 0;
+	};
+
 	TEST_CLASS(BidirectionalMapTest)
 	{
 	public:
@@ -325,6 +346,56 @@ namespace UnitTests
 			Assert::AreEqual(8, bm2.AtSecond("Dobar dan"));
 		}
 
+		TEST_METHOD(BidirectionalMap_CopyConstructorCreatesIndependentMap)
+		{
+			BidirectionalMap<int, std::string> bm1
+			{
+				{ 5, "hello" },
+				{ 2, "world" },
+				{ 7, "Guten Tag" }
+			};
+
+			BidirectionalMap<int, std::string> bm2(bm1);
+			bm1.RemoveFirst(5);
+			bm1.ChangeSecond(2, "Welt");
+			bm2.Insert(8, "Dobar dan");
+
+			Assert::AreEqual(size_t(2), bm1.Size());
+			Assert::IsFalse(bm1.FirstExists(8));
+			Assert::AreEqual(size_t(4), bm2.Size());
+			Assert::AreEqual(5, bm2.AtSecond("hello"));
+			Assert::AreEqual(std::string("world"), bm2.AtFirst(2));
+			Assert::AreEqual(7, bm2.AtSecond("Guten Tag"));
+			Assert::AreEqual(8, bm2.AtSecond("Dobar dan"));
+			Assert::IsFalse(bm2.SecondExists("Welt"));
+
+			bm2.RemoveSecond("world");
+
+			Assert::IsFalse(bm2.FirstExists(2));
+			Assert::AreEqual(std::string("Welt"), bm1.AtFirst(2));
+		}
+
+		TEST_METHOD(BidirectionalMap_CopyAssignmentCopiesMapData)
+		{
+			BidirectionalMap<int, std::string> bm1
+			{
+				{ 5, "hello" },
+				{ 2, "world" }
+			};
+			BidirectionalMap<int, std::string> bm2
+			{
+				{ 7, "Guten Tag" }
+			};
+
+			bm2 = bm1;
+
+			Assert::AreEqual(size_t(2), bm2.Size());
+			Assert::IsFalse(bm2.FirstExists(7));
+			Assert::AreEqual(5, bm2.AtSecond("hello"));
+			Assert::AreEqual(2, bm2.AtSecond("world"));
+			Assert::AreEqual(size_t(2), bm1.Size());
+		}
+
 		BidirectionalMap<int, std::string> CreateMap()
 		{
 			BidirectionalMap<int, std::string> result;
@@ -535,5 +606,464 @@ namespace UnitTests
 			Assert::AreEqual(bm.SecondExists("hello"), bm.Exists("hello"));
 			Assert::AreEqual(bm.FirstExists(5), bm.Exists(5));
 		}
+
+		TEST_METHOD(BidirectionalMap_IterationVisitsAllKeyPairs)
+		{
+			BidirectionalMap<int, std::string> bm
+			{
+				{ 5, "hello" },
+				{ 2, "world" },
+				{ 7, "Guten Tag" }
+			};
+
+			int sum = 0;
+			size_t count = 0;
+			for (const auto& pair : bm)
+			{
+				Assert::IsTrue(bm.AtFirst(pair.first) == pair.second);
+				sum += pair.first;
+				++count;
+			}
+
+			Assert::AreEqual(size_t(3), count);
+			Assert::AreEqual(14, sum);
+			Assert::AreEqual(size_t(3), size_t(std::distance(bm.cbegin(), bm.cend())));
+		}
+
+		TEST_METHOD(BidirectionalMap_ByFirstAndBySecondVisitKeyPairsInKeyOrder)
+		{
+			BidirectionalMap<int, std::string> bm
+			{
+				{ 5, "hello" },
+				{ 2, "world" },
+				{ 7, "Guten Tag" },
+				{ 8, "Dobar dan" }
+			};
+
+			std::vector<int> firstKeys;
+			for (const auto& pair : bm.ByFirst())
+				firstKeys.push_back(pair.first);
+			std::vector<std::string> secondKeys;
+			for (const auto& pair : bm.BySecond())
+				secondKeys.push_back(pair.second);
+
+			Assert::IsTrue(firstKeys == std::vector<int>{ 2, 5, 7, 8 });
+			Assert::IsTrue(secondKeys == std::vector<std::string>{ "Dobar dan", "Guten Tag", "hello", "world" });
+		}
+
+		TEST_METHOD(BidirectionalMap_BoundMethodsReturnKeyPairsFromGivenKeyToTheEnd)
+		{
+			BidirectionalMap<int, std::string> bm
+			{
+				{ 5, "hello" },
+				{ 2, "world" },
+				{ 7, "Guten Tag" },
+				{ 8, "Dobar dan" }
+			};
+
+			auto lower = bm.LowerBoundFirst(5);
+			Assert::AreEqual(5, lower.begin()->first);
+			Assert::AreEqual(size_t(3), size_t(std::distance(lower.begin(), lower.end())));
+			auto upper = bm.UpperBoundFirst(5);
+			Assert::AreEqual(7, upper.begin()->first);
+			Assert::IsTrue(bm.UpperBoundFirst(8).empty());
+
+			auto lowerSecond = bm.LowerBoundSecond("H");
+			Assert::IsTrue(lowerSecond.begin()->second == "hello");
+			auto upperSecond = bm.UpperBoundSecond("hello");
+			Assert::IsTrue(upperSecond.begin()->second == "world");
+			Assert::AreEqual(size_t(1), size_t(std::distance(upperSecond.begin(), upperSecond.end())));
+		}
+
+		TEST_METHOD(BidirectionalMap_RangeMethodsReturnKeyPairsWithKeysBetweenBounds)
+		{
+			BidirectionalMap<int, std::string> bm;
+			for (int i = 0; i < 100; ++i)
+				bm.Insert(i * 2, std::to_string(i * 2));
+
+			std::vector<int> firstKeys;
+			for (const auto& pair : bm.RangeFirst(11, 20))
+				firstKeys.push_back(pair.first);
+			std::vector<std::string> secondKeys;
+			for (const auto& pair : bm.RangeSecond("50", "56"))
+				secondKeys.push_back(pair.second);
+
+			Assert::IsTrue(firstKeys == std::vector<int>{ 12, 14, 16, 18 });
+			Assert::IsTrue(secondKeys == std::vector<std::string>{ "50", "52", "54" });
+			Assert::IsTrue(bm.RangeFirst(20, 11).empty());
+			Assert::IsTrue(bm.RangeFirst(12, 12).empty());
+		}
+
+		TEST_METHOD(BidirectionalMap_GivenComparatorsOrderEachSide)
+		{
+			BidirectionalMap<int, std::string, std::greater<int>> bm{ { 1, "one" }, { 2, "two" }, { 3, "three" } };
+
+			std::vector<int> firsts;
+			for (const auto& pair : bm.ByFirst())
+				firsts.push_back(pair.first);
+			std::vector<std::string> seconds;
+			for (const auto& pair : bm.BySecond())
+				seconds.push_back(pair.second);
+			Assert::IsTrue(firsts == std::vector<int>{ 3, 2, 1 });
+			Assert::IsTrue(seconds == std::vector<std::string>{ "one", "three", "two" });
+			Assert::AreEqual(2, bm.AtSecond("two"));
+		}
+
+		TEST_METHOD(BidirectionalMap_SecondKeyRangesBuildDroppedSecondIndex)
+		{
+			BidirectionalMap<int, std::string> bm;
+			bm.DropSecondIndex();
+			for (int i = 10; i < 20; ++i)
+				bm.Insert(i, std::to_string(i * 2));
+
+			std::vector<int> firsts;
+			for (const auto& pair : bm.RangeSecond("30", "34"))
+				firsts.push_back(pair.first);
+			Assert::IsTrue(bm.HasSecondIndex());
+			Assert::IsTrue(firsts == std::vector<int>{ 15, 16 });
+			bm.RemoveFirst(16);
+			Assert::AreEqual(size_t(9), static_cast<size_t>(std::distance(bm.BySecond().begin(), bm.BySecond().end())));
+		}
+
+		TEST_METHOD(BidirectionalMap_ExtractedKeyPairCanBeInsertedIntoAnotherMap)
+		{
+			BidirectionalMap<int, std::string> bm1
+			{
+				{ 5, "hello" },
+				{ 2, "world" },
+				{ 7, "Guten Tag" }
+			};
+			BidirectionalMap<int, std::string> bm2{ { 8, "Dobar dan" } };
+
+			auto node1 = bm1.ExtractFirst(5);
+			auto node2 = bm1.ExtractSecond("Guten Tag");
+
+			Assert::AreEqual(size_t(1), bm1.Size());
+			Assert::IsFalse(bm1.FirstExists(5));
+			Assert::IsFalse(bm1.SecondExists("Guten Tag"));
+			Assert::AreEqual(5, node1.First());
+			Assert::IsTrue(node1.Second() == "hello");
+
+			Assert::IsTrue(bm2.Insert(std::move(node1)));
+			Assert::IsTrue(bm2.Insert(std::move(node2)));
+
+			Assert::AreEqual(size_t(3), bm2.Size());
+			Assert::IsTrue(bm2.AtFirst(5) == "hello");
+			Assert::AreEqual(7, bm2.AtSecond("Guten Tag"));
+			bm2.ChangeSecond(5, "Buongiorno");
+			Assert::AreEqual(5, bm2.AtSecond("Buongiorno"));
+		}
+
+		TEST_METHOD(BidirectionalMap_InsertOfNodeWithExistingKeyThrows_invalid_argument_ExceptionAndKeepsKeyPairInNode)
+		{
+			BidirectionalMap<int, std::string> bm1{ { 5, "hello" }, { 2, "world" } };
+			BidirectionalMap<int, std::string> bm2{ { 5, "Dobar dan" } };
+
+			auto node = bm1.ExtractFirst(5);
+
+			try
+			{
+				bm2.Insert(std::move(node));
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+			Assert::IsFalse(node.Empty());
+			Assert::IsTrue(bm1.Insert(std::move(node)));
+			Assert::IsTrue(bm1.AtFirst(5) == "hello");
+			Assert::IsFalse(bm1.Insert(decltype(node)()));
+		}
+
+		TEST_METHOD(BidirectionalMap_ExtractMethodsThrow_out_of_range_ExceptionForNonExistentKey)
+		{
+			BidirectionalMap<int, std::string> bm{ { 5, "hello" } };
+
+			try
+			{
+				bm.ExtractFirst(2);
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+
+			try
+			{
+				bm.ExtractSecond("world");
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+		}
+
+		TEST_METHOD(BidirectionalMap_EmplaceMethodConstructsKeyPairInPlace)
+		{
+			BidirectionalMap<int, std::string> bm;
+
+			Assert::IsTrue(bm.Emplace(std::piecewise_construct, std::forward_as_tuple(5), std::forward_as_tuple(3, 'a')));
+			Assert::IsTrue(bm.Emplace(std::piecewise_construct, std::forward_as_tuple(2), std::forward_as_tuple("world")));
+
+			Assert::AreEqual(size_t(2), bm.Size());
+			Assert::IsTrue(bm.AtFirst(5) == "aaa");
+			Assert::AreEqual(2, bm.AtSecond("world"));
+		}
+
+		TEST_METHOD(BidirectionalMap_EmplaceMethodReturnsFalseForExistingKeyPairAndThrows_invalid_argument_ExceptionIfOneOfKeysExists)
+		{
+			BidirectionalMap<int, std::string> bm{ { 5, "hello" } };
+
+			Assert::IsFalse(bm.Emplace(std::piecewise_construct, std::forward_as_tuple(5), std::forward_as_tuple("hello")));
+
+			try
+			{
+				bm.Emplace(std::piecewise_construct, std::forward_as_tuple(5), std::forward_as_tuple("world"));
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+
+			try
+			{
+				bm.Emplace(std::piecewise_construct, std::forward_as_tuple(2), std::forward_as_tuple("hello"));
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+			Assert::AreEqual(size_t(1), bm.Size());
+			Assert::IsFalse(bm.FirstExists(2));
+			Assert::IsFalse(bm.SecondExists("world"));
+		}
+
+		TEST_METHOD(BidirectionalMap_InsertAndChangeMethodsDoNotCopyTemporaryKeys)
+		{
+			BidirectionalMap<CopyCountingKey, CopyCountingKey> bm;
+			CopyCountingKey::copies = 0;
+
+			bm.Insert(CopyCountingKey(5), CopyCountingKey(2));
+			bm.ChangeFirst(CopyCountingKey(7), CopyCountingKey(2));
+			bm.ChangeSecond(CopyCountingKey(7), CopyCountingKey(3));
+			bm.Emplace(std::piecewise_construct, std::forward_as_tuple(8), std::forward_as_tuple(4));
+
+			Assert::AreEqual(0, CopyCountingKey::copies);
+
+			CopyCountingKey first(1);
+			CopyCountingKey second(9);
+			bm.Insert(first, second);
+
+			Assert::AreEqual(2, CopyCountingKey::copies);
+			Assert::AreEqual(size_t(3), bm.Size());
+			Assert::AreEqual(3, bm.AtFirst(CopyCountingKey(7)).value);
+		}
+
+		TEST_METHOD(BidirectionalMap_InsertOrAssignMethodOverwritesConflictingKeyPairsAndReportsEvictedOnes)
+		{
+			BidirectionalMap<int, std::string> bm{ { 1, "one" }, { 2, "two" }, { 3, "three" } };
+
+			auto result = bm.InsertOrAssign(4, "four");
+			Assert::IsTrue(result.changed);
+			Assert::IsFalse(result.evictedByFirst.has_value());
+			Assert::IsFalse(result.evictedBySecond.has_value());
+
+			result = bm.InsertOrAssign(1, "one");
+			Assert::IsFalse(result.changed);
+
+			result = bm.InsertOrAssign(1, "uno");
+			Assert::IsTrue(result.changed);
+			Assert::IsTrue(*result.evictedByFirst == std::make_pair(1, std::string("one")));
+			Assert::IsFalse(result.evictedBySecond.has_value());
+			Assert::IsTrue(bm.AtFirst(1) == "uno");
+			Assert::IsFalse(bm.SecondExists("one"));
+
+			result = bm.InsertOrAssign(5, "two");
+			Assert::IsTrue(result.changed);
+			Assert::IsFalse(result.evictedByFirst.has_value());
+			Assert::IsTrue(*result.evictedBySecond == std::make_pair(2, std::string("two")));
+			Assert::AreEqual(5, bm.AtSecond("two"));
+			Assert::IsFalse(bm.FirstExists(2));
+
+			result = bm.InsertOrAssign(3, "four");
+			Assert::IsTrue(result.changed);
+			Assert::IsTrue(*result.evictedByFirst == std::make_pair(3, std::string("three")));
+			Assert::IsTrue(*result.evictedBySecond == std::make_pair(4, std::string("four")));
+			Assert::AreEqual(size_t(3), bm.Size());
+			Assert::AreEqual(3, bm.AtSecond("four"));
+			Assert::IsTrue(bm.AtFirst(3) == "four");
+			Assert::IsFalse(bm.FirstExists(4));
+			Assert::IsFalse(bm.SecondExists("three"));
+		}
+
+		TEST_METHOD(BidirectionalMap_InsertOrAssignMethodAcceptsKeyOfEvictedKeyPair)
+		{
+			BidirectionalMap<int, std::string> bm{ { 1, "a string too long for small string optimization" }, { 2, "another string too long for small string optimization" } };
+
+			auto result = bm.InsertOrAssign(1, bm.AtFirst(2));
+			Assert::IsTrue(result.changed);
+			Assert::AreEqual(size_t(1), bm.Size());
+			Assert::IsTrue(bm.AtFirst(1) == "another string too long for small string optimization");
+			Assert::AreEqual(1, bm.AtSecond("another string too long for small string optimization"));
+			Assert::IsFalse(bm.FirstExists(2));
+		}
+
+		TEST_METHOD(BidirectionalMap_InsertOrAssignMethodKeepsOrRejectsConflictingKeyPairsAccordingToPolicy)
+		{
+			BidirectionalMap<int, std::string> bm{ { 1, "one" }, { 2, "two" } };
+
+			auto result = bm.InsertOrAssign(1, "two", ConflictPolicy::KeepExisting);
+			Assert::IsFalse(result.changed);
+			result = bm.InsertOrAssign(3, "three", ConflictPolicy::KeepExisting);
+			Assert::IsTrue(result.changed);
+
+			try
+			{
+				bm.InsertOrAssign(1, "uno", ConflictPolicy::Fail);
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+			try
+			{
+				bm.InsertOrAssign(4, "two", ConflictPolicy::Fail);
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+			Assert::IsFalse(bm.InsertOrAssign(2, "two", ConflictPolicy::Fail).changed);
+
+			Assert::AreEqual(size_t(3), bm.Size());
+			Assert::IsTrue(bm.AtFirst(1) == "one");
+			Assert::IsTrue(bm.AtFirst(2) == "two");
+			Assert::IsTrue(bm.AtFirst(3) == "three");
+		}
+
+		TEST_METHOD(BidirectionalMap_RemapMethodsReplaceAllKeysOfOneSide)
+		{
+			BidirectionalMap<int, std::string> bm{ { 1, "one" }, { 2, "two" }, { 3, "three" } };
+
+			// keys are exchanged, which would not be possible with ChangeFirst
+			bm.RemapFirst([](int first) { return first == 3 ? 3 : 3 - first; });
+			Assert::AreEqual(size_t(3), bm.Size());
+			Assert::IsTrue(bm.AtFirst(1) == "two");
+			Assert::IsTrue(bm.AtFirst(2) == "one");
+			Assert::IsTrue(bm.AtFirst(3) == "three");
+			Assert::AreEqual(2, bm.AtSecond("one"));
+
+			bm.RemapSecond([](const std::string& second) { return second + "!"; });
+			Assert::IsTrue(bm.AtFirst(1) == "two!");
+			Assert::AreEqual(3, bm.AtSecond("three!"));
+			Assert::IsFalse(bm.SecondExists("three"));
+		}
+
+		TEST_METHOD(BidirectionalMap_RemapMethodsThrow_invalid_argument_ExceptionAndKeepMapIfNewKeysAreNotUnique)
+		{
+			BidirectionalMap<int, std::string> bm{ { 1, "one" }, { 2, "two" }, { 3, "three" } };
+
+			try
+			{
+				bm.RemapFirst([](int first) { return first % 2; });
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+			try
+			{
+				bm.RemapSecond([](const std::string& second) { return second.substr(0, 1); });
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+
+			Assert::AreEqual(size_t(3), bm.Size());
+			Assert::IsTrue(bm.AtFirst(1) == "one");
+			Assert::IsTrue(bm.AtFirst(2) == "two");
+			Assert::IsTrue(bm.AtFirst(3) == "three");
+			Assert::AreEqual(2, bm.AtSecond("two"));
+		}
+
+		TEST_METHOD(BidirectionalMap_EraseIfMethodRemovesKeyPairsMatchingPredicate)
+		{
+			BidirectionalMap<int, std::string> bm;
+			for (int i = 0; i < 100; ++i)
+				bm.Insert(i, std::to_string(i));
+
+			size_t count = bm.EraseIf([](const std::pair<int, std::string>& keyPair) { return keyPair.first % 3 == 0; });
+
+			Assert::AreEqual(size_t(34), count);
+			Assert::AreEqual(size_t(66), bm.Size());
+			for (int i = 0; i < 100; ++i)
+			{
+				Assert::AreEqual(i % 3 != 0, bm.FirstExists(i));
+				Assert::AreEqual(i % 3 != 0, bm.SecondExists(std::to_string(i)));
+			}
+			Assert::AreEqual(size_t(0), bm.EraseIf([](const std::pair<int, std::string>&) { return false; }));
+		}
+
+		TEST_METHOD(BidirectionalMap_RemoveRangeMethodsRemoveExistingKeysAndSkipOthers)
+		{
+			BidirectionalMap<int, std::string> bm{ { 1, "one" }, { 2, "two" }, { 3, "three" }, { 4, "four" } };
+
+			Assert::AreEqual(size_t(2), bm.RemoveFirstRange(std::vector<int>{ 1, 5, 3 }));
+			Assert::AreEqual(size_t(1), bm.RemoveSecondRange(std::vector<std::string>{ "one", "four" }));
+
+			Assert::AreEqual(size_t(1), bm.Size());
+			Assert::IsTrue(bm.AtFirst(2) == "two");
+		}
+
+		TEST_METHOD(BidirectionalMap_InsertRangeMethodInsertsNothingAndReportsConflictsIfPolicyIsFail)
+		{
+			BidirectionalMap<int, std::string> bm{ { 1, "one" }, { 2, "two" } };
+			std::vector<std::pair<int, std::string>> keyPairs{ { 3, "three" }, { 1, "one" }, { 4, "two" }, { 5, "five" }, { 5, "cinque" }, { 3, "three" } };
+
+			auto result = bm.InsertRange(keyPairs.cbegin(), keyPairs.cend());
+
+			Assert::AreEqual(size_t(0), result.inserted);
+			Assert::AreEqual(size_t(2), result.duplicates);
+			Assert::AreEqual(size_t(2), result.conflicts.size());
+			Assert::AreEqual(size_t(2), result.conflicts[0]);
+			Assert::AreEqual(size_t(4), result.conflicts[1]);
+			Assert::AreEqual(size_t(2), bm.Size());
+			Assert::IsFalse(bm.FirstExists(3));
+		}
+
+		TEST_METHOD(BidirectionalMap_InsertRangeMethodSkipsConflictsIfPolicyIsKeepExisting)
+		{
+			BidirectionalMap<int, std::string> bm{ { 1, "one" }, { 2, "two" } };
+			std::vector<std::pair<int, std::string>> keyPairs{ { 3, "three" }, { 1, "one" }, { 4, "two" }, { 5, "five" }, { 5, "cinque" } };
+
+			auto result = bm.InsertRange(keyPairs.cbegin(), keyPairs.cend(), ConflictPolicy::KeepExisting);
+
+			Assert::AreEqual(size_t(2), result.inserted);
+			Assert::AreEqual(size_t(1), result.duplicates);
+			Assert::AreEqual(size_t(2), result.conflicts.size());
+			Assert::AreEqual(size_t(4), bm.Size());
+			Assert::IsTrue(bm.AtFirst(3) == "three");
+			Assert::IsTrue(bm.AtFirst(5) == "five");
+			Assert::AreEqual(2, bm.AtSecond("two"));
+			Assert::IsFalse(bm.FirstExists(4));
+		}
+
+		TEST_METHOD(BidirectionalMap_InsertRangeMethodAssignsKeyPairsInOrderIfPolicyIsOverwrite)
+		{
+			BidirectionalMap<int, std::string> bm{ { 1, "one" }, { 2, "two" } };
+			std::vector<std::pair<int, std::string>> keyPairs{ { 3, "three" }, { 1, "one" }, { 4, "two" }, { 5, "five" }, { 5, "cinque" } };
+
+			auto result = bm.InsertRange(keyPairs.cbegin(), keyPairs.cend(), ConflictPolicy::Overwrite);
+
+			Assert::AreEqual(size_t(4), result.inserted);
+			Assert::AreEqual(size_t(1), result.duplicates);
+			Assert::AreEqual(size_t(2), result.conflicts.size());
+			Assert::AreEqual(size_t(4), bm.Size());
+			Assert::AreEqual(4, bm.AtSecond("two"));
+			Assert::IsTrue(bm.AtFirst(5) == "cinque");
+			Assert::IsFalse(bm.FirstExists(2));
+			Assert::IsFalse(bm.SecondExists("five"));
+		}
 	};
 }
\ No newline at end of file
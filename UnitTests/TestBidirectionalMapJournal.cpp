@@ -0,0 +1,276 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "../BidirectionalMap/BidirectionalMap.h"
+#include "../BidirectionalMap/BidirectionalMapJournal.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace MapSpecial;
+
+namespace UnitTests
+{
+	TEST_CLASS(BidirectionalMapJournalTest)
+	{
+	public:
+
+		const std::string journalPath = "BidirectionalMapJournalTest.journal";
+		const std::string snapshotPath = "BidirectionalMapJournalTest.snapshot";
+
+		TEST_METHOD_INITIALIZE(RemoveFilesBeforeTest)
+		{
+			std::remove(journalPath.c_str());
+			std::remove(snapshotPath.c_str());
+		}
+
+		TEST_METHOD_CLEANUP(RemoveFilesAfterTest)
+		{
+			std::remove(journalPath.c_str());
+			std::remove(snapshotPath.c_str());
+		}
+
+		TEST_METHOD(BidirectionalMapJournal_ReplayReproducesAllModifications)
+		{
+			BidirectionalUnorderedMap<std::string, int> bum;
+			{
+				BidirectionalMapJournal<std::string, int> journal(journalPath);
+				bum.AttachJournal(&journal);
+				bum.Insert("hello", 5);
+				bum.Insert("world", 2);
+				bum.Insert("Guten Tag", 7);
+				bum.Insert("Dobar dan", 8);
+				bum.ChangeFirst("Buongiorno", 7);
+				bum.ChangeSecond("world", 3);
+				bum.RemoveFirst("hello");
+				bum.RemoveSecond(8);
+				bum.Insert("hello", 1);
+				journal.Commit();
+				bum.AttachJournal(nullptr);
+			}
+
+			BidirectionalUnorderedMap<std::string, int> recovered;
+			size_t count = BidirectionalMapJournal<std::string, int>::Replay(journalPath, recovered);
+
+			Assert::AreEqual(size_t(9), count);
+			Assert::AreEqual(size_t(3), recovered.Size());
+			Assert::AreEqual(1, recovered.AtFirst("hello"));
+			Assert::AreEqual(3, recovered.AtFirst("world"));
+			Assert::AreEqual(7, recovered.AtFirst("Buongiorno"));
+			Assert::IsFalse(recovered.FirstExists("Guten Tag"));
+			Assert::IsFalse(recovered.FirstExists("Dobar dan"));
+		}
+
+		TEST_METHOD(BidirectionalMapJournal_ReplayReproducesInsertOrAssign)
+		{
+			BidirectionalMap<int, std::string> bm{ { 1, "one" }, { 2, "two" }, { 3, "three" } };
+			{
+				BidirectionalMapJournal<int, std::string> journal(journalPath);
+				bm.AttachJournal(&journal);
+				bm.InsertOrAssign(4, "four");
+				bm.InsertOrAssign(1, "uno");
+				bm.InsertOrAssign(5, "two");
+				bm.InsertOrAssign(3, "four");
+				bm.AttachJournal(nullptr);
+			}
+
+			BidirectionalMap<int, std::string> recovered{ { 1, "one" }, { 2, "two" }, { 3, "three" } };
+			BidirectionalMapJournal<int, std::string>::Replay(journalPath, recovered);
+
+			Assert::AreEqual(bm.Size(), recovered.Size());
+			for (const auto& keyPair : bm)
+				Assert::IsTrue(recovered.AtFirst(keyPair.first) == keyPair.second);
+		}
+
+		TEST_METHOD(BidirectionalMapJournal_ReplayReproducesRemappedKeys)
+		{
+			BidirectionalUnorderedMap<std::string, int> bum{ { "hello", 5 }, { "world", 2 } };
+			{
+				BidirectionalMapJournal<std::string, int> journal(journalPath);
+				bum.AttachJournal(&journal);
+				bum.RemapSecond([](int second) { return 7 - second; });
+				bum.Insert("Guten Tag", 7);
+				bum.AttachJournal(nullptr);
+			}
+
+			BidirectionalUnorderedMap<std::string, int> recovered{ { "hello", 5 }, { "world", 2 } };
+			BidirectionalMapJournal<std::string, int>::Replay(journalPath, recovered);
+
+			Assert::AreEqual(size_t(3), recovered.Size());
+			Assert::AreEqual(2, recovered.AtFirst("hello"));
+			Assert::AreEqual(5, recovered.AtFirst("world"));
+			Assert::AreEqual(7, recovered.AtFirst("Guten Tag"));
+		}
+
+		TEST_METHOD(BidirectionalMapJournal_ReplayAfterClearContainsOnlyLaterKeyPairs)
+		{
+			BidirectionalMap<int, std::string> bm;
+			{
+				BidirectionalMapJournal<int, std::string> journal(journalPath);
+				bm.AttachJournal(&journal);
+				bm.Insert(5, "hello");
+				bm.Clear();
+				bm.Insert(2, "world");
+				bm.AttachJournal(nullptr);
+			}
+
+			BidirectionalMap<int, std::string> recovered{ { 7, "Guten Tag" } };
+			BidirectionalMapJournal<int, std::string>::Replay(journalPath, recovered);
+
+			Assert::AreEqual(size_t(1), recovered.Size());
+			Assert::IsTrue(recovered.AtFirst(2) == "world");
+		}
+
+		TEST_METHOD(BidirectionalMapJournal_SnapshotAndTruncatedJournalRecoverMap)
+		{
+			BidirectionalUnorderedMap<std::string, int> bum;
+			BidirectionalMapJournal<std::string, int> journal(journalPath);
+			bum.AttachJournal(&journal);
+			for (int i = 0; i < 1000; ++i)
+				bum.Insert("key" + std::to_string(i), i);
+			bum.SaveSnapshot(snapshotPath);
+			journal.Truncate();
+			for (int i = 0; i < 1000; i += 2)
+				bum.RemoveSecond(i);
+			bum.Insert("hello", 5000);
+			journal.Commit();
+
+			BidirectionalUnorderedMap<std::string, int> recovered;
+			recovered.LoadSnapshot(snapshotPath);
+			size_t count = BidirectionalMapJournal<std::string, int>::Replay(journalPath, recovered);
+
+			Assert::AreEqual(size_t(501), count);
+			Assert::AreEqual(size_t(501), recovered.Size());
+			for (int i = 0; i < 1000; ++i)
+				Assert::AreEqual(i % 2 != 0, recovered.FirstExists("key" + std::to_string(i)));
+			Assert::AreEqual(5000, recovered.AtFirst("hello"));
+			bum.AttachJournal(nullptr);
+		}
+
+		TEST_METHOD(BidirectionalMapJournal_IncompleteRecordAtTheEndIsIgnoredAndOverwritten)
+		{
+			{
+				BidirectionalMapJournal<std::string, int> journal(journalPath);
+				journal.RecordInsert("hello", 5);
+				journal.RecordInsert("world", 2);
+			}
+			std::ifstream input(journalPath, std::ios::binary);
+			std::string content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+			input.close();
+			std::ofstream output(journalPath, std::ios::binary | std::ios::trunc);
+			output.write(content.data(), content.size() - 3);
+			output.close();
+
+			BidirectionalUnorderedMap<std::string, int> recovered;
+			Assert::AreEqual(size_t(1), BidirectionalMapJournal<std::string, int>::Replay(journalPath, recovered));
+			Assert::IsTrue(recovered.FirstExists("hello"));
+			Assert::IsFalse(recovered.FirstExists("world"));
+
+			{
+				BidirectionalMapJournal<std::string, int> journal(journalPath);
+				journal.RecordInsert("Guten Tag", 7);
+			}
+			BidirectionalUnorderedMap<std::string, int> reopened;
+			Assert::AreEqual(size_t(2), BidirectionalMapJournal<std::string, int>::Replay(journalPath, reopened));
+			Assert::IsTrue(reopened.FirstExists("hello"));
+			Assert::IsTrue(reopened.FirstExists("Guten Tag"));
+		}
+
+		// journal that accepts a given number of records and fails to write the following ones
+		class FailingJournal : public BidirectionalMapJournalBase<std::string, int>
+		{
+		public:
+			explicit FailingJournal(size_t accepted) : accepted(accepted) {}
+
+			void RecordInsert(const std::string&, const int&) override { Record(); }
+			void RecordChangeFirst(const std::string&, const int&) override { Record(); }
+			void RecordChangeSecond(const std::string&, const int&) override { Record(); }
+			void RecordRemoveFirst(const std::string&) override { Record(); }
+			void RecordRemoveSecond(const int&) override { Record(); }
+			void RecordClear() override { Record(); }
+
+		private:
+			size_t accepted;
+
+			void Record()
+			{
+				if (accepted == 0)
+					throw std::runtime_error("Cannot write journal file.");
+				--accepted;
+			}
+		};
+
+		TEST_METHOD(BidirectionalMapJournal_ModificationThatCannotBeRecordedLeavesMapUnchanged)
+		{
+			BidirectionalUnorderedMap<std::string, int> bum{ { "hello", 5 }, { "world", 2 } };
+			FailingJournal journal(0);
+			bum.AttachJournal(&journal);
+
+			auto expectFailure = [](auto modification)
+			{
+				try
+				{
+					modification();
+					Assert::Fail();
+				}
+				catch (const std::runtime_error&)
+				{
+				}
+			};
+			expectFailure([&]() { bum.Insert("Guten Tag", 7); });
+			expectFailure([&]() { bum.Emplace(std::piecewise_construct, std::make_tuple("Guten Tag"), std::make_tuple(7)); });
+			expectFailure([&]() { bum.ChangeFirst("Buongiorno", 5); });
+			expectFailure([&]() { bum.ChangeSecond("world", 3); });
+			expectFailure([&]() { bum.InsertOrAssign("hello", 2); });
+			expectFailure([&]() { bum.RemoveFirst("hello"); });
+			expectFailure([&]() { bum.Clear(); });
+			bum.AttachJournal(nullptr);
+
+			Assert::AreEqual(size_t(2), bum.Size());
+			Assert::AreEqual(5, bum.AtFirst("hello"));
+			Assert::AreEqual(2, bum.AtFirst("world"));
+			Assert::IsFalse(bum.FirstExists("Guten Tag"));
+		}
+
+		TEST_METHOD(BidirectionalMapJournal_InsertRangeKeepsKeyPairsRecordedBeforeFailure)
+		{
+			BidirectionalUnorderedMap<std::string, int> bum;
+			FailingJournal journal(2);
+			bum.AttachJournal(&journal);
+			std::vector<std::pair<std::string, int>> keyPairs{ { "hello", 5 }, { "world", 2 }, { "Guten Tag", 7 } };
+
+			try
+			{
+				bum.InsertRange(keyPairs.begin(), keyPairs.end());
+				Assert::Fail();
+			}
+			catch (const std::runtime_error&)
+			{
+			}
+			bum.AttachJournal(nullptr);
+
+			Assert::AreEqual(size_t(2), bum.Size());
+			Assert::IsTrue(bum.Insert("Guten Tag", 7));
+		}
+
+		TEST_METHOD(BidirectionalMapJournal_ConstructorThrows_runtime_error_ExceptionIfKeyTypesDoNotMatch)
+		{
+			{
+				BidirectionalMapJournal<std::string, int> journal(journalPath);
+				journal.RecordInsert("hello", 5);
+			}
+
+			try
+			{
+				BidirectionalMapJournal<int, std::string> journal(journalPath);
+				Assert::Fail();
+			}
+			catch (const std::runtime_error&)
+			{
+			}
+		}
+	};
+}
@@ -0,0 +1,204 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+#include "../BidirectionalMap/BidirectionalMap.h"
+#include "../BidirectionalMap/BidirectionalMapView.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace MapSpecial;
+
+namespace UnitTests
+{
+	TEST_CLASS(BidirectionalMapViewTest)
+	{
+	public:
+
+		const std::string snapshotPath = "BidirectionalMapViewTest.snapshot";
+
+		TEST_METHOD_CLEANUP(RemoveSnapshot)
+		{
+			std::remove(snapshotPath.c_str());
+		}
+
+		TEST_METHOD(BidirectionalMapView_ProvidesAccessToAllKeyPairsSavedInSnapshot)
+		{
+			BidirectionalUnorderedMap<int, std::string> bum
+			{
+				{ 5, "hello" },
+				{ 2, "world" },
+				{ 7, "Guten Tag" },
+				{ 8, "" }
+			};
+			bum.SaveSnapshot(snapshotPath);
+
+			BidirectionalMapView<int, std::string> view(snapshotPath);
+
+			Assert::AreEqual(size_t(4), view.Size());
+			Assert::IsTrue(view.AtFirst(5) == "hello");
+			Assert::IsTrue(view.AtFirst(2) == "world");
+			Assert::IsTrue(view.AtFirst(7) == "Guten Tag");
+			Assert::IsTrue(view.AtFirst(8) == "");
+			Assert::AreEqual(5, view.AtSecond("hello"));
+			Assert::AreEqual(2, view.AtSecond(std::string("world")));
+			Assert::AreEqual(7, view.AtSecond("Guten Tag"));
+			Assert::AreEqual(8, view.AtSecond(""));
+		}
+
+		TEST_METHOD(BidirectionalMapView_ExistsMethodsReturnFalseForNonExistentKeys)
+		{
+			BidirectionalMap<std::string, double> bm
+			{
+				{ "pi", 3.14159 },
+				{ "e", 2.71828 }
+			};
+			bm.SaveSnapshot(snapshotPath);
+
+			BidirectionalMapView<std::string, double> view(snapshotPath);
+
+			Assert::IsTrue(view.FirstExists("pi"));
+			Assert::IsTrue(view.SecondExists(2.71828));
+			Assert::IsTrue(view.Exists("e"));
+			Assert::IsFalse(view.FirstExists("phi"));
+			Assert::IsFalse(view.SecondExists(1.61803));
+			Assert::IsFalse(view.Exists(1.61803));
+		}
+
+		TEST_METHOD(BidirectionalMapView_AtMethodsThrow_out_of_range_ExceptionForNonExistentKey)
+		{
+			BidirectionalUnorderedMap<int, std::string> bum{ { 5, "hello" } };
+			bum.SaveSnapshot(snapshotPath);
+
+			BidirectionalMapView<int, std::string> view(snapshotPath);
+
+			try
+			{
+				view.AtFirst(6);
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+
+			try
+			{
+				view.AtSecond("world");
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+		}
+
+		TEST_METHOD(BidirectionalMapView_ProvidesAccessToAllKeyPairsOfLargeSnapshot)
+		{
+			BidirectionalUnorderedMap<std::string, unsigned long long> bum;
+			for (unsigned long long i = 0; i < 10000; ++i)
+				bum.Insert("key" + std::to_string(i * 7919), i);
+			bum.SaveSnapshot(snapshotPath);
+
+			BidirectionalMapView<std::string, unsigned long long> view(snapshotPath);
+
+			Assert::AreEqual(size_t(10000), view.Size());
+			for (unsigned long long i = 0; i < 10000; ++i)
+			{
+				std::string key = "key" + std::to_string(i * 7919);
+				Assert::AreEqual(i, view.AtFirst(key));
+				Assert::IsTrue(view.AtSecond(i) == key);
+			}
+			Assert::IsFalse(view.FirstExists("key1"));
+			Assert::IsFalse(view.SecondExists(10000));
+		}
+
+		TEST_METHOD(BidirectionalMapView_ConstructorThrows_runtime_error_ExceptionIfKeyTypesDoNotMatch)
+		{
+			BidirectionalUnorderedMap<int, std::string> bum{ { 5, "hello" } };
+			bum.SaveSnapshot(snapshotPath);
+
+			try
+			{
+				BidirectionalMapView<std::string, int> view(snapshotPath);
+				Assert::Fail();
+			}
+			catch (const std::runtime_error&)
+			{
+			}
+		}
+
+		TEST_METHOD(BidirectionalMapView_KeepsReadingOldContentWhenSnapshotIsSavedOverIt)
+		{
+			BidirectionalUnorderedMap<int, std::string> bum;
+			for (int i = 0; i < 100000; ++i)
+				bum.Insert(i, std::to_string(i));
+			bum.SaveSnapshot(snapshotPath);
+			BidirectionalMapView<int, std::string> view(snapshotPath);
+
+			BidirectionalUnorderedMap<int, std::string>{ { 1, "one" } }.SaveSnapshot(snapshotPath);
+
+			Assert::AreEqual(size_t(100000), view.Size());
+			Assert::AreEqual(99999, view.AtSecond("99999"));
+			Assert::IsTrue(BidirectionalMapView<int, std::string>(snapshotPath).AtFirst(1) == "one");
+		}
+
+		TEST_METHOD(BidirectionalMapView_ConstructorThrows_runtime_error_ExceptionIfStringIsOutsideBlob)
+		{
+			BidirectionalUnorderedMap<int, std::string> bum{ { 5, "hello" }, { 2, "world" } };
+			bum.SaveSnapshot(snapshotPath);
+			Snapshot::SnapshotHeader header;
+			{
+				std::fstream file(snapshotPath, std::ios::in | std::ios::out | std::ios::binary);
+				file.read(reinterpret_cast<char*>(&header), sizeof(header));
+				Snapshot::Field field{ 0xFFFFFFFFFFFFFFF0ull, 32 };
+				file.seekp(header.pairsOffset + sizeof(Snapshot::PairRecord) + sizeof(Snapshot::Field));
+				file.write(reinterpret_cast<const char*>(&field), sizeof(field));
+			}
+
+			try
+			{
+				BidirectionalMapView<int, std::string> view(snapshotPath);
+				Assert::Fail();
+			}
+			catch (const std::runtime_error&)
+			{
+			}
+		}
+
+		TEST_METHOD(BidirectionalMapView_LookupsSkipIndexEntriesOfNonExistentKeyPairs)
+		{
+			BidirectionalUnorderedMap<int, std::string> bum{ { 5, "hello" }, { 2, "world" } };
+			bum.SaveSnapshot(snapshotPath);
+			Snapshot::SnapshotHeader header;
+			{
+				std::fstream file(snapshotPath, std::ios::in | std::ios::out | std::ios::binary);
+				file.read(reinterpret_cast<char*>(&header), sizeof(header));
+				std::uint64_t corrupted = (Snapshot::SnapshotTraits<int>::HashOf(5) << 32) | 1000;
+				for (std::uint64_t i = 0; i < header.indexCapacity; ++i)
+				{
+					file.seekp(header.index1Offset + i * sizeof(std::uint64_t));
+					file.write(reinterpret_cast<const char*>(&corrupted), sizeof(corrupted));
+				}
+			}
+
+			BidirectionalMapView<int, std::string> view(snapshotPath);
+
+			Assert::IsFalse(view.FirstExists(5));
+			Assert::IsFalse(view.FirstExists(3));
+			Assert::AreEqual(2, view.AtSecond("world"));
+		}
+
+		TEST_METHOD(BidirectionalMapView_ConstructorThrows_runtime_error_ExceptionIfFileDoesNotExist)
+		{
+			try
+			{
+				BidirectionalMapView<int, std::string> view("NonExistent.snapshot");
+				Assert::Fail();
+			}
+			catch (const std::runtime_error&)
+			{
+			}
+		}
+	};
+}
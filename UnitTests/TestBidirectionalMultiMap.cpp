@@ -0,0 +1,155 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <algorithm>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../BidirectionalMap/BidirectionalMultiMap.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace MapSpecial;
+
+namespace UnitTests
+{
+	TEST_CLASS(BidirectionalMultiMapTest)
+	{
+	public:
+
+		TEST_METHOD(BidirectionalMultiMap_EqualRangeMethodsReturnAllKeyPairsOfGivenKey)
+		{
+			BidirectionalMultiMap<std::string, std::string> bmm
+			{
+				{ "alice", "admins" },
+				{ "alice", "users" },
+				{ "bob", "users" },
+				{ "carol", "guests" }
+			};
+
+			Assert::AreEqual(size_t(4), bmm.Size());
+			Assert::IsFalse(bmm.Insert("bob", "users"));
+
+			auto groups = bmm.EqualRangeFirst("alice");
+			Assert::AreEqual(size_t(2), groups.size());
+			std::set<std::string> names;
+			for (const auto& keyPair : groups)
+				names.insert(keyPair.second);
+			Assert::IsTrue(names == std::set<std::string>{ "admins", "users" });
+
+			auto users = bmm.EqualRangeSecond("users");
+			Assert::AreEqual(size_t(2), users.size());
+			Assert::AreEqual(2, static_cast<int>(users.end() - users.begin()));
+			Assert::IsTrue(users[0].second == "users");
+			Assert::AreEqual(size_t(1), bmm.CountSecond("guests"));
+			Assert::IsTrue(bmm.EqualRangeFirst("dave").empty());
+		}
+
+		TEST_METHOD(BidirectionalMultiMap_RemovePairKeepsOtherKeyPairsOfBothKeys)
+		{
+			BidirectionalMultiMap<std::string, std::string> bmm
+			{
+				{ "alice", "admins" },
+				{ "alice", "users" },
+				{ "bob", "users" }
+			};
+
+			bmm.RemovePair("alice", "users");
+
+			Assert::AreEqual(size_t(2), bmm.Size());
+			Assert::IsFalse(bmm.PairExists("alice", "users"));
+			Assert::IsTrue(bmm.PairExists("alice", "admins"));
+			Assert::IsTrue(bmm.PairExists("bob", "users"));
+			Assert::AreEqual(size_t(1), bmm.CountFirst("alice"));
+
+			try
+			{
+				bmm.RemovePair("bob", "admins");
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+		}
+
+		TEST_METHOD(BidirectionalMultiMap_RemoveFirstAndRemoveSecondRemoveAllKeyPairsOfGivenKey)
+		{
+			BidirectionalMultiMap<int, int> bmm;
+			for (int user = 0; user < 10; ++user)
+			{
+				for (int group = 0; group < 10; ++group)
+					bmm.Insert(user, group);
+			}
+
+			bmm.RemoveFirst(3);
+			bmm.RemoveSecond(7);
+
+			Assert::AreEqual(size_t(81), bmm.Size());
+			Assert::IsFalse(bmm.FirstExists(3));
+			Assert::IsFalse(bmm.SecondExists(7));
+			for (int user = 0; user < 10; ++user)
+			{
+				if (user != 3)
+					Assert::AreEqual(size_t(9), bmm.CountFirst(user));
+			}
+		}
+
+		TEST_METHOD(BidirectionalMultiMap_RandomModificationsKeepBothIndicesConsistent)
+		{
+			BidirectionalMultiMap<int, int> bmm;
+			std::set<std::pair<int, int>> expected;
+			std::default_random_engine random;
+			std::uniform_int_distribution<int> key(0, 30);
+			for (int i = 0; i < 5000; ++i)
+			{
+				int first = key(random);
+				int second = key(random);
+				if (i % 3 == 0 && bmm.PairExists(first, second))
+				{
+					bmm.RemovePair(first, second);
+					expected.erase({ first, second });
+				}
+				else
+				{
+					Assert::AreEqual(expected.insert({ first, second }).second, bmm.Insert(first, second));
+				}
+			}
+
+			Assert::AreEqual(expected.size(), bmm.Size());
+			for (int k = 0; k <= 30; ++k)
+			{
+				for (const auto& keyPair : bmm.EqualRangeFirst(k))
+					Assert::IsTrue(keyPair.first == k && expected.count(keyPair) == 1);
+				for (const auto& keyPair : bmm.EqualRangeSecond(k))
+					Assert::IsTrue(keyPair.second == k && expected.count(keyPair) == 1);
+				size_t count = std::count_if(expected.begin(), expected.end(), [k](const std::pair<int, int>& keyPair) { return keyPair.first == k; });
+				Assert::AreEqual(count, bmm.CountFirst(k));
+			}
+		}
+
+		TEST_METHOD(BidirectionalOneToManyMap_InsertThrows_invalid_argument_ExceptionIfSecondKeyHasAnotherFirstKey)
+		{
+			BidirectionalOneToManyMap<std::string, int> bom
+			{
+				{ "admins", 1 },
+				{ "admins", 2 },
+				{ "users", 3 }
+			};
+
+			Assert::IsFalse(bom.Insert("admins", 2));
+			try
+			{
+				bom.Insert("users", 2);
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+
+			Assert::IsTrue(bom.AtSecond(2) == "admins");
+			Assert::AreEqual(size_t(2), bom.CountFirst("admins"));
+			bom.RemoveSecond(1);
+			Assert::AreEqual(size_t(1), bom.CountFirst("admins"));
+		}
+	};
+}
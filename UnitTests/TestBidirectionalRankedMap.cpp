@@ -0,0 +1,182 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "../BidirectionalMap/BidirectionalMap.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace MapSpecial;
+
+namespace UnitTests
+{
+	TEST_CLASS(BidirectionalRankedMapTest)
+	{
+	public:
+
+		TEST_METHOD(BidirectionalRankedMap_SupportsAllModificationsOfBidirectionalMap)
+		{
+			BidirectionalRankedMap<int, std::string> brm
+			{
+				{ 5, "hello" },
+				{ 2, "world" },
+				{ 7, "Guten Tag" }
+			};
+
+			brm.Insert(8, "Dobar dan");
+			brm.ChangeFirst(9, "hello");
+			brm.ChangeSecond(2, "Buongiorno");
+			brm.RemoveFirst(7);
+
+			Assert::AreEqual(size_t(3), brm.Size());
+			Assert::IsTrue(brm.AtFirst(9) == "hello");
+			Assert::IsTrue(brm.AtFirst(2) == "Buongiorno");
+			Assert::AreEqual(8, brm.AtSecond("Dobar dan"));
+			Assert::IsFalse(brm.FirstExists(5));
+			Assert::IsFalse(brm.SecondExists("Guten Tag"));
+		}
+
+		TEST_METHOD(BidirectionalRankedMap_RankAndSelectMethodsUseSortedOrderOfEachSide)
+		{
+			BidirectionalRankedMap<int, std::string> brm
+			{
+				{ 5, "hello" },
+				{ 2, "world" },
+				{ 7, "Guten Tag" },
+				{ 8, "Dobar dan" }
+			};
+
+			Assert::AreEqual(size_t(0), brm.RankOfFirst(2));
+			Assert::AreEqual(size_t(1), brm.RankOfFirst(5));
+			Assert::AreEqual(size_t(2), brm.RankOfFirst(6));
+			Assert::AreEqual(size_t(4), brm.RankOfFirst(9));
+			Assert::AreEqual(size_t(0), brm.RankOfSecond("Dobar dan"));
+			Assert::AreEqual(size_t(3), brm.RankOfSecond("world"));
+
+			Assert::AreEqual(7, brm.SelectFirst(2).first);
+			Assert::IsTrue(brm.SelectFirst(3).second == "Dobar dan");
+			Assert::IsTrue(brm.SelectSecond(1).second == "Guten Tag");
+			Assert::AreEqual(2, brm.SelectSecond(3).first);
+		}
+
+		TEST_METHOD(BidirectionalRankedMap_CountMethodsReturnNumberOfKeysBetweenBounds)
+		{
+			BidirectionalRankedMap<int, std::string> brm;
+			for (int i = 0; i < 100; ++i)
+				brm.Insert(i * 2, std::to_string(i * 2));
+
+			Assert::AreEqual(size_t(4), brm.CountFirst(11, 20));
+			Assert::AreEqual(size_t(100), brm.CountFirst(-1, 1000));
+			Assert::AreEqual(size_t(0), brm.CountFirst(20, 11));
+			Assert::AreEqual(size_t(3), brm.CountSecond("50", "56"));
+		}
+
+		TEST_METHOD(BidirectionalRankedMap_CountMethodsUseComparatorOfEachSide)
+		{
+			BidirectionalRankedMap<int, int, std::greater<int>, std::greater<int>> brm;
+			for (int i = 0; i < 10; ++i)
+				brm.Insert(i, i + 10);
+
+			Assert::AreEqual(size_t(6), brm.CountFirst(8, 2));
+			Assert::AreEqual(size_t(0), brm.CountFirst(2, 8));
+			Assert::AreEqual(size_t(6), brm.CountSecond(18, 12));
+			Assert::AreEqual(size_t(0), brm.CountSecond(12, 18));
+		}
+
+		TEST_METHOD(BidirectionalRankedMap_SelectMethodsThrow_out_of_range_ExceptionForPositionOutsideMap)
+		{
+			BidirectionalRankedMap<int, std::string> brm{ { 5, "hello" } };
+
+			try
+			{
+				brm.SelectFirst(1);
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+
+			try
+			{
+				brm.SelectSecond(1);
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+		}
+
+		TEST_METHOD(BidirectionalRankedMap_RanksRemainCorrectAfterManyRandomInsertionsAndRemovals)
+		{
+			BidirectionalRankedMap<int, int> brm;
+			std::set<int> firstKeys;
+			std::default_random_engine random;
+			std::uniform_int_distribution<int> distribution(0, 999);
+			for (int i = 0; i < 10000; ++i)
+			{
+				int key = distribution(random);
+				if (brm.FirstExists(key))
+				{
+					brm.RemoveFirst(key);
+					firstKeys.erase(key);
+				}
+				else
+				{
+					brm.Insert(key, -key);
+					firstKeys.insert(key);
+				}
+			}
+
+			size_t position = 0;
+			for (int key : firstKeys)
+			{
+				Assert::AreEqual(position, brm.RankOfFirst(key));
+				Assert::AreEqual(key, brm.SelectFirst(position).first);
+				Assert::AreEqual(firstKeys.size() - 1 - position, brm.RankOfSecond(-key));
+				++position;
+			}
+			Assert::AreEqual(firstKeys.size(), brm.Size());
+		}
+
+		TEST_METHOD(BidirectionalRankedMap_CopyConstructorCreatesIndependentMap)
+		{
+			BidirectionalRankedMap<int, std::string> brm
+			{
+				{ 5, "hello" },
+				{ 2, "world" },
+				{ 7, "Guten Tag" }
+			};
+
+			BidirectionalRankedMap<int, std::string> copy(brm);
+			brm.RemoveFirst(2);
+
+			Assert::AreEqual(size_t(3), copy.Size());
+			Assert::IsTrue(copy.AtFirst(2) == "world");
+			Assert::AreEqual(2, copy.SelectFirst(0).first);
+			Assert::AreEqual(size_t(2), copy.RankOfSecond("world"));
+		}
+
+		TEST_METHOD(BidirectionalRankedMap_ChangedKeysAndInsertedNodesHaveCorrectRanks)
+		{
+			BidirectionalRankedMap<int, std::string> brm1
+			{
+				{ 5, "hello" },
+				{ 2, "world" },
+				{ 7, "Guten Tag" }
+			};
+			BidirectionalRankedMap<int, std::string> brm2{ { 8, "Dobar dan" } };
+
+			brm1.ChangeFirst(9, "world");
+			brm2.Insert(brm1.ExtractFirst(5));
+
+			Assert::AreEqual(size_t(1), brm1.RankOfFirst(9));
+			Assert::AreEqual(7, brm1.SelectFirst(0).first);
+			Assert::AreEqual(size_t(0), brm2.RankOfFirst(5));
+			Assert::AreEqual(size_t(1), brm2.RankOfSecond("hello"));
+			Assert::AreEqual(size_t(2), brm2.Size());
+		}
+	};
+}
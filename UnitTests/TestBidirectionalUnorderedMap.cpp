@@ -1,6 +1,12 @@
 #include "stdafx.h"
 #include "CppUnitTest.h"
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <tuple>
 #include <utility>
+#include <vector>
 #include "../BidirectionalMap/BidirectionalMap.h"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
@@ -325,6 +331,56 @@ namespace UnitTests
 			Assert::AreEqual(8, bm2.AtSecond("Dobar dan"));
 		}
 
+		TEST_METHOD(BidirectionalUnorderedMap_CopyConstructorCreatesIndependentMap)
+		{
+			BidirectionalUnorderedMap<int, std::string> bm1
+			{
+				{ 5, "hello" },
+				{ 2, "world" },
+				{ 7, "Guten Tag" }
+			};
+
+			BidirectionalUnorderedMap<int, std::string> bm2(bm1);
+			bm1.RemoveFirst(5);
+			bm1.ChangeSecond(2, "Welt");
+			bm2.Insert(8, "Dobar dan");
+
+			Assert::AreEqual(size_t(2), bm1.Size());
+			Assert::IsFalse(bm1.FirstExists(8));
+			Assert::AreEqual(size_t(4), bm2.Size());
+			Assert::AreEqual(5, bm2.AtSecond("hello"));
+			Assert::AreEqual(std::string("world"), bm2.AtFirst(2));
+			Assert::AreEqual(7, bm2.AtSecond("Guten Tag"));
+			Assert::AreEqual(8, bm2.AtSecond("Dobar dan"));
+			Assert::IsFalse(bm2.SecondExists("Welt"));
+
+			bm2.RemoveSecond("world");
+
+			Assert::IsFalse(bm2.FirstExists(2));
+			Assert::AreEqual(std::string("Welt"), bm1.AtFirst(2));
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_CopyAssignmentCopiesMapData)
+		{
+			BidirectionalUnorderedMap<int, std::string> bm1
+			{
+				{ 5, "hello" },
+				{ 2, "world" }
+			};
+			BidirectionalUnorderedMap<int, std::string> bm2
+			{
+				{ 7, "Guten Tag" }
+			};
+
+			bm2 = bm1;
+
+			Assert::AreEqual(size_t(2), bm2.Size());
+			Assert::IsFalse(bm2.FirstExists(7));
+			Assert::AreEqual(5, bm2.AtSecond("hello"));
+			Assert::AreEqual(2, bm2.AtSecond("world"));
+			Assert::AreEqual(size_t(2), bm1.Size());
+		}
+
 		BidirectionalUnorderedMap<int, std::string> CreateMap()
 		{
 			BidirectionalUnorderedMap<int, std::string> result;
@@ -531,5 +587,530 @@ namespace UnitTests
 			Assert::AreEqual(bm.SecondExists("hello"), bm.Exists("hello"));
 			Assert::AreEqual(bm.FirstExists(5), bm.Exists(5));
 		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_IterationVisitsAllKeyPairs)
+		{
+			BidirectionalUnorderedMap<int, std::string> bm
+			{
+				{ 5, "hello" },
+				{ 2, "world" },
+				{ 7, "Guten Tag" }
+			};
+
+			int sum = 0;
+			size_t count = 0;
+			for (const auto& pair : bm)
+			{
+				Assert::IsTrue(bm.AtFirst(pair.first) == pair.second);
+				sum += pair.first;
+				++count;
+			}
+
+			Assert::AreEqual(size_t(3), count);
+			Assert::AreEqual(14, sum);
+			Assert::AreEqual(size_t(3), size_t(std::distance(bm.cbegin(), bm.cend())));
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_ExtractedKeyPairCanBeInsertedIntoAnotherMap)
+		{
+			BidirectionalUnorderedMap<int, std::string> bm1
+			{
+				{ 5, "hello" },
+				{ 2, "world" },
+				{ 7, "Guten Tag" }
+			};
+			BidirectionalUnorderedMap<int, std::string> bm2{ { 8, "Dobar dan" } };
+
+			auto node1 = bm1.ExtractFirst(5);
+			auto node2 = bm1.ExtractSecond("Guten Tag");
+
+			Assert::AreEqual(size_t(1), bm1.Size());
+			Assert::IsFalse(bm1.FirstExists(5));
+			Assert::IsFalse(bm1.SecondExists("Guten Tag"));
+			Assert::AreEqual(5, node1.First());
+			Assert::IsTrue(node1.Second() == "hello");
+
+			Assert::IsTrue(bm2.Insert(std::move(node1)));
+			Assert::IsTrue(bm2.Insert(std::move(node2)));
+
+			Assert::AreEqual(size_t(3), bm2.Size());
+			Assert::IsTrue(bm2.AtFirst(5) == "hello");
+			Assert::AreEqual(7, bm2.AtSecond("Guten Tag"));
+			bm2.ChangeSecond(5, "Buongiorno");
+			Assert::AreEqual(5, bm2.AtSecond("Buongiorno"));
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_InsertOfNodeWithExistingKeyThrows_invalid_argument_ExceptionAndKeepsKeyPairInNode)
+		{
+			BidirectionalUnorderedMap<int, std::string> bm1{ { 5, "hello" }, { 2, "world" } };
+			BidirectionalUnorderedMap<int, std::string> bm2{ { 5, "Dobar dan" } };
+
+			auto node = bm1.ExtractFirst(5);
+
+			try
+			{
+				bm2.Insert(std::move(node));
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+			Assert::IsFalse(node.Empty());
+			Assert::IsTrue(bm1.Insert(std::move(node)));
+			Assert::IsTrue(bm1.AtFirst(5) == "hello");
+			Assert::IsFalse(bm1.Insert(decltype(node)()));
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_ExtractMethodsThrow_out_of_range_ExceptionForNonExistentKey)
+		{
+			BidirectionalUnorderedMap<int, std::string> bm{ { 5, "hello" } };
+
+			try
+			{
+				bm.ExtractFirst(2);
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+
+			try
+			{
+				bm.ExtractSecond("world");
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_EmplaceMethodConstructsKeyPairInPlace)
+		{
+			BidirectionalUnorderedMap<int, std::string> bm;
+
+			Assert::IsTrue(bm.Emplace(std::piecewise_construct, std::forward_as_tuple(5), std::forward_as_tuple(3, 'a')));
+			Assert::IsTrue(bm.Emplace(std::piecewise_construct, std::forward_as_tuple(2), std::forward_as_tuple("world")));
+
+			Assert::AreEqual(size_t(2), bm.Size());
+			Assert::IsTrue(bm.AtFirst(5) == "aaa");
+			Assert::AreEqual(2, bm.AtSecond("world"));
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_EmplaceMethodReturnsFalseForExistingKeyPairAndThrows_invalid_argument_ExceptionIfOneOfKeysExists)
+		{
+			BidirectionalUnorderedMap<int, std::string> bm{ { 5, "hello" } };
+
+			Assert::IsFalse(bm.Emplace(std::piecewise_construct, std::forward_as_tuple(5), std::forward_as_tuple("hello")));
+
+			try
+			{
+				bm.Emplace(std::piecewise_construct, std::forward_as_tuple(5), std::forward_as_tuple("world"));
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+
+			try
+			{
+				bm.Emplace(std::piecewise_construct, std::forward_as_tuple(2), std::forward_as_tuple("hello"));
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+			Assert::AreEqual(size_t(1), bm.Size());
+			Assert::IsFalse(bm.FirstExists(2));
+			Assert::IsFalse(bm.SecondExists("world"));
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_InsertOrAssignMethodOverwritesConflictingKeyPairsAndReportsEvictedOnes)
+		{
+			BidirectionalUnorderedMap<int, std::string> bm{ { 1, "one" }, { 2, "two" }, { 3, "three" } };
+
+			auto result = bm.InsertOrAssign(4, "four");
+			Assert::IsTrue(result.changed);
+			Assert::IsFalse(result.evictedByFirst.has_value());
+			Assert::IsFalse(result.evictedBySecond.has_value());
+
+			result = bm.InsertOrAssign(1, "one");
+			Assert::IsFalse(result.changed);
+
+			result = bm.InsertOrAssign(1, "uno");
+			Assert::IsTrue(result.changed);
+			Assert::IsTrue(*result.evictedByFirst == std::make_pair(1, std::string("one")));
+			Assert::IsFalse(result.evictedBySecond.has_value());
+			Assert::IsTrue(bm.AtFirst(1) == "uno");
+			Assert::IsFalse(bm.SecondExists("one"));
+
+			result = bm.InsertOrAssign(5, "two");
+			Assert::IsTrue(result.changed);
+			Assert::IsFalse(result.evictedByFirst.has_value());
+			Assert::IsTrue(*result.evictedBySecond == std::make_pair(2, std::string("two")));
+			Assert::AreEqual(5, bm.AtSecond("two"));
+			Assert::IsFalse(bm.FirstExists(2));
+
+			result = bm.InsertOrAssign(3, "four");
+			Assert::IsTrue(result.changed);
+			Assert::IsTrue(*result.evictedByFirst == std::make_pair(3, std::string("three")));
+			Assert::IsTrue(*result.evictedBySecond == std::make_pair(4, std::string("four")));
+			Assert::AreEqual(size_t(3), bm.Size());
+			Assert::AreEqual(3, bm.AtSecond("four"));
+			Assert::IsTrue(bm.AtFirst(3) == "four");
+			Assert::IsFalse(bm.FirstExists(4));
+			Assert::IsFalse(bm.SecondExists("three"));
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_InsertOrAssignMethodKeepsOrRejectsConflictingKeyPairsAccordingToPolicy)
+		{
+			BidirectionalUnorderedMap<int, std::string> bm{ { 1, "one" }, { 2, "two" } };
+
+			auto result = bm.InsertOrAssign(1, "two", ConflictPolicy::KeepExisting);
+			Assert::IsFalse(result.changed);
+			result = bm.InsertOrAssign(3, "three", ConflictPolicy::KeepExisting);
+			Assert::IsTrue(result.changed);
+
+			try
+			{
+				bm.InsertOrAssign(1, "uno", ConflictPolicy::Fail);
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+			try
+			{
+				bm.InsertOrAssign(4, "two", ConflictPolicy::Fail);
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+			Assert::IsFalse(bm.InsertOrAssign(2, "two", ConflictPolicy::Fail).changed);
+
+			Assert::AreEqual(size_t(3), bm.Size());
+			Assert::IsTrue(bm.AtFirst(1) == "one");
+			Assert::IsTrue(bm.AtFirst(2) == "two");
+			Assert::IsTrue(bm.AtFirst(3) == "three");
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_RemapMethodsReplaceAllKeysOfOneSide)
+		{
+			BidirectionalUnorderedMap<int, std::string> bm{ { 1, "one" }, { 2, "two" }, { 3, "three" } };
+
+			// keys are exchanged, which would not be possible with ChangeFirst
+			bm.RemapFirst([](int first) { return first == 3 ? 3 : 3 - first; });
+			Assert::AreEqual(size_t(3), bm.Size());
+			Assert::IsTrue(bm.AtFirst(1) == "two");
+			Assert::IsTrue(bm.AtFirst(2) == "one");
+			Assert::IsTrue(bm.AtFirst(3) == "three");
+			Assert::AreEqual(2, bm.AtSecond("one"));
+
+			bm.RemapSecond([](const std::string& second) { return second + "!"; });
+			Assert::IsTrue(bm.AtFirst(1) == "two!");
+			Assert::AreEqual(3, bm.AtSecond("three!"));
+			Assert::IsFalse(bm.SecondExists("three"));
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_RemapMethodsThrow_invalid_argument_ExceptionAndKeepMapIfNewKeysAreNotUnique)
+		{
+			BidirectionalUnorderedMap<int, std::string> bm{ { 1, "one" }, { 2, "two" }, { 3, "three" } };
+
+			try
+			{
+				bm.RemapFirst([](int first) { return first % 2; });
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+			try
+			{
+				bm.RemapSecond([](const std::string& second) { return second.substr(0, 1); });
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+
+			Assert::AreEqual(size_t(3), bm.Size());
+			Assert::IsTrue(bm.AtFirst(1) == "one");
+			Assert::IsTrue(bm.AtFirst(2) == "two");
+			Assert::IsTrue(bm.AtFirst(3) == "three");
+			Assert::AreEqual(2, bm.AtSecond("two"));
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_EraseIfMethodRemovesKeyPairsMatchingPredicate)
+		{
+			BidirectionalUnorderedMap<int, std::string> bm;
+			for (int i = 0; i < 100; ++i)
+				bm.Insert(i, std::to_string(i));
+
+			size_t count = bm.EraseIf([](const std::pair<int, std::string>& keyPair) { return keyPair.first % 3 == 0; });
+
+			Assert::AreEqual(size_t(34), count);
+			Assert::AreEqual(size_t(66), bm.Size());
+			for (int i = 0; i < 100; ++i)
+			{
+				Assert::AreEqual(i % 3 != 0, bm.FirstExists(i));
+				Assert::AreEqual(i % 3 != 0, bm.SecondExists(std::to_string(i)));
+			}
+			Assert::AreEqual(size_t(0), bm.EraseIf([](const std::pair<int, std::string>&) { return false; }));
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_RemoveRangeMethodsRemoveExistingKeysAndSkipOthers)
+		{
+			BidirectionalUnorderedMap<int, std::string> bm{ { 1, "one" }, { 2, "two" }, { 3, "three" }, { 4, "four" } };
+
+			Assert::AreEqual(size_t(2), bm.RemoveFirstRange(std::vector<int>{ 1, 5, 3 }));
+			Assert::AreEqual(size_t(1), bm.RemoveSecondRange(std::vector<std::string>{ "one", "four" }));
+
+			Assert::AreEqual(size_t(1), bm.Size());
+			Assert::IsTrue(bm.AtFirst(2) == "two");
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_InsertRangeMethodInsertsNothingAndReportsConflictsIfPolicyIsFail)
+		{
+			BidirectionalUnorderedMap<int, std::string> bm{ { 1, "one" }, { 2, "two" } };
+			std::vector<std::pair<int, std::string>> keyPairs{ { 3, "three" }, { 1, "one" }, { 4, "two" }, { 5, "five" }, { 5, "cinque" }, { 3, "three" } };
+
+			auto result = bm.InsertRange(keyPairs.cbegin(), keyPairs.cend());
+
+			Assert::AreEqual(size_t(0), result.inserted);
+			Assert::AreEqual(size_t(2), result.duplicates);
+			Assert::AreEqual(size_t(2), result.conflicts.size());
+			Assert::AreEqual(size_t(2), result.conflicts[0]);
+			Assert::AreEqual(size_t(4), result.conflicts[1]);
+			Assert::AreEqual(size_t(2), bm.Size());
+			Assert::IsFalse(bm.FirstExists(3));
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_InsertRangeMethodSkipsConflictsIfPolicyIsKeepExisting)
+		{
+			BidirectionalUnorderedMap<int, std::string> bm{ { 1, "one" }, { 2, "two" } };
+			std::vector<std::pair<int, std::string>> keyPairs{ { 3, "three" }, { 1, "one" }, { 4, "two" }, { 5, "five" }, { 5, "cinque" } };
+
+			auto result = bm.InsertRange(keyPairs.cbegin(), keyPairs.cend(), ConflictPolicy::KeepExisting);
+
+			Assert::AreEqual(size_t(2), result.inserted);
+			Assert::AreEqual(size_t(1), result.duplicates);
+			Assert::AreEqual(size_t(2), result.conflicts.size());
+			Assert::AreEqual(size_t(4), bm.Size());
+			Assert::IsTrue(bm.AtFirst(3) == "three");
+			Assert::IsTrue(bm.AtFirst(5) == "five");
+			Assert::AreEqual(2, bm.AtSecond("two"));
+			Assert::IsFalse(bm.FirstExists(4));
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_InsertRangeMethodAssignsKeyPairsInOrderIfPolicyIsOverwrite)
+		{
+			BidirectionalUnorderedMap<int, std::string> bm{ { 1, "one" }, { 2, "two" } };
+			std::vector<std::pair<int, std::string>> keyPairs{ { 3, "three" }, { 1, "one" }, { 4, "two" }, { 5, "five" }, { 5, "cinque" } };
+
+			auto result = bm.InsertRange(keyPairs.cbegin(), keyPairs.cend(), ConflictPolicy::Overwrite);
+
+			Assert::AreEqual(size_t(4), result.inserted);
+			Assert::AreEqual(size_t(1), result.duplicates);
+			Assert::AreEqual(size_t(2), result.conflicts.size());
+			Assert::AreEqual(size_t(4), bm.Size());
+			Assert::AreEqual(4, bm.AtSecond("two"));
+			Assert::IsTrue(bm.AtFirst(5) == "cinque");
+			Assert::IsFalse(bm.FirstExists(2));
+			Assert::IsFalse(bm.SecondExists("five"));
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_DroppedSecondIndexIsBuiltOnFirstSecondKeyLookup)
+		{
+			BidirectionalUnorderedMap<int, std::string> bm;
+			bm.DropSecondIndex();
+			for (int i = 0; i < 100; ++i)
+				bm.Insert(i, std::to_string(i));
+			bm.RemoveFirst(7);
+
+			Assert::IsTrue(bm.AtFirst(5) == "5");
+			Assert::IsFalse(bm.Insert(5, "5"));
+			Assert::IsFalse(bm.HasSecondIndex());
+			Assert::AreEqual(42, bm.AtSecond("42"));
+			Assert::IsTrue(bm.HasSecondIndex());
+			bm.ChangeFirst(1000, "8");
+			Assert::AreEqual(1000, bm.AtSecond("8"));
+			Assert::IsFalse(bm.SecondExists("7"));
+			Assert::AreEqual(size_t(99), bm.Size());
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_SecondIndexIsMaintainedAfterItHasBeenBuilt)
+		{
+			BidirectionalUnorderedMap<int, std::string> bm{ { 1, "one" }, { 2, "two" } };
+			bm.DropSecondIndex();
+			bm.Insert(3, "three");
+			Assert::IsTrue(bm.SecondExists("three"));
+			bm.Insert(4, "four");
+			bm.RemoveFirst(1);
+
+			Assert::AreEqual(4, bm.AtSecond("four"));
+			Assert::IsFalse(bm.SecondExists("one"));
+			try
+			{
+				bm.Insert(5, "two");
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_BuildSecondIndexThrows_invalid_argument_ExceptionIfSecondKeysAreNotUnique)
+		{
+			BidirectionalUnorderedMap<int, std::string> bm;
+			bm.DropSecondIndex();
+			bm.Insert(1, "one");
+			bm.Insert(2, "two");
+			bm.Insert(3, "one");
+
+			try
+			{
+				bm.AtSecond("two");
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+			Assert::IsFalse(bm.HasSecondIndex());
+			Assert::IsTrue(bm.AtFirst(3) == "one");
+			try
+			{
+				bm.SecondExists("four");
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+			Assert::IsFalse(bm.HasSecondIndex());
+
+			bm.RemoveFirst(3);
+			bm.BuildSecondIndex();
+			Assert::IsTrue(bm.HasSecondIndex());
+			Assert::AreEqual(1, bm.AtSecond("one"));
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_CopyAndNodeInsertionRespectDroppedSecondIndex)
+		{
+			BidirectionalUnorderedMap<int, std::string> lazy{ { 1, "one" }, { 2, "two" } };
+			lazy.DropSecondIndex();
+			lazy.Insert(3, "three");
+			BidirectionalUnorderedMap<int, std::string> copy(lazy);
+			BidirectionalUnorderedMap<int, std::string> indexed;
+
+			Assert::IsFalse(copy.HasSecondIndex());
+			indexed.Insert(lazy.ExtractFirst(3));
+			lazy.Insert(indexed.ExtractFirst(3));
+			indexed.Insert(lazy.ExtractFirst(2));
+
+			Assert::AreEqual(3, copy.AtSecond("three"));
+			Assert::AreEqual(2, indexed.AtSecond("two"));
+			Assert::AreEqual(size_t(1), indexed.Size());
+			Assert::AreEqual(size_t(2), lazy.Size());
+			Assert::AreEqual(3, lazy.AtSecond("three"));
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_PrehashedKeyIsFoundInSeveralMaps)
+		{
+			BidirectionalUnorderedMap<std::string, int> bum1{ { "hello", 5 }, { "world", 2 } };
+			BidirectionalUnorderedMap<int, std::string> bum2{ { 7, "hello" }, { 8, "Guten Tag" } };
+			BidirectionalMap<std::string, int> bm{ { "hello", 1 } };
+			PrehashedKey<std::string> hello("hello");
+			PrehashedKey<std::string> missing("Dobar dan");
+
+			Assert::IsTrue(bum1.FirstExists(hello));
+			Assert::IsTrue(bum2.SecondExists(hello));
+			Assert::IsTrue(bm.FirstExists(hello));
+			Assert::AreEqual(5, bum1.AtFirst(hello));
+			Assert::AreEqual(7, bum2.AtSecond(hello));
+			Assert::AreEqual(1, bm.AtFirst(hello));
+			Assert::IsFalse(bum1.FirstExists(missing));
+			Assert::IsFalse(bum2.SecondExists(missing));
+			try
+			{
+				bum1.AtFirst(missing);
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+
+			bum1.RemoveFirst(hello);
+			bum2.RemoveSecond(hello);
+			Assert::IsFalse(bum1.FirstExists("hello"));
+			Assert::IsFalse(bum2.SecondExists("hello"));
+			Assert::AreEqual(size_t(1), bum1.Size());
+			Assert::AreEqual(size_t(1), bum2.Size());
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_ChangedKeysAreFoundByNewKeyOnly)
+		{
+			BidirectionalUnorderedMap<std::string, std::string> bum;
+			for (int i = 0; i < 1000; ++i)
+				bum.Insert("first" + std::to_string(i), "second" + std::to_string(i));
+			for (int i = 0; i < 1000; i += 2)
+			{
+				bum.ChangeFirst("changed" + std::to_string(i), "second" + std::to_string(i));
+				bum.ChangeSecond("first" + std::to_string(i + 1), "changed" + std::to_string(i + 1));
+			}
+
+			for (int i = 0; i < 1000; i += 2)
+			{
+				Assert::IsTrue(bum.AtSecond("second" + std::to_string(i)) == "changed" + std::to_string(i));
+				Assert::IsTrue(bum.AtFirst(PrehashedKey<std::string>("changed" + std::to_string(i))) == "second" + std::to_string(i));
+				Assert::IsFalse(bum.FirstExists("first" + std::to_string(i)));
+				Assert::IsTrue(bum.AtSecond(PrehashedKey<std::string>("changed" + std::to_string(i + 1))) == "first" + std::to_string(i + 1));
+				Assert::IsFalse(bum.SecondExists("second" + std::to_string(i + 1)));
+			}
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_BundledHashersCanBeUsedForEachSide)
+		{
+			BidirectionalUnorderedMap<std::string, unsigned long long, StringHash, IntegerHash> bum;
+			for (unsigned long long i = 0; i < 10000; ++i)
+				bum.Insert("id" + std::to_string(i), i * 4096);
+
+			for (unsigned long long i = 0; i < 10000; ++i)
+			{
+				Assert::AreEqual(i * 4096, bum.AtFirst("id" + std::to_string(i)));
+				Assert::IsTrue(bum.AtSecond(i * 4096) == "id" + std::to_string(i));
+			}
+			Assert::AreEqual(8192ull, bum.AtFirst(PrehashedKey<std::string, StringHash>("id2")));
+			Assert::IsFalse(bum.SecondExists(4095));
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_StringHashDependsOnEveryByteAndLength)
+		{
+			StringHash hash;
+			std::string text(300, 'a');
+			std::vector<std::size_t> hashes;
+			for (size_t length = 0; length <= text.size(); ++length)
+			{
+				hashes.push_back(hash(std::string_view(text.data(), length)));
+				if (length > 0)
+				{
+					std::string changed(text, 0, length);
+					changed[length / 2] = 'b';
+					Assert::AreNotEqual(hashes.back(), hash(changed));
+				}
+			}
+			std::sort(hashes.begin(), hashes.end());
+			Assert::IsTrue(std::adjacent_find(hashes.cbegin(), hashes.cend()) == hashes.cend());
+			Assert::AreEqual(hash(std::string("hello")), hash(std::string_view("hello")));
+		}
+
+		TEST_METHOD(BidirectionalUnorderedMap_IntegerHashSpreadsStridedValuesOverLowBits)
+		{
+			IntegerHash hash;
+			std::vector<bool> used(256);
+			for (unsigned long long i = 0; i < 256; ++i)
+				used[hash(i * 4096) & 255] = true;
+
+			Assert::IsTrue(std::count(used.cbegin(), used.cend(), true) > 128);
+			Assert::AreEqual(hash(42), hash(42ull));
+		}
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,154 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <string>
+#include <tuple>
+#include <vector>
+#include "../BidirectionalMap/IndexedTuple.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace MapSpecial;
+
+namespace UnitTests
+{
+	TEST_CLASS(IndexedTupleTest)
+	{
+	public:
+
+		using Users = IndexedTuple<int, OrderedIndex<std::string>, std::string>;
+
+		TEST_METHOD(IndexedTuple_AtMethodFindsRecordByAnyColumn)
+		{
+			Users users
+			{
+				{ 1, "alice", "alice@example.com" },
+				{ 2, "bob", "bob@example.com" }
+			};
+			users.Insert(3, "carol", "carol@example.com");
+
+			Assert::AreEqual(size_t(3), users.Size());
+			Assert::IsTrue(std::get<1>(users.At<0>(2)) == "bob");
+			Assert::AreEqual(3, std::get<0>(users.At<1>("carol")));
+			Assert::IsTrue(std::get<1>(users.At<2>("alice@example.com")) == "alice");
+			Assert::IsTrue(users.Exists<2>("bob@example.com"));
+			Assert::IsFalse(users.Exists<1>("dave"));
+
+			try
+			{
+				users.At<0>(4);
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+		}
+
+		TEST_METHOD(IndexedTuple_InsertReturnsFalseForExistingRecordAndThrows_invalid_argument_ExceptionIfAnyKeyExists)
+		{
+			Users users{ { 1, "alice", "alice@example.com" } };
+
+			Assert::IsFalse(users.Insert(1, "alice", "alice@example.com"));
+			try
+			{
+				users.Insert(2, "bob", "alice@example.com");
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+			try
+			{
+				users.Insert(1, "bob", "bob@example.com");
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+
+			Assert::AreEqual(size_t(1), users.Size());
+			Assert::IsFalse(users.Exists<1>("bob"));
+		}
+
+		TEST_METHOD(IndexedTuple_ChangeMethodReplacesKeyOfOneColumn)
+		{
+			Users users
+			{
+				{ 1, "alice", "alice@example.com" },
+				{ 2, "bob", "bob@example.com" }
+			};
+
+			Assert::IsTrue(users.Change<2>("alice@example.com", "alice@example.org"));
+			Assert::IsTrue(users.Change<1, 0>(2, "robert"));
+			Assert::IsFalse(users.Change<1, 0>(2, "robert"));
+
+			Assert::IsFalse(users.Exists<2>("alice@example.com"));
+			Assert::AreEqual(1, std::get<0>(users.At<2>("alice@example.org")));
+			Assert::IsTrue(std::get<2>(users.At<1>("robert")) == "bob@example.com");
+			Assert::IsFalse(users.Exists<1>("bob"));
+
+			try
+			{
+				users.Change<1, 0>(1, "robert");
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+			try
+			{
+				users.Change<1, 0>(3, "carol");
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+		}
+
+		TEST_METHOD(IndexedTuple_RemoveMethodRemovesRecordFromAllColumns)
+		{
+			Users users
+			{
+				{ 1, "alice", "alice@example.com" },
+				{ 2, "bob", "bob@example.com" }
+			};
+
+			users.Remove<1>("alice");
+
+			Assert::AreEqual(size_t(1), users.Size());
+			Assert::IsFalse(users.Exists<0>(1));
+			Assert::IsFalse(users.Exists<2>("alice@example.com"));
+			Assert::IsTrue(users.Insert(1, "alice", "alice@example.com"));
+		}
+
+		TEST_METHOD(IndexedTuple_CopyIsIndependentOfOriginal)
+		{
+			Users users{ { 1, "alice", "alice@example.com" } };
+			Users copy(users);
+
+			users.Remove<0>(1);
+			copy.Insert(2, "bob", "bob@example.com");
+
+			Assert::AreEqual(size_t(0), users.Size());
+			Assert::AreEqual(size_t(2), copy.Size());
+			Assert::IsTrue(std::get<1>(copy.At<2>("alice@example.com")) == "alice");
+		}
+
+		TEST_METHOD(IndexedTuple_ColumnsCanUseFilteredAndRankedIndices)
+		{
+			IndexedTuple<FilteredIndex<int>, RankedIndex<std::string>, std::string> users
+			{
+				{ 1, "alice", "alice@example.com" },
+				{ 2, "bob", "bob@example.com" }
+			};
+
+			Assert::IsTrue(users.Change<1, 0>(2, "robert"));
+			users.Remove<0>(1);
+			Assert::IsTrue(users.Insert(3, "carol", "carol@example.com"));
+
+			Assert::AreEqual(size_t(2), users.Size());
+			Assert::IsFalse(users.Exists<0>(1));
+			Assert::IsFalse(users.Exists<1>("bob"));
+			Assert::AreEqual(2, std::get<0>(users.At<1>("robert")));
+			Assert::IsTrue(std::get<1>(users.At<0>(3)) == "carol");
+		}
+	};
+}
@@ -0,0 +1,149 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "../BidirectionalMap/BidirectionalMapDelimited.h"
+#include "../BidirectionalMap/BidirectionalMapJournal.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace MapSpecial;
+
+namespace UnitTests
+{
+	TEST_CLASS(LoadDelimitedTest)
+	{
+	public:
+
+		const std::string filePath = "LoadDelimitedTest.tsv";
+
+		const std::string journalPath = "LoadDelimitedTest.journal";
+
+		TEST_METHOD_CLEANUP(RemoveFile)
+		{
+			std::remove(filePath.c_str());
+			std::remove(journalPath.c_str());
+		}
+
+		void WriteFile(const std::string& content)
+		{
+			std::ofstream stream(filePath, std::ios::binary | std::ios::trunc);
+			stream << content;
+		}
+
+		TEST_METHOD(LoadDelimited_LoadsAllKeyPairsFromFile)
+		{
+			WriteFile("hello\t5\nworld\t2\r\n\nGuten Tag\t7");
+
+			BidirectionalUnorderedMap<std::string, int> bum;
+			auto report = LoadDelimited(bum, filePath);
+
+			Assert::AreEqual(size_t(4), report.lines);
+			Assert::AreEqual(size_t(3), report.loaded);
+			Assert::AreEqual(size_t(0), report.issues.size());
+			Assert::AreEqual(size_t(3), bum.Size());
+			Assert::AreEqual(5, bum.AtFirst("hello"));
+			Assert::AreEqual(2, bum.AtFirst("world"));
+			Assert::IsTrue(bum.AtSecond(7) == "Guten Tag");
+		}
+
+		TEST_METHOD(LoadDelimited_LoadedKeyPairsAreRecordedInAttachedJournal)
+		{
+			WriteFile("hello\t5\nworld\t2\nhello\t5\nagain\t2\nGuten Tag\t7\n");
+
+			BidirectionalUnorderedMap<std::string, int> bum;
+			{
+				BidirectionalMapJournal<std::string, int> journal(journalPath);
+				bum.AttachJournal(&journal);
+				LoadDelimited(bum, filePath);
+				journal.Commit();
+				bum.AttachJournal(nullptr);
+			}
+
+			BidirectionalUnorderedMap<std::string, int> recovered;
+			Assert::AreEqual(size_t(3), BidirectionalMapJournal<std::string, int>::Replay(journalPath, recovered));
+			Assert::AreEqual(size_t(3), recovered.Size());
+			Assert::AreEqual(2, recovered.AtFirst("world"));
+			Assert::IsFalse(recovered.FirstExists("again"));
+		}
+
+		TEST_METHOD(LoadDelimited_SkipsHeaderAndUsesGivenDelimiter)
+		{
+			WriteFile("id,name\n5,hello\n2,world\n");
+
+			BidirectionalMap<int, std::string> bm;
+			DelimitedLoadOptions options;
+			options.delimiter = ',';
+			options.skipHeader = true;
+			auto report = LoadDelimited(bm, filePath, options);
+
+			Assert::AreEqual(size_t(3), report.lines);
+			Assert::AreEqual(size_t(2), report.loaded);
+			Assert::IsTrue(bm.AtFirst(5) == "hello");
+			Assert::AreEqual(2, bm.AtSecond("world"));
+		}
+
+		TEST_METHOD(LoadDelimited_ReportsMalformedLinesAndConflictingKeysWithoutThrowing)
+		{
+			WriteFile("hello\t5\nworld\nGuten Tag\tseven\nhello\t5\nhello\t6\nDobar dan\t5\nBuongiorno\t7\n");
+
+			BidirectionalMap<std::string, int> bm{ { "Bonjour", 7 } };
+			auto report = LoadDelimited(bm, filePath);
+
+			Assert::AreEqual(size_t(1), report.loaded);
+			Assert::AreEqual(size_t(1), report.duplicates);
+			Assert::AreEqual(size_t(2), report.malformed);
+			Assert::AreEqual(size_t(3), report.conflicts);
+			Assert::AreEqual(size_t(5), report.issues.size());
+			Assert::AreEqual(size_t(2), report.issues[0].line);
+			Assert::IsTrue(report.issues[0].kind == DelimitedIssueKind::MalformedLine);
+			Assert::AreEqual(size_t(3), report.issues[1].line);
+			Assert::IsTrue(report.issues[1].kind == DelimitedIssueKind::MalformedLine);
+			Assert::AreEqual(size_t(5), report.issues[2].line);
+			Assert::IsTrue(report.issues[2].kind == DelimitedIssueKind::FirstKeyConflict);
+			Assert::AreEqual(size_t(6), report.issues[3].line);
+			Assert::IsTrue(report.issues[3].kind == DelimitedIssueKind::SecondKeyConflict);
+			Assert::AreEqual(size_t(7), report.issues[4].line);
+			Assert::IsTrue(report.issues[4].kind == DelimitedIssueKind::SecondKeyConflict);
+			Assert::AreEqual(size_t(2), bm.Size());
+			Assert::AreEqual(5, bm.AtFirst("hello"));
+			Assert::IsTrue(bm.AtSecond(7) == "Bonjour");
+		}
+
+		TEST_METHOD(LoadDelimited_LoadsLargeFileInParallelAndReportsLineNumbersAcrossChunks)
+		{
+			std::string content;
+			for (int i = 0; i < 100000; ++i)
+				content += "key" + std::to_string(i) + "\t" + std::to_string(i % 99999) + "\n";
+			WriteFile(content);
+
+			BidirectionalUnorderedMap<std::string, long long> bum;
+			DelimitedLoadOptions options;
+			options.threads = 4;
+			options.minChunkSize = 4096;
+			auto report = LoadDelimited(bum, filePath, options);
+
+			Assert::AreEqual(size_t(100000), report.lines);
+			Assert::AreEqual(size_t(99999), report.loaded);
+			Assert::AreEqual(size_t(1), report.issues.size());
+			Assert::AreEqual(size_t(100000), report.issues[0].line);
+			Assert::IsTrue(report.issues[0].kind == DelimitedIssueKind::SecondKeyConflict);
+			for (int i = 0; i < 99999; ++i)
+				Assert::AreEqual(static_cast<long long>(i), bum.AtFirst("key" + std::to_string(i)));
+		}
+
+		TEST_METHOD(LoadDelimited_Throws_runtime_error_ExceptionIfFileDoesNotExist)
+		{
+			BidirectionalMap<std::string, int> bm;
+
+			try
+			{
+				LoadDelimited(bm, "NonExistent.tsv");
+				Assert::Fail();
+			}
+			catch (const std::runtime_error&)
+			{
+			}
+		}
+	};
+}
@@ -0,0 +1,219 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <string>
+#include <utility>
+#include <vector>
+#include "../BidirectionalMap/PersistentBidirectionalMap.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace MapSpecial;
+
+namespace UnitTests
+{
+	TEST_CLASS(PersistentBidirectionalMapTest)
+	{
+	public:
+
+		TEST_METHOD(PersistentBidirectionalMap_InsertMethodReturnsNewVersionWithKeyPairAndLeavesOriginalUnchanged)
+		{
+			PersistentBidirectionalMap<int, std::string> pbm1;
+
+			auto pbm2 = pbm1.Insert(1, "hello");
+
+			Assert::AreEqual(size_t(0), pbm1.Size());
+			Assert::IsFalse(pbm1.FirstExists(1));
+			Assert::AreEqual(size_t(1), pbm2.Size());
+			Assert::AreEqual(std::string("hello"), pbm2.AtFirst(1));
+			Assert::AreEqual(1, pbm2.AtSecond("hello"));
+		}
+
+		TEST_METHOD(PersistentBidirectionalMap_InsertMethodReturnsSameVersionIfIdenticalKeyPairAlreadyExists)
+		{
+			PersistentBidirectionalMap<int, std::string> pbm1{ { 1, "hello" } };
+
+			auto pbm2 = pbm1.Insert(1, "hello");
+
+			Assert::IsTrue(pbm1.IsSameVersion(pbm2));
+			Assert::AreEqual(size_t(1), pbm2.Size());
+		}
+
+		TEST_METHOD(PersistentBidirectionalMap_InsertMethodThrows_invalid_argument_ExceptionIfOneOfKeysAlreadyExists)
+		{
+			PersistentBidirectionalMap<int, std::string> pbm{ { 1, "hello" } };
+
+			try
+			{
+				pbm.Insert(2, "hello");
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+
+			try
+			{
+				pbm.Insert(1, "world");
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+			Assert::AreEqual(size_t(1), pbm.Size());
+			Assert::AreEqual(1, pbm.AtSecond("hello"));
+		}
+
+		TEST_METHOD(PersistentBidirectionalMap_ChangeFirstMethodReturnsVersionWithChangedFirstKey)
+		{
+			PersistentBidirectionalMap<int, std::string> pbm1{ { 1, "hello" }, { 2, "world" } };
+
+			auto pbm2 = pbm1.ChangeFirst(5, "hello");
+
+			Assert::AreEqual(size_t(2), pbm2.Size());
+			Assert::AreEqual(5, pbm2.AtSecond("hello"));
+			Assert::AreEqual(std::string("hello"), pbm2.AtFirst(5));
+			Assert::IsFalse(pbm2.FirstExists(1));
+			Assert::AreEqual(1, pbm1.AtSecond("hello"));
+			Assert::IsFalse(pbm1.FirstExists(5));
+		}
+
+		TEST_METHOD(PersistentBidirectionalMap_ChangeFirstMethodThrowsExceptionsForInvalidKeys)
+		{
+			PersistentBidirectionalMap<int, std::string> pbm{ { 1, "hello" }, { 2, "world" } };
+
+			try
+			{
+				pbm.ChangeFirst(5, "Guten Tag");
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+
+			try
+			{
+				pbm.ChangeFirst(1, "world");
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+			Assert::IsTrue(pbm.IsSameVersion(pbm.ChangeFirst(1, "hello")));
+		}
+
+		TEST_METHOD(PersistentBidirectionalMap_ChangeSecondMethodReturnsVersionWithChangedSecondKey)
+		{
+			PersistentBidirectionalMap<int, std::string> pbm1{ { 1, "hello" }, { 2, "world" } };
+
+			auto pbm2 = pbm1.ChangeSecond(1, "Guten Tag");
+
+			Assert::AreEqual(size_t(2), pbm2.Size());
+			Assert::AreEqual(1, pbm2.AtSecond("Guten Tag"));
+			Assert::AreEqual(std::string("Guten Tag"), pbm2.AtFirst(1));
+			Assert::IsFalse(pbm2.SecondExists("hello"));
+			Assert::AreEqual(std::string("hello"), pbm1.AtFirst(1));
+			Assert::IsFalse(pbm1.SecondExists("Guten Tag"));
+		}
+
+		TEST_METHOD(PersistentBidirectionalMap_ChangeSecondMethodThrowsExceptionsForInvalidKeys)
+		{
+			PersistentBidirectionalMap<int, std::string> pbm{ { 1, "hello" }, { 2, "world" } };
+
+			try
+			{
+				pbm.ChangeSecond(5, "Guten Tag");
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+
+			try
+			{
+				pbm.ChangeSecond(1, "world");
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+			Assert::IsTrue(pbm.IsSameVersion(pbm.ChangeSecond(1, "hello")));
+		}
+
+		TEST_METHOD(PersistentBidirectionalMap_RemoveMethodsReturnVersionWithoutKeyPair)
+		{
+			PersistentBidirectionalMap<int, std::string> pbm1{ { 5, "hello" }, { 2, "world" }, { 7, "Guten Tag" } };
+
+			auto pbm2 = pbm1.RemoveFirst(5);
+			auto pbm3 = pbm2.RemoveSecond("Guten Tag");
+
+			Assert::AreEqual(size_t(3), pbm1.Size());
+			Assert::AreEqual(size_t(2), pbm2.Size());
+			Assert::IsFalse(pbm2.FirstExists(5));
+			Assert::IsFalse(pbm2.SecondExists("hello"));
+			Assert::AreEqual(size_t(1), pbm3.Size());
+			Assert::IsFalse(pbm3.FirstExists(7));
+			Assert::AreEqual(2, pbm3.AtSecond("world"));
+			Assert::AreEqual(7, pbm2.AtSecond("Guten Tag"));
+		}
+
+		TEST_METHOD(PersistentBidirectionalMap_RemoveMethodsThrow_out_of_range_ExceptionForNonExistentKey)
+		{
+			PersistentBidirectionalMap<int, std::string> pbm{ { 5, "hello" } };
+
+			try
+			{
+				pbm.RemoveFirst(6);
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+
+			try
+			{
+				pbm.RemoveSecond("world");
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+
+			try
+			{
+				pbm.AtFirst(6);
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+
+			try
+			{
+				pbm.AtSecond("world");
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+		}
+
+		TEST_METHOD(PersistentBidirectionalMap_AllVersionsRemainValidAfterManyModifications)
+		{
+			std::vector<PersistentBidirectionalMap<int, int>> versions(1);
+			for (int i = 0; i < 200; ++i)
+				versions.push_back(versions.back().Insert(i, 1000 + i));
+			for (int i = 0; i < 200; i += 2)
+				versions.push_back(versions.back().RemoveFirst(i));
+
+			for (size_t v = 0; v <= 200; ++v)
+			{
+				Assert::AreEqual(v, versions[v].Size());
+				for (int i = 0; i < 200; ++i)
+					Assert::AreEqual(i < int(v), versions[v].SecondExists(1000 + i));
+			}
+			const auto& last = versions.back();
+			Assert::AreEqual(size_t(100), last.Size());
+			for (int i = 0; i < 200; ++i)
+				Assert::AreEqual(i % 2 == 1, last.FirstExists(i));
+		}
+	};
+}
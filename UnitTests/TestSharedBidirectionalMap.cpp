@@ -0,0 +1,217 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include "../BidirectionalMap/SharedBidirectionalMap.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace MapSpecial;
+
+namespace UnitTests
+{
+	TEST_CLASS(SharedBidirectionalMapTest)
+	{
+	public:
+
+		const std::string segmentName = "SharedBidirectionalMapTest";
+
+		TEST_METHOD_INITIALIZE(RemoveSegmentBeforeTest)
+		{
+			SharedBidirectionalMap<std::string, std::uint64_t>::RemoveSegment(segmentName);
+		}
+
+		TEST_METHOD_CLEANUP(RemoveSegmentAfterTest)
+		{
+			SharedBidirectionalMap<std::string, std::uint64_t>::RemoveSegment(segmentName);
+		}
+
+		TEST_METHOD(SharedBidirectionalMap_KeyPairsInsertedByOneInstanceAreAccessibleByAnotherInstance)
+		{
+			SharedBidirectionalMap<std::string, std::uint64_t> sbm1(segmentName, 100, 4096);
+			SharedBidirectionalMap<std::string, std::uint64_t> sbm2(segmentName, 100, 4096);
+
+			sbm1.Insert("hello", 5);
+			sbm1.Insert("world", 2);
+
+			Assert::AreEqual(size_t(2), sbm2.Size());
+			Assert::AreEqual(std::uint64_t(5), sbm2.AtFirst("hello"));
+			Assert::AreEqual(std::string("world"), sbm2.AtSecond(2));
+			Assert::IsTrue(sbm2.FirstExists("hello"));
+			Assert::IsFalse(sbm2.FirstExists("Guten Tag"));
+			Assert::IsTrue(sbm2.SecondExists(2));
+			Assert::IsFalse(sbm2.SecondExists(7));
+		}
+
+		TEST_METHOD(SharedBidirectionalMap_ChangesMadeByOneInstanceAreVisibleInAnotherInstance)
+		{
+			SharedBidirectionalMap<std::string, std::uint64_t> sbm1(segmentName, 100, 4096);
+			SharedBidirectionalMap<std::string, std::uint64_t> sbm2(segmentName, 100, 4096);
+			sbm1.Insert("hello", 5);
+			sbm1.Insert("world", 2);
+			sbm1.Insert("Guten Tag", 7);
+
+			sbm2.ChangeFirst("Dobar dan", 5);
+			sbm2.ChangeSecond("world", 3);
+			sbm2.RemoveSecond(7);
+
+			Assert::AreEqual(size_t(2), sbm1.Size());
+			Assert::AreEqual(std::string("Dobar dan"), sbm1.AtSecond(5));
+			Assert::IsFalse(sbm1.FirstExists("hello"));
+			Assert::AreEqual(std::uint64_t(3), sbm1.AtFirst("world"));
+			Assert::IsFalse(sbm1.SecondExists(2));
+			Assert::IsFalse(sbm1.FirstExists("Guten Tag"));
+		}
+
+		TEST_METHOD(SharedBidirectionalMap_InsertMethodReturnsFalseForExistingKeyPairAndThrows_invalid_argument_ExceptionIfOneOfKeysExists)
+		{
+			SharedBidirectionalMap<std::string, std::uint64_t> sbm(segmentName, 100, 4096);
+			sbm.Insert("hello", 5);
+
+			Assert::IsFalse(sbm.Insert("hello", 5));
+
+			try
+			{
+				sbm.Insert("hello", 6);
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+
+			try
+			{
+				sbm.Insert("world", 5);
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+			Assert::AreEqual(size_t(1), sbm.Size());
+		}
+
+		TEST_METHOD(SharedBidirectionalMap_ChangeMethodsThrowExceptionsForInvalidKeys)
+		{
+			SharedBidirectionalMap<std::string, std::uint64_t> sbm(segmentName, 100, 4096);
+			sbm.Insert("hello", 5);
+			sbm.Insert("world", 2);
+
+			try
+			{
+				sbm.ChangeFirst("Guten Tag", 7);
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+
+			try
+			{
+				sbm.ChangeFirst("hello", 2);
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+
+			try
+			{
+				sbm.ChangeSecond("Guten Tag", 7);
+				Assert::Fail();
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+
+			try
+			{
+				sbm.ChangeSecond("hello", 2);
+				Assert::Fail();
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+			Assert::IsFalse(sbm.ChangeSecond("hello", 5));
+			Assert::AreEqual(std::uint64_t(5), sbm.AtFirst("hello"));
+			Assert::AreEqual(std::uint64_t(2), sbm.AtFirst("world"));
+		}
+
+		TEST_METHOD(SharedBidirectionalMap_InsertMethodThrows_length_error_ExceptionIfCapacityIsExceeded)
+		{
+			SharedBidirectionalMap<std::string, std::uint64_t> sbm(segmentName, 2, 4096);
+			sbm.Insert("hello", 5);
+			sbm.Insert("world", 2);
+
+			try
+			{
+				sbm.Insert("Guten Tag", 7);
+				Assert::Fail();
+			}
+			catch (const std::length_error&)
+			{
+			}
+			Assert::AreEqual(size_t(2), sbm.Size());
+		}
+
+		TEST_METHOD(SharedBidirectionalMap_StorageOfRemovedKeyPairsIsReused)
+		{
+			SharedBidirectionalMap<std::string, std::uint64_t> sbm(segmentName, 2, 64);
+
+			for (std::uint64_t i = 0; i < 100; ++i)
+			{
+				sbm.Insert("a key longer than sixteen characters", i);
+				sbm.RemoveSecond(i);
+			}
+
+			Assert::AreEqual(size_t(0), sbm.Size());
+		}
+
+		TEST_METHOD(SharedBidirectionalMap_AllRemainingKeyPairsAreAccessibleAfterManyRemovals)
+		{
+			SharedBidirectionalMap<std::string, std::uint64_t> sbm(segmentName, 1000, 64 * 1024);
+			for (std::uint64_t i = 0; i < 1000; ++i)
+				sbm.Insert("key" + std::to_string(i), i);
+
+			for (std::uint64_t i = 0; i < 1000; i += 3)
+				sbm.RemoveFirst("key" + std::to_string(i));
+
+			Assert::AreEqual(size_t(666), sbm.Size());
+			for (std::uint64_t i = 0; i < 1000; ++i)
+			{
+				Assert::AreEqual(i % 3 != 0, sbm.FirstExists("key" + std::to_string(i)));
+				Assert::AreEqual(i % 3 != 0, sbm.SecondExists(i));
+				if (i % 3 != 0)
+					Assert::AreEqual(std::string("key") + std::to_string(i), sbm.AtSecond(i));
+			}
+		}
+
+		TEST_METHOD(SharedBidirectionalMap_ConstructorThrows_runtime_error_ExceptionIfKeyTypesDoNotMatch)
+		{
+			SharedBidirectionalMap<std::string, std::uint64_t> sbm(segmentName, 100, 4096);
+
+			try
+			{
+				SharedBidirectionalMap<std::uint64_t, std::string> other(segmentName, 100, 4096);
+				Assert::Fail();
+			}
+			catch (const std::runtime_error&)
+			{
+			}
+		}
+
+		TEST_METHOD(SharedBidirectionalMap_ConstructorThrows_runtime_error_ExceptionIfSegmentIsNotInitializedInTime)
+		{
+			// segment left behind by a process that terminated before initializing it
+			Detail::SharedMemorySegment stale(segmentName, 4096, std::chrono::milliseconds(0));
+
+			try
+			{
+				SharedBidirectionalMap<std::string, std::uint64_t> sbm(segmentName, 100, 4096, std::chrono::milliseconds(50));
+				Assert::Fail();
+			}
+			catch (const std::runtime_error&)
+			{
+			}
+		}
+	};
+}